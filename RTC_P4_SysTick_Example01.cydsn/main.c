@@ -18,7 +18,7 @@
 *******************************************************************************/
 
 #include <project.h>
-#include <stdio.h>
+#include "fmt.h"
 
 /* Time: 02:59:50 */
 #define TIME_HOUR           (0x02u)
@@ -103,9 +103,18 @@ int main()
         time = RTC_GetTime();
         date = RTC_GetDate();
 
-        /* Print Date and Time to UART */
-        sprintf(timeBuffer, "%02lu:%02lu:%02lu", RTC_GetHours(time), RTC_GetMinutes(time), RTC_GetSecond(time));
-        sprintf(dateBuffer, "%02lu/%02lu/%02lu", RTC_GetMonth(date), RTC_GetDay(date), RTC_GetYear(date));
+        /* Print Date and Time to UART. The RTC fields are BCD. */
+        (void) Fmt_Bcd(&timeBuffer[0u], RTC_GetHours(time), 2u);
+        timeBuffer[2u] = ':';
+        (void) Fmt_Bcd(&timeBuffer[3u], RTC_GetMinutes(time), 2u);
+        timeBuffer[5u] = ':';
+        (void) Fmt_Bcd(&timeBuffer[6u], RTC_GetSecond(time), 2u);
+
+        (void) Fmt_Bcd(&dateBuffer[0u], RTC_GetMonth(date), 2u);
+        dateBuffer[2u] = '/';
+        (void) Fmt_Bcd(&dateBuffer[3u], RTC_GetDay(date), 2u);
+        dateBuffer[5u] = '/';
+        (void) Fmt_Bcd(&dateBuffer[6u], RTC_GetYear(date), 4u);
 
         UART_PutString(timeBuffer);
         UART_PutString(" | ");
@@ -0,0 +1,283 @@
+/*******************************************************************************
+* File Name: attrace.c
+*
+* Version: 1.00
+*
+* Description:
+*  Binary trace of the AT command exchange with the ESP8266. Each command,
+*  response line, wait and payload is stored as an 8-byte record with a
+*  millisecond timestamp in a RAM ring that keeps the last ATTRACE_DEPTH
+*  records. Commands and response lines are stored as small codes looked
+*  up in fixed tables, not as text.
+*
+*  AtTrace_Dump() prints the ring in hex on the debug UART between
+*  "ATTRACE <n>" and "ATTRACE END" lines. tools/attrace_decode.py turns a
+*  captured log into a timeline.
+*
+*******************************************************************************/
+
+#include <attrace.h>
+#include <systime.h>
+#include <fmt.h>
+#include <string.h>
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static ATTRACE_RECORD atTrace[ATTRACE_DEPTH];
+
+/* Total records written; the ring holds the last ATTRACE_DEPTH of them */
+static uint32 atTraceCount = 0u;
+
+
+#if (ATTRACE_ENABLED)
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static uint32 AtTrace_Lookup(const char * const table[], uint32 size, const char text[], uint32 len);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+/* Command and response tables, indexed by code. Keep in sync with
+* tools/attrace_decode.py.
+*/
+static const char * const atTraceCommands[] =
+{
+    "AT+CWJAP",
+    "AT+CIPMUX",
+    "AT+CIPSTART",
+    "AT+CIPSEND",
+    "AT+CIPCLOSE",
+    "AT+CIPRECVMODE",
+    "AT+CIPRECVDATA",
+    "AT+RST",
+};
+
+/* Response lines are matched on their start */
+static const char * const atTraceTokens[] =
+{
+    "OK",
+    "ERROR",
+    "FAIL",
+    "SEND OK",
+    "SEND FAIL",
+    ">",
+    "CLOSED",
+    "CONNECT",
+    "ALREADY CONNECTED",
+    "busy",
+    "WIFI CONNECTED",
+    "WIFI GOT IP",
+    "WIFI DISCONNECT",
+    "+IPD",
+    "+CIPRECVDATA",
+    "HTTP/",
+    "ready",
+};
+
+
+/*******************************************************************************
+* Function Name: AtTrace_Event
+********************************************************************************
+* Summary:
+*  Appends a record to the ring, overwriting the oldest one when full.
+*
+* Parameters:
+*  event - ATTRACE_EV_x.
+*  code - event specific code.
+*  count - byte count, saturated at 0xFFFF.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void AtTrace_Event(uint32 event, uint32 code, uint32 count)
+{
+    ATTRACE_RECORD *record = &atTrace[atTraceCount & (ATTRACE_DEPTH - 1u)];
+
+    record->time  = SysTime_GetMs();
+    record->event = (uint8) event;
+    record->code  = (uint8) code;
+    record->count = (uint16) ((count > 0xFFFFu) ? 0xFFFFu : count);
+
+    ++atTraceCount;
+}
+
+
+/*******************************************************************************
+* Function Name: AtTrace_Command
+********************************************************************************
+* Summary:
+*  Records a command sent to the ESP8266.
+*
+* Parameters:
+*  command - command text, at least the part up to "=".
+*  len - command length, 0 if the command is sent in parts.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void AtTrace_Command(const char command[], uint32 len)
+{
+    uint32 nameLen = 0u;
+
+    while ((0 != command[nameLen]) && ('=' != command[nameLen]))
+    {
+        ++nameLen;
+    }
+
+    AtTrace_Event(ATTRACE_EV_COMMAND,
+                  AtTrace_Lookup(atTraceCommands, sizeof(atTraceCommands) / sizeof(atTraceCommands[0u]),
+                                 command, nameLen),
+                  len);
+}
+
+
+/*******************************************************************************
+* Function Name: AtTrace_Line
+********************************************************************************
+* Summary:
+*  Records a response line received from the ESP8266.
+*
+* Parameters:
+*  line - line text, without the line end.
+*  len - line length.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void AtTrace_Line(const char line[], uint32 len)
+{
+    uint32 code = ATTRACE_CODE_OTHER;
+    uint32 matched = 0u;
+    uint32 tokenLen;
+    uint32 i;
+
+    /* Longest token the line starts with, e.g. "WIFI CONNECTED" not "CONNECT" */
+    for (i = 0u; i < (sizeof(atTraceTokens) / sizeof(atTraceTokens[0u])); ++i)
+    {
+        tokenLen = strlen(atTraceTokens[i]);
+
+        if ((tokenLen > matched) && (len >= tokenLen) && (0 == memcmp(line, atTraceTokens[i], tokenLen)))
+        {
+            code = i;
+            matched = tokenLen;
+        }
+    }
+
+    AtTrace_Event(ATTRACE_EV_LINE, code, len);
+}
+
+
+/*******************************************************************************
+* Function Name: AtTrace_Wait
+********************************************************************************
+* Summary:
+*  Records the start of a wait for a response token.
+*
+* Parameters:
+*  token - expected token.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void AtTrace_Wait(const char token[])
+{
+    AtTrace_Event(ATTRACE_EV_WAIT,
+                  AtTrace_Lookup(atTraceTokens, sizeof(atTraceTokens) / sizeof(atTraceTokens[0u]),
+                                 token, strlen(token)),
+                  0u);
+}
+
+
+/*******************************************************************************
+* Function Name: AtTrace_Lookup
+********************************************************************************
+* Summary:
+*  Finds the exact text in a table.
+*
+* Parameters:
+*  table - table of strings.
+*  size - number of entries.
+*  text - text to find, not necessarily zero-terminated.
+*  len - text length.
+*
+* Return:
+*  Table index, or ATTRACE_CODE_OTHER if not found.
+*
+*******************************************************************************/
+static uint32 AtTrace_Lookup(const char * const table[], uint32 size, const char text[], uint32 len)
+{
+    uint32 i;
+
+    for (i = 0u; i < size; ++i)
+    {
+        if ((len == strlen(table[i])) && (0 == memcmp(text, table[i], len)))
+        {
+            return (i);
+        }
+    }
+
+    return (ATTRACE_CODE_OTHER);
+}
+
+#endif /* (ATTRACE_ENABLED) */
+
+
+/*******************************************************************************
+* Function Name: AtTrace_Dump
+********************************************************************************
+* Summary:
+*  Prints the ring on the debug UART, oldest record first, one record of 16
+*  hex digits (little endian struct bytes) per line.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void AtTrace_Dump(void)
+{
+    char hex[FMT_UINT32_SIZE];
+    const uint8 *bytes;
+    uint32 count = atTraceCount;
+    uint32 first;
+    uint32 i;
+    uint32 j;
+
+    first = (count > ATTRACE_DEPTH) ? (count - ATTRACE_DEPTH) : 0u;
+
+    (void) Fmt_Hex(hex, count - first, 8u);
+    UART_UartPutString("\r\nATTRACE ");
+    UART_UartPutString(hex);
+    UART_UartPutString("\r\n");
+
+    for (i = first; i != count; ++i)
+    {
+        bytes = (const uint8 *) &atTrace[i & (ATTRACE_DEPTH - 1u)];
+
+        for (j = 0u; j < sizeof(ATTRACE_RECORD); ++j)
+        {
+            (void) Fmt_Hex(hex, bytes[j], 2u);
+            UART_UartPutString(hex);
+        }
+        UART_UartPutString("\r\n");
+    }
+
+    UART_UartPutString("ATTRACE END\r\n");
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,77 @@
+/*******************************************************************************
+* File Name: attrace.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides constants, types and function prototypes for the AT
+*  transaction trace ring.
+*
+*******************************************************************************/
+
+#if !defined(CY_ATTRACE_H)
+#define CY_ATTRACE_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Set to 0 to compile the trace out */
+#if !defined(ATTRACE_ENABLED)
+    #define ATTRACE_ENABLED     (1u)
+#endif /* !defined(ATTRACE_ENABLED) */
+
+/* Records kept in the ring, must be a power of two */
+#define ATTRACE_DEPTH           (64u)
+
+/* Events. The host decoder (tools/attrace_decode.py) mirrors these values. */
+#define ATTRACE_EV_COMMAND      (1u)    /* code: command index, count: command length */
+#define ATTRACE_EV_DATA         (2u)    /* count: payload bytes sent */
+#define ATTRACE_EV_LINE         (3u)    /* code: token index, count: line length */
+#define ATTRACE_EV_WAIT         (4u)    /* code: expected token index */
+#define ATTRACE_EV_DONE         (5u)    /* count: bytes received while waiting */
+#define ATTRACE_EV_TIMEOUT      (6u)    /* count: bytes received while waiting */
+
+/* Unknown command or response line */
+#define ATTRACE_CODE_OTHER      (0xFFu)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+typedef struct
+{
+    uint32 time;        /* SysTime_GetMs() */
+    uint8  event;       /* ATTRACE_EV_x */
+    uint8  code;
+    uint16 count;
+} ATTRACE_RECORD;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+#if (ATTRACE_ENABLED)
+    void AtTrace_Event(uint32 event, uint32 code, uint32 count);
+    void AtTrace_Command(const char command[], uint32 len);
+    void AtTrace_Line(const char line[], uint32 len);
+    void AtTrace_Wait(const char token[]);
+#else
+    #define AtTrace_Event(event, code, count)   do { } while (0)
+    #define AtTrace_Command(command, len)       do { } while (0)
+    #define AtTrace_Line(line, len)             do { } while (0)
+    #define AtTrace_Wait(token)                 do { } while (0)
+#endif /* (ATTRACE_ENABLED) */
+
+void AtTrace_Dump(void);
+
+
+#endif /* (CY_ATTRACE_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,578 @@
+/*******************************************************************************
+* File Name: bridge.c
+*
+* Version: 1.00
+*
+* Description:
+*  Transparent bridge between the UART (PC) and WIFI (ESP8266) SCBs for
+*  talking to the module directly. Both directions run at the same time,
+*  each through its own ring buffer: bytes are read from the RX FIFO of the
+*  source SCB into the ring and written from the ring to the TX FIFO of the
+*  destination SCB.
+*
+*  With the SCB interrupts enabled in both components, the moves run in the
+*  interrupt handlers (RX not empty on the source, TX not full on the
+*  destination while its ring holds data). The handlers and interrupt masks
+*  in place before the bridge are restored when it ends. The components are
+*  currently configured without interrupts; then Bridge_Run() moves the
+*  bytes in a tight loop, which keeps up with both 8-byte FIFOs at 115200
+*  baud.
+*
+*  The FIFOs are accessed through their registers so one routine serves
+*  both SCBs.
+*
+*******************************************************************************/
+
+#include <bridge.h>
+#include <systime.h>
+#include <fmt.h>
+#include <string.h>
+
+#if (BRIDGE_USE_INTERRUPT)
+    #include <UART_PVT.h>
+    #include <WIFI_PVT.h>
+#endif /* (BRIDGE_USE_INTERRUPT) */
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+/* Register layout and bit positions are the same for all SCBs */
+#define BRIDGE_FIFO_USED_MASK   (WIFI_RX_FIFO_STATUS_USED_MASK)
+#define BRIDGE_FIFO_SIZE        (WIFI_FIFO_SIZE)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+/* FIFO and interrupt registers of one SCB */
+typedef struct
+{
+    reg32 *rxFifo;
+    reg32 *rxStatus;
+    reg32 *txFifo;
+    reg32 *txStatus;
+    reg32 *intrRx;
+    reg32 *intrTx;
+    reg32 *intrTxMask;
+} BRIDGE_SCB;
+
+typedef struct
+{
+    uint8 data[BRIDGE_RING_SIZE];
+    volatile uint32 head;   /* Written by the fill side only */
+    volatile uint32 tail;   /* Written by the drain side only */
+} BRIDGE_RING;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void Bridge_Fill(uint32 direction);
+static void Bridge_Drain(uint32 direction);
+static void Bridge_Put(uint32 direction, uint8 byte);
+static void Bridge_Escape(uint8 byte);
+static void Bridge_UpdateRate(void);
+
+#if (BRIDGE_USE_INTERRUPT)
+    static void Bridge_TxNotFull(reg32 *intrTxMask, uint32 enable);
+    static void Bridge_UartInterrupt(void);
+    static void Bridge_WifiInterrupt(void);
+#endif /* (BRIDGE_USE_INTERRUPT) */
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static const BRIDGE_SCB bridgeUart =
+{
+    (reg32 *) UART_SCB__RX_FIFO_RD,
+    (reg32 *) UART_SCB__RX_FIFO_STATUS,
+    (reg32 *) UART_SCB__TX_FIFO_WR,
+    (reg32 *) UART_SCB__TX_FIFO_STATUS,
+    (reg32 *) UART_SCB__INTR_RX,
+    (reg32 *) UART_SCB__INTR_TX,
+    (reg32 *) UART_SCB__INTR_TX_MASK,
+};
+
+static const BRIDGE_SCB bridgeWifi =
+{
+    (reg32 *) WIFI_SCB__RX_FIFO_RD,
+    (reg32 *) WIFI_SCB__RX_FIFO_STATUS,
+    (reg32 *) WIFI_SCB__TX_FIFO_WR,
+    (reg32 *) WIFI_SCB__TX_FIFO_STATUS,
+    (reg32 *) WIFI_SCB__INTR_RX,
+    (reg32 *) WIFI_SCB__INTR_TX,
+    (reg32 *) WIFI_SCB__INTR_TX_MASK,
+};
+
+/* Source and destination per direction */
+static const BRIDGE_SCB * const bridgeSource[BRIDGE_DIRECTIONS] = { &bridgeUart, &bridgeWifi };
+static const BRIDGE_SCB * const bridgeDest[BRIDGE_DIRECTIONS]   = { &bridgeWifi, &bridgeUart };
+
+static BRIDGE_RING bridgeRing[BRIDGE_DIRECTIONS];
+static BRIDGE_COUNTERS bridgeCounters[BRIDGE_DIRECTIONS];
+
+/* Escape detection on the PC side; held '~' are forwarded if it breaks */
+static uint32 bridgeEscapeHeld;
+static uint32 bridgeEscapeMs;
+static uint32 bridgeLastRxMs;
+
+/* Rate measurement */
+static uint32 bridgeRateMs;
+static uint32 bridgeRateBytes[BRIDGE_DIRECTIONS];
+
+static const char * const bridgeNames[BRIDGE_DIRECTIONS] =
+{
+    "UART>WIFI",
+    "WIFI>UART",
+};
+
+
+/*******************************************************************************
+* Function Name: Bridge_Run
+********************************************************************************
+* Summary:
+*  Bridges the UART and WIFI SCBs until the escape sequence is received
+*  from the PC. Nothing else runs on the two links meanwhile. With the
+*  interrupts in use both SCB handlers are taken over, and they and the
+*  interrupt masks are restored on return.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Bridge_Run(void)
+{
+    uint32 direction;
+
+#if (BRIDGE_USE_INTERRUPT)
+    cyisraddress uartHandler = UART_customIntrHandler;
+    cyisraddress wifiHandler = WIFI_customIntrHandler;
+    uint32 uartRxMask = UART_GetRxInterruptMode();
+    uint32 wifiRxMask = WIFI_GetRxInterruptMode();
+    uint32 uartTxMask = UART_GetTxInterruptMode();
+    uint32 wifiTxMask = WIFI_GetTxInterruptMode();
+#endif /* (BRIDGE_USE_INTERRUPT) */
+
+    (void) memset(bridgeRing, 0, sizeof(bridgeRing));
+    (void) memset(bridgeCounters, 0, sizeof(bridgeCounters));
+    (void) memset(bridgeRateBytes, 0, sizeof(bridgeRateBytes));
+
+    bridgeEscapeHeld = 0u;
+    bridgeLastRxMs   = SysTime_GetMs();
+    bridgeRateMs     = bridgeLastRxMs;
+
+    /* Old overflow flags are not ours */
+    *bridgeUart.intrRx = UART_INTR_RX_OVERFLOW;
+    *bridgeWifi.intrRx = WIFI_INTR_RX_OVERFLOW;
+
+#if (BRIDGE_USE_INTERRUPT)
+    /* Only the bridge sources while its handlers are in place */
+    UART_SetTxInterruptMode(0u);
+    WIFI_SetTxInterruptMode(0u);
+    UART_SetCustomInterruptHandler(&Bridge_UartInterrupt);
+    WIFI_SetCustomInterruptHandler(&Bridge_WifiInterrupt);
+    UART_SetRxInterruptMode(UART_INTR_RX_NOT_EMPTY);
+    WIFI_SetRxInterruptMode(WIFI_INTR_RX_NOT_EMPTY);
+#endif /* (BRIDGE_USE_INTERRUPT) */
+
+    while ((BRIDGE_ESCAPE_COUNT != bridgeEscapeHeld) || (SysTime_Elapsed(bridgeEscapeMs) < BRIDGE_GUARD_MS))
+    {
+    #if (!BRIDGE_USE_INTERRUPT)
+        for (direction = 0u; direction < BRIDGE_DIRECTIONS; ++direction)
+        {
+            Bridge_Fill(direction);
+            Bridge_Drain(direction);
+        }
+    #endif /* (!BRIDGE_USE_INTERRUPT) */
+
+        Bridge_UpdateRate();
+    }
+
+#if (BRIDGE_USE_INTERRUPT)
+    UART_SetRxInterruptMode(0u);
+    WIFI_SetRxInterruptMode(0u);
+    UART_SetTxInterruptMode(0u);
+    WIFI_SetTxInterruptMode(0u);
+#endif /* (BRIDGE_USE_INTERRUPT) */
+
+    /* Deliver what is still queued towards the PC and the module */
+    for (direction = 0u; direction < BRIDGE_DIRECTIONS; ++direction)
+    {
+        while (bridgeRing[direction].tail != bridgeRing[direction].head)
+        {
+            Bridge_Drain(direction);
+        }
+    }
+
+#if (BRIDGE_USE_INTERRUPT)
+    /* Back to the handlers and sources from before the bridge */
+    UART_SetCustomInterruptHandler(uartHandler);
+    WIFI_SetCustomInterruptHandler(wifiHandler);
+    UART_SetRxInterruptMode(uartRxMask);
+    WIFI_SetRxInterruptMode(wifiRxMask);
+    UART_SetTxInterruptMode(uartTxMask);
+    WIFI_SetTxInterruptMode(wifiTxMask);
+#endif /* (BRIDGE_USE_INTERRUPT) */
+}
+
+
+/*******************************************************************************
+* Function Name: Bridge_GetCounters
+********************************************************************************
+* Summary:
+*  Returns the counters of the last or the running bridge session.
+*
+* Parameters:
+*  direction - BRIDGE_UART_TO_WIFI or BRIDGE_WIFI_TO_UART.
+*
+* Return:
+*  Pointer to the counters, or NULL for an invalid direction.
+*
+*******************************************************************************/
+const BRIDGE_COUNTERS * Bridge_GetCounters(uint32 direction)
+{
+    return ((direction < BRIDGE_DIRECTIONS) ? &bridgeCounters[direction] : NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: Bridge_Dump
+********************************************************************************
+* Summary:
+*  Prints the counters of the last bridge session on the UART.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Bridge_Dump(void)
+{
+    const BRIDGE_COUNTERS *counters;
+    uint32 i;
+
+    UART_UartPutString("\r\nbridge: bytes dropped hwm rate peak-rate\r\n");
+
+    for (i = 0u; i < BRIDGE_DIRECTIONS; ++i)
+    {
+        counters = &bridgeCounters[i];
+
+        UART_UartPutString(bridgeNames[i]);
+        UART_UartPutString(": ");
+        Fmt_PutDec(counters->bytes);
+        UART_UartPutChar(' ');
+        Fmt_PutDec(counters->dropped);
+        UART_UartPutChar(' ');
+        Fmt_PutDec(counters->highWater);
+        UART_UartPutChar(' ');
+        Fmt_PutDec(counters->rate);
+        UART_UartPutChar(' ');
+        Fmt_PutDec(counters->peakRate);
+        UART_UartPutString("\r\n");
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Bridge_Fill
+********************************************************************************
+* Summary:
+*  Moves all bytes from the RX FIFO of the source SCB into the ring and
+*  counts RX FIFO overflows.
+*
+* Parameters:
+*  direction - BRIDGE_UART_TO_WIFI or BRIDGE_WIFI_TO_UART.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Bridge_Fill(uint32 direction)
+{
+    const BRIDGE_SCB *scb = bridgeSource[direction];
+    uint32 entries = *scb->rxStatus & BRIDGE_FIFO_USED_MASK;
+    uint8 byte;
+
+    if (0u != (*scb->intrRx & WIFI_INTR_RX_OVERFLOW))
+    {
+        *scb->intrRx = WIFI_INTR_RX_OVERFLOW;
+        ++bridgeCounters[direction].dropped;
+    }
+
+    while (0u != entries)
+    {
+        byte = (uint8) *scb->rxFifo;
+        --entries;
+
+        if (BRIDGE_UART_TO_WIFI == direction)
+        {
+            Bridge_Escape(byte);
+        }
+        else
+        {
+            Bridge_Put(direction, byte);
+        }
+    }
+
+#if (BRIDGE_USE_INTERRUPT)
+    *scb->intrRx = WIFI_INTR_RX_NOT_EMPTY;
+
+    if (bridgeRing[direction].tail != bridgeRing[direction].head)
+    {
+        Bridge_TxNotFull(bridgeDest[direction]->intrTxMask, 1u);
+    }
+#endif /* (BRIDGE_USE_INTERRUPT) */
+}
+
+
+/*******************************************************************************
+* Function Name: Bridge_Drain
+********************************************************************************
+* Summary:
+*  Moves bytes from the ring into the TX FIFO of the destination SCB until
+*  either is exhausted.
+*
+* Parameters:
+*  direction - BRIDGE_UART_TO_WIFI or BRIDGE_WIFI_TO_UART.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Bridge_Drain(uint32 direction)
+{
+    const BRIDGE_SCB *scb = bridgeDest[direction];
+    BRIDGE_RING *ring = &bridgeRing[direction];
+    uint32 tail = ring->tail;
+    uint32 head = ring->head;
+    uint32 room = BRIDGE_FIFO_SIZE - (*scb->txStatus & BRIDGE_FIFO_USED_MASK);
+    uint32 count = 0u;
+
+    while ((tail != head) && (count < room))
+    {
+        *scb->txFifo = ring->data[tail];
+        tail = (tail + 1u) & (BRIDGE_RING_SIZE - 1u);
+        ++count;
+    }
+
+    ring->tail = tail;
+    bridgeCounters[direction].bytes += count;
+
+#if (BRIDGE_USE_INTERRUPT)
+    *scb->intrTx = WIFI_INTR_TX_NOT_FULL;
+
+    if (tail == head)
+    {
+        Bridge_TxNotFull(scb->intrTxMask, 0u);
+    }
+#endif /* (BRIDGE_USE_INTERRUPT) */
+}
+
+
+/*******************************************************************************
+* Function Name: Bridge_Put
+********************************************************************************
+* Summary:
+*  Appends a byte to a ring, or counts it as dropped if the ring is full.
+*
+* Parameters:
+*  direction - BRIDGE_UART_TO_WIFI or BRIDGE_WIFI_TO_UART.
+*  byte - byte to queue.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Bridge_Put(uint32 direction, uint8 byte)
+{
+    BRIDGE_RING *ring = &bridgeRing[direction];
+    uint32 head = ring->head;
+    uint32 used = (head - ring->tail) & (BRIDGE_RING_SIZE - 1u);
+
+    if (used == (BRIDGE_RING_SIZE - 1u))
+    {
+        ++bridgeCounters[direction].dropped;
+        return;
+    }
+
+    ring->data[head] = byte;
+    ring->head = (head + 1u) & (BRIDGE_RING_SIZE - 1u);
+
+    if (used >= bridgeCounters[direction].highWater)
+    {
+        bridgeCounters[direction].highWater = used + 1u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Bridge_Escape
+********************************************************************************
+* Summary:
+*  Queues a byte from the PC, holding back escape characters that follow
+*  the guard time. Once the sequence is complete Bridge_Run() ends after
+*  the trailing guard time; any other byte first releases the held ones.
+*
+* Parameters:
+*  byte - byte received from the PC.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Bridge_Escape(uint8 byte)
+{
+    uint32 now = SysTime_GetMs();
+
+    if ((BRIDGE_ESCAPE_CHAR == byte) && (bridgeEscapeHeld < BRIDGE_ESCAPE_COUNT) &&
+        ((0u != bridgeEscapeHeld) || ((now - bridgeLastRxMs) >= BRIDGE_GUARD_MS)))
+    {
+        ++bridgeEscapeHeld;
+        bridgeEscapeMs = now;
+    }
+    else
+    {
+        for (; 0u != bridgeEscapeHeld; --bridgeEscapeHeld)
+        {
+            Bridge_Put(BRIDGE_UART_TO_WIFI, (uint8) BRIDGE_ESCAPE_CHAR);
+        }
+
+        Bridge_Put(BRIDGE_UART_TO_WIFI, byte);
+    }
+
+    bridgeLastRxMs = now;
+}
+
+
+/*******************************************************************************
+* Function Name: Bridge_UpdateRate
+********************************************************************************
+* Summary:
+*  Once per second, updates the byte rate of both directions.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Bridge_UpdateRate(void)
+{
+    BRIDGE_COUNTERS *counters;
+    uint32 elapsed = SysTime_Elapsed(bridgeRateMs);
+    uint32 direction;
+    uint32 bytes;
+
+    if (elapsed < 1000u)
+    {
+        return;
+    }
+
+    bridgeRateMs += elapsed;
+
+    for (direction = 0u; direction < BRIDGE_DIRECTIONS; ++direction)
+    {
+        counters = &bridgeCounters[direction];
+        bytes = counters->bytes;
+
+        counters->rate = ((bytes - bridgeRateBytes[direction]) * 1000u) / elapsed;
+        bridgeRateBytes[direction] = bytes;
+
+        if (counters->rate > counters->peakRate)
+        {
+            counters->peakRate = counters->rate;
+        }
+    }
+}
+
+
+#if (BRIDGE_USE_INTERRUPT)
+/*******************************************************************************
+* Function Name: Bridge_TxNotFull
+********************************************************************************
+* Summary:
+*  Enables or disables the TX not full interrupt of a destination SCB and
+*  leaves the other TX sources alone. The mask of one SCB is written from
+*  both handlers, hence the critical section.
+*
+* Parameters:
+*  intrTxMask - TX interrupt mask register of the SCB.
+*  enable - non-zero to enable.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Bridge_TxNotFull(reg32 *intrTxMask, uint32 enable)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+    if (0u != enable)
+    {
+        *intrTxMask |= WIFI_INTR_TX_NOT_FULL;
+    }
+    else
+    {
+        *intrTxMask &= (uint32) ~WIFI_INTR_TX_NOT_FULL;
+    }
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: Bridge_UartInterrupt
+********************************************************************************
+* Summary:
+*  UART SCB interrupt while bridging: PC to ring, ring to PC.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Bridge_UartInterrupt(void)
+{
+    Bridge_Fill(BRIDGE_UART_TO_WIFI);
+    Bridge_Drain(BRIDGE_WIFI_TO_UART);
+}
+
+
+/*******************************************************************************
+* Function Name: Bridge_WifiInterrupt
+********************************************************************************
+* Summary:
+*  WIFI SCB interrupt while bridging: module to ring, ring to module.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Bridge_WifiInterrupt(void)
+{
+    Bridge_Fill(BRIDGE_WIFI_TO_UART);
+    Bridge_Drain(BRIDGE_UART_TO_WIFI);
+}
+#endif /* (BRIDGE_USE_INTERRUPT) */
+
+
+/* [] END OF FILE */
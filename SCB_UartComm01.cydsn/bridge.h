@@ -0,0 +1,67 @@
+/*******************************************************************************
+* File Name: bridge.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides constants, types and function prototypes for the
+*  transparent UART to WIFI bridge.
+*
+*******************************************************************************/
+
+#if !defined(CY_BRIDGE_H)
+#define CY_BRIDGE_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Move the bytes from the SCB interrupts when both components have one */
+#define BRIDGE_USE_INTERRUPT    (UART_SCB_IRQ_INTERNAL && WIFI_SCB_IRQ_INTERNAL)
+
+/* Ring buffer per direction, a power of two */
+#define BRIDGE_RING_SIZE        (256u)
+
+/* The bridge ends on BRIDGE_ESCAPE from the PC with at least BRIDGE_GUARD_MS
+*  of silence before and after it. The ESP8266 uses "+++" itself.
+*/
+#define BRIDGE_ESCAPE_CHAR      ('~')
+#define BRIDGE_ESCAPE_COUNT     (3u)
+#define BRIDGE_GUARD_MS         (1000u)
+
+/* Directions */
+#define BRIDGE_UART_TO_WIFI     (0u)
+#define BRIDGE_WIFI_TO_UART     (1u)
+#define BRIDGE_DIRECTIONS       (2u)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+typedef struct
+{
+    uint32 bytes;           /* Bytes delivered to the destination SCB */
+    uint32 dropped;         /* Ring full or RX FIFO overflow */
+    uint32 highWater;       /* Most bytes waiting in the ring at once */
+    uint32 rate;            /* Bytes per second over the last second */
+    uint32 peakRate;
+} BRIDGE_COUNTERS;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void Bridge_Run(void);
+const BRIDGE_COUNTERS * Bridge_GetCounters(uint32 direction);
+void Bridge_Dump(void);
+
+
+#endif /* (CY_BRIDGE_H) */
+
+
+/* [] END OF FILE */
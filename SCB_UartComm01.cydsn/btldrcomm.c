@@ -0,0 +1,340 @@
+/*******************************************************************************
+* File Name: btldrcomm.c
+*
+* Version: 1.00
+*
+* Description:
+*  Bootloader transport over the WIFI SCB UART that finds packet boundaries
+*  from the packet framing instead of from gaps in the byte stream.
+*
+*  WIFI_UartCyBtldrCommRead() treats a packet as complete once the RX buffer
+*  stops growing over one WIFI_UART_BYTE_TO_BYTE delay. That costs a fixed
+*  idle time per packet and merges packets that the host sends back to back.
+*  Here the SOP, length and EOP fields are parsed as the bytes arrive and
+*  BtldrComm_Read() returns as soon as the EOP of a complete packet has been
+*  read. Bytes of any following packet stay in the RX buffer for the next
+*  call. The checksum is passed through and verified by the bootloader with
+*  its configured algorithm.
+*
+*******************************************************************************/
+
+#include <btldrcomm.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+#define BTLDRCOMM_STATE_SOP     (0u)
+#define BTLDRCOMM_STATE_BODY    (1u)
+
+/* Offsets in the packet */
+#define BTLDRCOMM_LEN_LSB       (2u)
+#define BTLDRCOMM_LEN_MSB       (3u)
+
+#define BTLDRCOMM_POLLS_PER_MS  (1000u / BTLDRCOMM_POLL_US)
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+/* Packet parse state, kept across calls that time out mid-packet */
+static uint32 btldrCommState = BTLDRCOMM_STATE_SOP;
+static uint32 btldrCommCount = 0u;
+static uint32 btldrCommLength = 0u;
+
+
+/*******************************************************************************
+* Function Name: BtldrComm_Start
+********************************************************************************
+* Summary:
+*  Starts the WIFI SCB.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void BtldrComm_Start(void)
+{
+    WIFI_Start();
+    BtldrComm_Reset();
+}
+
+
+/*******************************************************************************
+* Function Name: BtldrComm_Stop
+********************************************************************************
+* Summary:
+*  Disables the WIFI SCB.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void BtldrComm_Stop(void)
+{
+    WIFI_Stop();
+}
+
+
+/*******************************************************************************
+* Function Name: BtldrComm_Reset
+********************************************************************************
+* Summary:
+*  Clears the RX and TX buffers and any partially received packet.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void BtldrComm_Reset(void)
+{
+    WIFI_SpiUartClearRxBuffer();
+    WIFI_SpiUartClearTxBuffer();
+
+    btldrCommState  = BTLDRCOMM_STATE_SOP;
+    btldrCommCount  = 0u;
+    btldrCommLength = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: BtldrComm_Read
+********************************************************************************
+* Summary:
+*  Reads one bootloader packet. Bytes before a SOP are discarded. A packet
+*  whose EOP is not where its length field says is dropped and the search
+*  for the next SOP starts again.
+*
+* Parameters:
+*  pData - buffer for the packet.
+*  size - size of the buffer.
+*  count - pointer to store the packet length.
+*  timeOut - time to wait for a packet in units of 10 ms.
+*
+* Return:
+*  CYRET_SUCCESS when a packet has been read, CYRET_TIMEOUT if no complete
+*  packet arrived in time, CYRET_BAD_PARAM for invalid arguments.
+*
+*******************************************************************************/
+cystatus BtldrComm_Read(uint8 pData[], uint16 size, uint16 *count, uint8 timeOut)
+{
+    uint32 timeoutMs = (uint32) 10u * timeOut;
+    uint32 polls = 0u;
+    uint8 byte;
+
+    if ((NULL == pData) || (size < BTLDRCOMM_OVERHEAD))
+    {
+        return (CYRET_BAD_PARAM);
+    }
+
+    for (;;)
+    {
+        if (0u == WIFI_SpiUartGetRxBufferSize())
+        {
+            if (0u == timeoutMs)
+            {
+                return (CYRET_TIMEOUT);
+            }
+
+            CyDelayUs(BTLDRCOMM_POLL_US);
+
+            if (++polls == BTLDRCOMM_POLLS_PER_MS)
+            {
+                polls = 0u;
+                --timeoutMs;
+            }
+            continue;
+        }
+
+        byte = (uint8) WIFI_SpiUartReadRxData();
+
+        if (BTLDRCOMM_STATE_SOP == btldrCommState)
+        {
+            if (BTLDRCOMM_SOP == byte)
+            {
+                pData[0u] = byte;
+                btldrCommCount = 1u;
+                btldrCommLength = BTLDRCOMM_OVERHEAD;
+                btldrCommState = BTLDRCOMM_STATE_BODY;
+            }
+            continue;
+        }
+
+        pData[btldrCommCount++] = byte;
+
+        if (btldrCommCount == (BTLDRCOMM_LEN_MSB + 1u))
+        {
+            btldrCommLength = BTLDRCOMM_OVERHEAD +
+                              ((uint32) pData[BTLDRCOMM_LEN_LSB] | ((uint32) pData[BTLDRCOMM_LEN_MSB] << 8u));
+
+            if (btldrCommLength > size)
+            {
+                /* Cannot be a valid packet: resynchronise */
+                btldrCommState = BTLDRCOMM_STATE_SOP;
+            }
+        }
+        else if (btldrCommCount == btldrCommLength)
+        {
+            btldrCommState = BTLDRCOMM_STATE_SOP;
+
+            if (BTLDRCOMM_EOP == byte)
+            {
+                *count = (uint16) btldrCommLength;
+                return (CYRET_SUCCESS);
+            }
+        }
+        else
+        {
+            /* Command, data or checksum byte */
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BtldrComm_Write
+********************************************************************************
+* Summary:
+*  Queues a response packet for transmission. Does not wait for it to be
+*  sent.
+*
+* Parameters:
+*  pData - packet to send.
+*  size - packet length.
+*  count - pointer to store the number of bytes queued.
+*  timeOut - not used.
+*
+* Return:
+*  CYRET_SUCCESS, or CYRET_BAD_PARAM for invalid arguments.
+*
+*******************************************************************************/
+cystatus BtldrComm_Write(const uint8 pData[], uint16 size, uint16 *count, uint8 timeOut)
+{
+    if ((NULL == pData) || (0u == size))
+    {
+        return (CYRET_BAD_PARAM);
+    }
+
+    WIFI_SpiUartPutArray(pData, (uint32) size);
+    *count = size;
+
+    if (0u != timeOut)
+    {
+        /* Suppress compiler warning */
+    }
+
+    return (CYRET_SUCCESS);
+}
+
+
+#if defined(CYDEV_BOOTLOADER_IO_COMP) && (CYDEV_BOOTLOADER_IO_COMP == CyBtldr_Custom_Interface)
+
+/*******************************************************************************
+* Function Name: CyBtldrCommStart
+********************************************************************************
+* Summary:
+*  Bootloader custom interface, see BtldrComm_Start().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void CyBtldrCommStart(void)
+{
+    BtldrComm_Start();
+}
+
+
+/*******************************************************************************
+* Function Name: CyBtldrCommStop
+********************************************************************************
+* Summary:
+*  Bootloader custom interface, see BtldrComm_Stop().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void CyBtldrCommStop(void)
+{
+    BtldrComm_Stop();
+}
+
+
+/*******************************************************************************
+* Function Name: CyBtldrCommReset
+********************************************************************************
+* Summary:
+*  Bootloader custom interface, see BtldrComm_Reset().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void CyBtldrCommReset(void)
+{
+    BtldrComm_Reset();
+}
+
+
+/*******************************************************************************
+* Function Name: CyBtldrCommRead
+********************************************************************************
+* Summary:
+*  Bootloader custom interface, see BtldrComm_Read().
+*
+* Parameters:
+*  See BtldrComm_Read().
+*
+* Return:
+*  See BtldrComm_Read().
+*
+*******************************************************************************/
+cystatus CyBtldrCommRead(uint8 pData[], uint16 size, uint16 *count, uint8 timeOut)
+{
+    return (BtldrComm_Read(pData, size, count, timeOut));
+}
+
+
+/*******************************************************************************
+* Function Name: CyBtldrCommWrite
+********************************************************************************
+* Summary:
+*  Bootloader custom interface, see BtldrComm_Write().
+*
+* Parameters:
+*  See BtldrComm_Write().
+*
+* Return:
+*  See BtldrComm_Write().
+*
+*******************************************************************************/
+cystatus CyBtldrCommWrite(const uint8 pData[], uint16 size, uint16 *count, uint8 timeOut)
+{
+    return (BtldrComm_Write(pData, size, count, timeOut));
+}
+
+#endif /* (CYDEV_BOOTLOADER_IO_COMP == CyBtldr_Custom_Interface) */
+
+
+/* [] END OF FILE */
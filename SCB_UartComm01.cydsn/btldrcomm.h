@@ -0,0 +1,64 @@
+/*******************************************************************************
+* File Name: btldrcomm.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the length-framed
+*  bootloader transport over the WIFI SCB.
+*
+*******************************************************************************/
+
+#if !defined(CY_BTLDRCOMM_H)
+#define CY_BTLDRCOMM_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Bootloader packet framing */
+#define BTLDRCOMM_SOP           (0x01u)
+#define BTLDRCOMM_EOP           (0x17u)
+
+/* SOP, command, 2 length bytes, 2 checksum bytes, EOP */
+#define BTLDRCOMM_OVERHEAD      (7u)
+
+/* Receive poll interval while waiting for data */
+#define BTLDRCOMM_POLL_US       (10u)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void     BtldrComm_Start(void);
+void     BtldrComm_Stop(void);
+void     BtldrComm_Reset(void);
+cystatus BtldrComm_Read(uint8 pData[], uint16 size, uint16 *count, uint8 timeOut);
+cystatus BtldrComm_Write(const uint8 pData[], uint16 size, uint16 *count, uint8 timeOut);
+
+
+/***************************************
+*    Bootloader Custom Interface
+****************************************/
+
+/* Selecting "Custom interface" as the bootloader communication component
+* makes the bootloader call these functions, which forward to this
+* transport.
+*/
+#if defined(CYDEV_BOOTLOADER_IO_COMP) && (CYDEV_BOOTLOADER_IO_COMP == CyBtldr_Custom_Interface)
+    void     CyBtldrCommStart(void);
+    void     CyBtldrCommStop(void);
+    void     CyBtldrCommReset(void);
+    cystatus CyBtldrCommRead(uint8 pData[], uint16 size, uint16 *count, uint8 timeOut);
+    cystatus CyBtldrCommWrite(const uint8 pData[], uint16 size, uint16 *count, uint8 timeOut);
+#endif /* (CYDEV_BOOTLOADER_IO_COMP == CyBtldr_Custom_Interface) */
+
+
+#endif /* (CY_BTLDRCOMM_H) */
+
+
+/* [] END OF FILE */
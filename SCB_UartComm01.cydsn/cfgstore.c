@@ -0,0 +1,334 @@
+/*******************************************************************************
+* File Name: cfgstore.c
+*
+* Version: 1.00
+*
+* Description:
+*  Log-structured key/value store in a reserved flash region. Every write
+*  appends a record to the next free row; a record carries a sequence number
+*  and a CRC so that the latest valid copy of each key wins. Rows holding a
+*  live record are skipped, so writes rotate over the remaining rows and no
+*  row is erased repeatedly. At boot the rows are scanned once to rebuild
+*  a RAM index; after that reads are O(1) pointer lookups.
+*
+*******************************************************************************/
+
+#include <cfgstore.h>
+#include <crc.h>
+#include <flashq.h>
+#include <string.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+#define CFGSTORE_NO_ROW         (0xFFu)
+
+/* Sequence number 0 marks an erased (all zero) row */
+#define CFGSTORE_SEQ_ERASED     (0u)
+
+typedef struct
+{
+    uint32 seq;
+    uint8  key;
+    uint8  len;
+    uint16 crc;
+    uint8  data[CFGSTORE_DATA_MAX];
+} CFGSTORE_RECORD;
+
+/* Address of a row in the reserved region */
+#define CFGSTORE_ROW_ADDR(row)  ((uint32) cfgStoreFlash + ((uint32) (row) * CY_FLASH_SIZEOF_ROW))
+#define CFGSTORE_RECORD_PTR(row) ((const CFGSTORE_RECORD *) CFGSTORE_ROW_ADDR(row))
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static uint16 CfgStore_RecordCrc(const CFGSTORE_RECORD *record);
+static uint32 CfgStore_IsValid(const CFGSTORE_RECORD *record);
+static uint32 CfgStore_IsLive(uint32 row);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+/* Reserved flash region, row aligned. Accessed only through its address so
+* the compiler cannot fold reads to the initial zero value.
+*/
+static const uint8 CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+    cfgStoreFlash[CFGSTORE_ROWS * CY_FLASH_SIZEOF_ROW] = {0u};
+
+/* RAM index: row of the latest record for each key */
+static uint8 cfgStoreIndex[CFGSTORE_KEY_NUM];
+
+static uint32 cfgStoreSeq = CFGSTORE_SEQ_ERASED;
+static uint32 cfgStoreHead = 0u;
+
+/* Row image for the flash write */
+static CFGSTORE_RECORD cfgStoreRow;
+
+
+/*******************************************************************************
+* Function Name: CfgStore_Init
+********************************************************************************
+* Summary:
+*  Scans the reserved rows and rebuilds the RAM index. Must be called once at
+*  start up before any other function of the store.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void CfgStore_Init(void)
+{
+    const CFGSTORE_RECORD *record;
+    uint32 row;
+    uint32 prev;
+
+    (void) memset(cfgStoreIndex, (int) CFGSTORE_NO_ROW, sizeof(cfgStoreIndex));
+    cfgStoreSeq  = CFGSTORE_SEQ_ERASED;
+    cfgStoreHead = 0u;
+
+    for (row = 0u; row < CFGSTORE_ROWS; ++row)
+    {
+        record = CFGSTORE_RECORD_PTR(row);
+
+        if (0u != CfgStore_IsValid(record))
+        {
+            prev = cfgStoreIndex[record->key];
+
+            if ((CFGSTORE_NO_ROW == prev) || (record->seq > CFGSTORE_RECORD_PTR(prev)->seq))
+            {
+                cfgStoreIndex[record->key] = (uint8) row;
+            }
+
+            /* Continue appending after the newest record */
+            if (record->seq > cfgStoreSeq)
+            {
+                cfgStoreSeq  = record->seq;
+                cfgStoreHead = (row + 1u) % CFGSTORE_ROWS;
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: CfgStore_Get
+********************************************************************************
+* Summary:
+*  Looks up the current value of a key. The value is returned in place in
+*  flash and stays valid until the next CfgStore_Write().
+*
+* Parameters:
+*  key - configuration key.
+*  value - pointer to store the address of the value.
+*
+* Return:
+*  Value length in bytes, or 0 if the key has no value.
+*
+*******************************************************************************/
+uint32 CfgStore_Get(uint32 key, const uint8 **value)
+{
+    const CFGSTORE_RECORD *record;
+    uint32 len = 0u;
+
+    if ((0u != key) && (key < CFGSTORE_KEY_NUM) && (CFGSTORE_NO_ROW != cfgStoreIndex[key]))
+    {
+        record = CFGSTORE_RECORD_PTR(cfgStoreIndex[key]);
+        *value = record->data;
+        len = record->len;
+    }
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: CfgStore_Read
+********************************************************************************
+* Summary:
+*  Copies the current value of a key into a buffer and zero-terminates it, so
+*  that string values can be used directly.
+*
+* Parameters:
+*  key - configuration key.
+*  buffer - destination buffer.
+*  size - buffer size; one byte is kept for the terminator.
+*
+* Return:
+*  Number of bytes copied, or 0 if the key has no value.
+*
+*******************************************************************************/
+uint32 CfgStore_Read(uint32 key, uint8 buffer[], uint32 size)
+{
+    const uint8 *value = NULL;
+    uint32 len;
+
+    len = CfgStore_Get(key, &value);
+
+    if (len >= size)
+    {
+        len = size - 1u;
+    }
+
+    if (0u != len)
+    {
+        (void) memcpy(buffer, value, len);
+    }
+
+    buffer[len] = 0u;
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: CfgStore_Write
+********************************************************************************
+* Summary:
+*  Appends a new value for a key. Writing the value the key already has does
+*  not touch flash.
+*
+* Parameters:
+*  key - configuration key.
+*  value - new value.
+*  len - value length, up to CFGSTORE_DATA_MAX bytes.
+*
+* Return:
+*  CY_SYS_FLASH_SUCCESS on success, CY_SYS_FLASH_INVALID_ADDR for a bad key or
+*  length, or the error returned by the flash write.
+*
+*******************************************************************************/
+uint32 CfgStore_Write(uint32 key, const uint8 value[], uint32 len)
+{
+    const uint8 *current = NULL;
+    uint32 status = CY_SYS_FLASH_SUCCESS;
+    uint32 row;
+    uint32 i;
+
+    if ((0u == key) || (key >= CFGSTORE_KEY_NUM) || (len > CFGSTORE_DATA_MAX))
+    {
+        status = CY_SYS_FLASH_INVALID_ADDR;
+    }
+    else if ((CfgStore_Get(key, &current) == len) &&
+             ((0u == len) || (0 == memcmp(current, value, len))))
+    {
+        /* Unchanged - nothing to write */
+    }
+    else
+    {
+        /* Skip rows that still hold the latest copy of a key */
+        row = cfgStoreHead;
+        for (i = 0u; (i < CFGSTORE_ROWS) && (0u != CfgStore_IsLive(row)); ++i)
+        {
+            row = (row + 1u) % CFGSTORE_ROWS;
+        }
+
+        (void) memset(&cfgStoreRow, 0, sizeof(cfgStoreRow));
+        cfgStoreRow.seq = cfgStoreSeq + 1u;
+        cfgStoreRow.key = (uint8) key;
+        cfgStoreRow.len = (uint8) len;
+        (void) memcpy(cfgStoreRow.data, value, len);
+        cfgStoreRow.crc = CfgStore_RecordCrc(&cfgStoreRow);
+
+        status = FlashQ_WriteRow(CFGSTORE_ROW_ADDR(row) / CY_FLASH_SIZEOF_ROW,
+                                 (const uint8 *) &cfgStoreRow);
+
+        if (CY_SYS_FLASH_SUCCESS == status)
+        {
+            cfgStoreSeq = cfgStoreRow.seq;
+            cfgStoreIndex[key] = (uint8) row;
+            cfgStoreHead = (row + 1u) % CFGSTORE_ROWS;
+        }
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: CfgStore_RecordCrc
+********************************************************************************
+* Summary:
+*  Computes the CRC of a record over its sequence number, key, length and
+*  value.
+*
+* Parameters:
+*  record - record to check.
+*
+* Return:
+*  CRC-16 value.
+*
+*******************************************************************************/
+static uint16 CfgStore_RecordCrc(const CFGSTORE_RECORD *record)
+{
+    uint16 crc;
+
+    crc = Crc16_Update(CRC16_INIT, (const uint8 *) record, 6u);
+    crc = Crc16_Update(crc, record->data, record->len);
+
+    return (crc);
+}
+
+
+/*******************************************************************************
+* Function Name: CfgStore_IsValid
+********************************************************************************
+* Summary:
+*  Checks if a row holds a complete record.
+*
+* Parameters:
+*  record - record to check.
+*
+* Return:
+*  Non-zero if the record is valid.
+*
+*******************************************************************************/
+static uint32 CfgStore_IsValid(const CFGSTORE_RECORD *record)
+{
+    return ((CFGSTORE_SEQ_ERASED != record->seq) &&
+            (0u != record->key) && (record->key < CFGSTORE_KEY_NUM) &&
+            (record->len <= CFGSTORE_DATA_MAX) &&
+            (record->crc == CfgStore_RecordCrc(record)));
+}
+
+
+/*******************************************************************************
+* Function Name: CfgStore_IsLive
+********************************************************************************
+* Summary:
+*  Checks if a row holds the latest record of any key.
+*
+* Parameters:
+*  row - row within the reserved region.
+*
+* Return:
+*  Non-zero if the row must not be overwritten.
+*
+*******************************************************************************/
+static uint32 CfgStore_IsLive(uint32 row)
+{
+    uint32 key;
+    uint32 live = 0u;
+
+    for (key = 1u; key < CFGSTORE_KEY_NUM; ++key)
+    {
+        if (cfgStoreIndex[key] == row)
+        {
+            live = 1u;
+            break;
+        }
+    }
+
+    return (live);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,60 @@
+/*******************************************************************************
+* File Name: cfgstore.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the
+*  log-structured configuration store kept in flash.
+*
+*******************************************************************************/
+
+#if !defined(CY_CFGSTORE_H)
+#define CY_CFGSTORE_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Number of flash rows reserved for the store. Must be at least
+* CFGSTORE_KEY_NUM + 1 so a free row always exists.
+*/
+#define CFGSTORE_ROWS           (16u)
+
+/* Record header: sequence number, key, length and CRC */
+#define CFGSTORE_HEADER_SIZE    (8u)
+
+/* Maximum value length: one record per flash row */
+#define CFGSTORE_DATA_MAX       (CY_FLASH_SIZEOF_ROW - CFGSTORE_HEADER_SIZE)
+
+/* Keys are 1 .. CFGSTORE_KEY_NUM - 1; key 0 is reserved */
+#define CFGSTORE_KEY_NUM        (9u)
+
+/* Configuration keys */
+#define CFG_KEY_WIFI_SSID       (1u)
+#define CFG_KEY_WIFI_PASS       (2u)
+#define CFG_KEY_HOST            (3u)
+#define CFG_KEY_CHANNELS        (4u)
+#define CFG_KEY_OTA_URL         (5u)
+#define CFG_KEY_OTA_IMAGE       (6u)
+#define CFG_KEY_UPLOAD          (7u)
+#define CFG_KEY_MQTT_BROKER     (8u)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void   CfgStore_Init(void);
+uint32 CfgStore_Get(uint32 key, const uint8 **value);
+uint32 CfgStore_Read(uint32 key, uint8 buffer[], uint32 size);
+uint32 CfgStore_Write(uint32 key, const uint8 value[], uint32 len);
+
+
+#endif /* (CY_CFGSTORE_H) */
+
+
+/* [] END OF FILE */
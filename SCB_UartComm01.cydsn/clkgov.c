@@ -0,0 +1,315 @@
+/*******************************************************************************
+* File Name: clkgov.c
+*
+* Version: 1.00
+*
+* Description:
+*  Run-time clock governor. CPU bound phases (parsing, flash writes) request
+*  the BURST level, UART bound waits request the LOW level.
+*
+*  LOW only divides SYSCLK, so HFCLK and the SCB clocks are unchanged.
+*  BURST doubles the IMO (and HFCLK) to 48 MHz, so the SCB clock dividers are
+*  doubled to keep the baud rates. On every change the flash wait states,
+*  the CyDelay frequency, the SysTick reload and the ILO calibration are
+*  updated in the required order.
+*
+*  A character on the line while HFCLK changes is sampled at the wrong rate,
+*  so an IMO change waits until both UARTs have finished transmitting and
+*  both RX lines have been idle for a character time. There is no flow
+*  control to hold the ESP8266, so a level change that finds RX busy for
+*  CLKGOV_RX_TIMEOUT_US is not made.
+*
+*******************************************************************************/
+
+#include <clkgov.h>
+#include <systime.h>
+#include <ilotrim.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+/* Divider register is in 1/32 units: 5 fractional bits */
+#define CLKGOV_FRAC_UNITS       (32u)
+
+typedef struct
+{
+    uint8  imoMhz;          /* IMO and HFCLK frequency */
+    uint8  sysclkDiv;       /* CY_SYS_CLK_SYSCLK_DIVx */
+    uint8  sysclkMhz;       /* Resulting SYSCLK frequency */
+    uint8  scbScale;        /* SCB divider multiplier relative to 24 MHz */
+} CLKGOV_LEVEL_STRUCT;
+
+static const CLKGOV_LEVEL_STRUCT clkGovLevels[CLKGOV_LEVEL_NUM] =
+{
+    {24u, CY_SYS_CLK_SYSCLK_DIV4,  6u, 1u},    /* LOW     */
+    {24u, CY_SYS_CLK_SYSCLK_DIV1, 24u, 1u},    /* NOMINAL */
+    {48u, CY_SYS_CLK_SYSCLK_DIV1, 48u, 2u},    /* BURST   */
+};
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void ClkGov_DrainTx(void);
+static cystatus ClkGov_WaitRxIdle(void);
+static void ClkGov_SetScbDividers(uint32 scale);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static uint32 clkGovLevel = CLKGOV_LEVEL_NOMINAL;
+
+/* SCB clock dividers at nominal HFCLK, in 1/32 units */
+static uint32 clkGovUartDiv;
+static uint32 clkGovWifiDiv;
+
+
+/*******************************************************************************
+* Function Name: ClkGov_Start
+********************************************************************************
+* Summary:
+*  Captures the SCB clock dividers configured at build time. Must be called
+*  after UART_Start() and WIFI_Start() while running at the nominal level.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ClkGov_Start(void)
+{
+    clkGovUartDiv = (((uint32) UART_SCBCLK_GetDividerRegister() + 1u) * CLKGOV_FRAC_UNITS) +
+                     (uint32) UART_SCBCLK_GetFractionalDividerRegister();
+    clkGovWifiDiv = (((uint32) WIFI_SCBCLK_GetDividerRegister() + 1u) * CLKGOV_FRAC_UNITS) +
+                     (uint32) WIFI_SCBCLK_GetFractionalDividerRegister();
+
+    clkGovLevel = CLKGOV_LEVEL_NOMINAL;
+}
+
+
+/*******************************************************************************
+* Function Name: ClkGov_SetLevel
+********************************************************************************
+* Summary:
+*  Switches the system to the requested clock level. Pending UART
+*  transmissions are drained and the RX lines must be idle first because
+*  the baud rate glitches while HFCLK changes. If RX stays busy, the level
+*  is left unchanged.
+*
+* Parameters:
+*  level - CLKGOV_LEVEL_LOW, CLKGOV_LEVEL_NOMINAL or CLKGOV_LEVEL_BURST.
+*
+* Return:
+*  The previous level, to be passed back to ClkGov_SetLevel() when the phase
+*  that requested the change is over. Equal to the current level if no
+*  change was made.
+*
+*******************************************************************************/
+uint32 ClkGov_SetLevel(uint32 level)
+{
+    const CLKGOV_LEVEL_STRUCT *from;
+    const CLKGOV_LEVEL_STRUCT *to;
+    uint32 prevLevel = clkGovLevel;
+    uint8 interruptState;
+
+    if ((level < CLKGOV_LEVEL_NUM) && (level != clkGovLevel))
+    {
+        from = &clkGovLevels[clkGovLevel];
+        to   = &clkGovLevels[level];
+
+        if (from->imoMhz != to->imoMhz)
+        {
+            ClkGov_DrainTx();
+
+            if (CYRET_SUCCESS != ClkGov_WaitRxIdle())
+            {
+                return (prevLevel);
+            }
+        }
+
+        interruptState = CyEnterCriticalSection();
+
+        /* A start bit may have come in since the idle check */
+        if ((from->imoMhz != to->imoMhz) &&
+            ((0u == UART_rx_Read()) || (0u == WIFI_rx_Read())))
+        {
+            CyExitCriticalSection(interruptState);
+            return (prevLevel);
+        }
+
+        /* Flash needs more wait states before the clock goes up */
+        if (to->sysclkMhz > from->sysclkMhz)
+        {
+            CySysFlashSetWaitCycles((uint32) to->sysclkMhz);
+        }
+
+        if (from->imoMhz != to->imoMhz)
+        {
+            /* Keep SYSCLK within limits while HFCLK changes */
+            CySysClkWriteSysclkDiv(CY_SYS_CLK_SYSCLK_DIV2);
+            CySysClkWriteImoFreq((uint32) to->imoMhz);
+            ClkGov_SetScbDividers((uint32) to->scbScale);
+        }
+
+        CySysClkWriteSysclkDiv((uint32) to->sysclkDiv);
+
+        if (to->sysclkMhz < from->sysclkMhz)
+        {
+            CySysFlashSetWaitCycles((uint32) to->sysclkMhz);
+        }
+
+        CyDelayFreq((uint32) to->sysclkMhz * 1000000u);
+        SysTime_UpdateClock(cydelayFreqHz);
+        clkGovLevel = level;
+
+        CyExitCriticalSection(interruptState);
+
+        /* The ILO measurement counters run from SYSCLK */
+        IloTrim_Trigger(ILOTRIM_TRIG_CLOCK);
+    }
+
+    return (prevLevel);
+}
+
+
+/*******************************************************************************
+* Function Name: ClkGov_GetLevel
+********************************************************************************
+* Summary:
+*  Returns the current clock level.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Current CLKGOV_LEVEL_x value.
+*
+*******************************************************************************/
+uint32 ClkGov_GetLevel(void)
+{
+    return (clkGovLevel);
+}
+
+
+/*******************************************************************************
+* Function Name: ClkGov_GetSysclkHz
+********************************************************************************
+* Summary:
+*  Returns the current SYSCLK frequency.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  SYSCLK frequency in Hz.
+*
+*******************************************************************************/
+uint32 ClkGov_GetSysclkHz(void)
+{
+    return (cydelayFreqHz);
+}
+
+
+/*******************************************************************************
+* Function Name: ClkGov_DrainTx
+********************************************************************************
+* Summary:
+*  Waits until both UARTs have shifted out all pending data.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void ClkGov_DrainTx(void)
+{
+    while ((0u != UART_SpiUartGetTxBufferSize()) || (0u != WIFI_SpiUartGetTxBufferSize()))
+    {
+    }
+
+    CyDelayUs(CLKGOV_TX_DRAIN_US);
+}
+
+
+/*******************************************************************************
+* Function Name: ClkGov_WaitRxIdle
+********************************************************************************
+* Summary:
+*  Waits until the RX lines of both UARTs have stayed high for
+*  CLKGOV_RX_IDLE_US, so that no character is being received.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  CYRET_SUCCESS when idle, CYRET_TIMEOUT if a line was busy for
+*  CLKGOV_RX_TIMEOUT_US.
+*
+*******************************************************************************/
+static cystatus ClkGov_WaitRxIdle(void)
+{
+    uint32 quietUs = 0u;
+    uint32 waitedUs = 0u;
+
+    while (quietUs < CLKGOV_RX_IDLE_US)
+    {
+        if (waitedUs >= CLKGOV_RX_TIMEOUT_US)
+        {
+            return (CYRET_TIMEOUT);
+        }
+
+        /* The lines idle high; a low level is a start or data bit */
+        if ((0u != UART_rx_Read()) && (0u != WIFI_rx_Read()))
+        {
+            quietUs += CLKGOV_RX_POLL_US;
+        }
+        else
+        {
+            quietUs = 0u;
+        }
+
+        CyDelayUs(CLKGOV_RX_POLL_US);
+        waitedUs += CLKGOV_RX_POLL_US;
+    }
+
+    return (CYRET_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: ClkGov_SetScbDividers
+********************************************************************************
+* Summary:
+*  Scales the SCB clock dividers captured at start up.
+*
+* Parameters:
+*  scale - HFCLK multiplier relative to the nominal frequency.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void ClkGov_SetScbDividers(uint32 scale)
+{
+    uint32 div;
+
+    div = clkGovUartDiv * scale;
+    UART_SCBCLK_SetFractionalDividerRegister((uint16) ((div / CLKGOV_FRAC_UNITS) - 1u),
+                                             (uint8) (div % CLKGOV_FRAC_UNITS));
+
+    div = clkGovWifiDiv * scale;
+    WIFI_SCBCLK_SetFractionalDividerRegister((uint16) ((div / CLKGOV_FRAC_UNITS) - 1u),
+                                             (uint8) (div % CLKGOV_FRAC_UNITS));
+}
+
+
+/* [] END OF FILE */
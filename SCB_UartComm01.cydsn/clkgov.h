@@ -0,0 +1,56 @@
+/*******************************************************************************
+* File Name: clkgov.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the run-time
+*  clock governor.
+*
+*******************************************************************************/
+
+#if !defined(CY_CLKGOV_H)
+#define CY_CLKGOV_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Clock levels: SYSCLK = 6 MHz, 24 MHz and 48 MHz */
+#define CLKGOV_LEVEL_LOW        (0u)
+#define CLKGOV_LEVEL_NOMINAL    (1u)
+#define CLKGOV_LEVEL_BURST      (2u)
+#define CLKGOV_LEVEL_NUM        (3u)
+
+/* Time to shift out the last character at the slowest supported baud rate */
+#define CLKGOV_TX_DRAIN_US      (100u)
+
+/* An RX line high this long has no character in progress (10 bits at the
+* slowest supported baud rate)
+*/
+#define CLKGOV_RX_IDLE_US       (100u)
+
+/* RX line sampling interval while waiting for idle */
+#define CLKGOV_RX_POLL_US       (5u)
+
+/* Longest wait for idle RX lines before a level change is given up */
+#define CLKGOV_RX_TIMEOUT_US    (20000u)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void   ClkGov_Start(void);
+uint32 ClkGov_SetLevel(uint32 level);
+uint32 ClkGov_GetLevel(void);
+uint32 ClkGov_GetSysclkHz(void);
+
+
+#endif /* (CY_CLKGOV_H) */
+
+
+/* [] END OF FILE */
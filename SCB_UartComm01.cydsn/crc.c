@@ -0,0 +1,58 @@
+/*******************************************************************************
+* File Name: crc.c
+*
+* Version: 1.00
+*
+* Description:
+*  CRC-16/CCITT computed a nibble at a time. The 16 entry table costs 32 bytes
+*  of flash instead of 512 bytes for a byte-wide table.
+*
+*******************************************************************************/
+
+#include <crc.h>
+
+
+/***************************************
+*          Internal Constants
+****************************************/
+
+static const uint16 crc16Nibble[16u] =
+{
+    0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+    0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu,
+};
+
+
+/*******************************************************************************
+* Function Name: Crc16_Update
+********************************************************************************
+* Summary:
+*  Updates a running CRC-16/CCITT value with a block of data. Start with
+*  CRC16_INIT; blocks can be chained by passing the previous result.
+*
+* Parameters:
+*  crc  - running CRC value.
+*  data - data to process.
+*  len  - number of bytes in data.
+*
+* Return:
+*  Updated CRC value.
+*
+*******************************************************************************/
+uint16 Crc16_Update(uint16 crc, const uint8 data[], uint32 len)
+{
+    uint32 i;
+    uint32 value = crc;
+
+    for (i = 0u; i < len; ++i)
+    {
+        value ^= ((uint32) data[i] << 8u);
+        value = (value << 4u) ^ crc16Nibble[(value >> 12u) & 0x0Fu];
+        value = (value << 4u) ^ crc16Nibble[(value >> 12u) & 0x0Fu];
+    }
+
+    return ((uint16) value);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,36 @@
+/*******************************************************************************
+* File Name: crc.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the CRC routines
+*  used to validate data stored in flash and received over the network.
+*
+*******************************************************************************/
+
+#if !defined(CY_CRC_H)
+#define CY_CRC_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF */
+#define CRC16_INIT      (0xFFFFu)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+uint16 Crc16_Update(uint16 crc, const uint8 data[], uint32 len);
+
+
+#endif /* (CY_CRC_H) */
+
+
+/* [] END OF FILE */
@@ -15,5 +15,22 @@
     /*Define your macro callbacks here */
     /*For more information, refer to the Macro Callbacks topic in the PSoC Creator Help.*/
     
+    /* SCB interrupt time accounting, see linkstat.c */
+    #define WIFI_SPI_UART_ISR_ENTRY_CALLBACK
+    void WIFI_SPI_UART_ISR_EntryCallback(void);
+    #define WIFI_SPI_UART_ISR_EXIT_CALLBACK
+    void WIFI_SPI_UART_ISR_ExitCallback(void);
+    
+    #define UART_SPI_UART_ISR_ENTRY_CALLBACK
+    void UART_SPI_UART_ISR_EntryCallback(void);
+    #define UART_SPI_UART_ISR_EXIT_CALLBACK
+    void UART_SPI_UART_ISR_ExitCallback(void);
+    
+    /* Stack and heap painting before main(), see stackmon.c */
+    #if (defined(__GNUC__) && !defined(__ARMCC_VERSION))
+        #define CY_BOOT_START_C_CALLBACK
+        void CyBoot_Start_c_Callback(void) __attribute__ ((noreturn));
+    #endif /* (defined(__GNUC__) && !defined(__ARMCC_VERSION)) */
+    
 #endif /* CYAPICALLBACKS_H */   
 /* [] */
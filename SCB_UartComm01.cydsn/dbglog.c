@@ -0,0 +1,249 @@
+/*******************************************************************************
+* File Name: dbglog.c
+*
+* Version: 1.00
+*
+* Description:
+*  Deferred debug log on the UART SCB. Messages are copied into a RAM ring
+*  and sent to the TX FIFO only while it has room, so logging never waits
+*  for the 115200 baud line. A message that does not fit in the ring is
+*  dropped as a whole and counted.
+*
+*  With the UART component interrupt enabled the ring is drained from the
+*  TX not full interrupt (through UART_SetCustomInterruptHandler()). The
+*  component is currently configured without an interrupt; then
+*  DbgLog_Process() fills the FIFO from the idle loops.
+*
+*******************************************************************************/
+
+#include <dbglog.h>
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void DbgLog_Drain(void);
+
+#if (DBGLOG_USE_INTERRUPT)
+    static void DbgLog_Interrupt(void);
+#endif /* (DBGLOG_USE_INTERRUPT) */
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static uint8 dbgLogRing[DBGLOG_RING_SIZE];
+
+/* Head is only written by the producer, tail only by the drain */
+static volatile uint32 dbgLogHead = 0u;
+static volatile uint32 dbgLogTail = 0u;
+
+static volatile uint32 dbgLogDropped = 0u;
+
+
+/*******************************************************************************
+* Function Name: DbgLog_Start
+********************************************************************************
+* Summary:
+*  Registers the drain interrupt handler. Call after UART_Start().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void DbgLog_Start(void)
+{
+#if (DBGLOG_USE_INTERRUPT)
+    UART_SetCustomInterruptHandler(&DbgLog_Interrupt);
+#endif /* (DBGLOG_USE_INTERRUPT) */
+}
+
+
+/*******************************************************************************
+* Function Name: DbgLog_Write
+********************************************************************************
+* Summary:
+*  Queues bytes for output. Never waits. Must not be called from interrupts.
+*
+* Parameters:
+*  data - bytes to log.
+*  len - number of bytes.
+*
+* Return:
+*  CYRET_SUCCESS, or CYRET_MEMORY if the message was dropped.
+*
+*******************************************************************************/
+cystatus DbgLog_Write(const uint8 data[], uint32 len)
+{
+    uint32 head = dbgLogHead;
+    uint32 i;
+
+    if (len > ((DBGLOG_RING_SIZE - 1u) - ((head - dbgLogTail) & (DBGLOG_RING_SIZE - 1u))))
+    {
+        ++dbgLogDropped;
+        return (CYRET_MEMORY);
+    }
+
+    for (i = 0u; i < len; ++i)
+    {
+        dbgLogRing[head] = data[i];
+        head = (head + 1u) & (DBGLOG_RING_SIZE - 1u);
+    }
+    dbgLogHead = head;
+
+#if (DBGLOG_USE_INTERRUPT)
+    UART_SetTxInterruptMode(UART_INTR_TX_NOT_FULL);
+#else
+    DbgLog_Drain();
+#endif /* (DBGLOG_USE_INTERRUPT) */
+
+    return (CYRET_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: DbgLog_PutString
+********************************************************************************
+* Summary:
+*  Queues a zero-terminated string, see DbgLog_Write().
+*
+* Parameters:
+*  string - string to log.
+*
+* Return:
+*  CYRET_SUCCESS, or CYRET_MEMORY if the message was dropped.
+*
+*******************************************************************************/
+cystatus DbgLog_PutString(const char string[])
+{
+    return (DbgLog_Write((const uint8 *) string, strlen(string)));
+}
+
+
+/*******************************************************************************
+* Function Name: DbgLog_Process
+********************************************************************************
+* Summary:
+*  Moves queued bytes into the TX FIFO while it has room. Only needed
+*  without the drain interrupt; call from idle loops.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void DbgLog_Process(void)
+{
+#if (!DBGLOG_USE_INTERRUPT)
+    DbgLog_Drain();
+#endif /* (!DBGLOG_USE_INTERRUPT) */
+}
+
+
+/*******************************************************************************
+* Function Name: DbgLog_Flush
+********************************************************************************
+* Summary:
+*  Waits until all queued bytes have been moved to the TX FIFO. Use before
+*  writing to the UART directly.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void DbgLog_Flush(void)
+{
+    while (dbgLogTail != dbgLogHead)
+    {
+        DbgLog_Process();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: DbgLog_GetDropped
+********************************************************************************
+* Summary:
+*  Returns the number of messages dropped because the ring was full.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Dropped message count.
+*
+*******************************************************************************/
+uint32 DbgLog_GetDropped(void)
+{
+    return (dbgLogDropped);
+}
+
+
+/*******************************************************************************
+* Function Name: DbgLog_Drain
+********************************************************************************
+* Summary:
+*  Moves bytes from the ring to the TX FIFO until either is exhausted.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void DbgLog_Drain(void)
+{
+    uint32 tail = dbgLogTail;
+
+    while ((tail != dbgLogHead) && (UART_SPI_UART_FIFO_SIZE != UART_GET_TX_FIFO_ENTRIES))
+    {
+        UART_TX_FIFO_WR_REG = dbgLogRing[tail];
+        tail = (tail + 1u) & (DBGLOG_RING_SIZE - 1u);
+    }
+    dbgLogTail = tail;
+}
+
+
+#if (DBGLOG_USE_INTERRUPT)
+/*******************************************************************************
+* Function Name: DbgLog_Interrupt
+********************************************************************************
+* Summary:
+*  UART custom interrupt handler: refills the TX FIFO and disables the TX not
+*  full interrupt once the ring is empty.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void DbgLog_Interrupt(void)
+{
+    if (0u != (UART_GetTxInterruptSourceMasked() & UART_INTR_TX_NOT_FULL))
+    {
+        DbgLog_Drain();
+
+        if (dbgLogTail == dbgLogHead)
+        {
+            UART_SetTxInterruptMode(0u);
+        }
+        UART_ClearTxInterruptSource(UART_INTR_TX_NOT_FULL);
+    }
+}
+#endif /* (DBGLOG_USE_INTERRUPT) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,96 @@
+/*******************************************************************************
+* File Name: dbglog.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides the severity macros, constants and function prototypes
+*  for the deferred debug log on the UART SCB.
+*
+*******************************************************************************/
+
+#if !defined(CY_DBGLOG_H)
+#define CY_DBGLOG_H
+
+#include <project.h>
+#include <string.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+#define DBGLOG_LEVEL_NONE       (0u)
+#define DBGLOG_LEVEL_ERROR      (1u)
+#define DBGLOG_LEVEL_WARN       (2u)
+#define DBGLOG_LEVEL_INFO       (3u)
+#define DBGLOG_LEVEL_DEBUG      (4u)
+
+/* Messages above this level are compiled out */
+#if !defined(DBGLOG_LEVEL)
+    #define DBGLOG_LEVEL        (DBGLOG_LEVEL_DEBUG)
+#endif /* !defined(DBGLOG_LEVEL) */
+
+/* Log ring size in bytes, must be a power of two */
+#define DBGLOG_RING_SIZE        (512u)
+
+/* Set when the UART component has its internal interrupt enabled; the ring
+* is then drained from the TX not full interrupt. Otherwise DbgLog_Process()
+* has to be called from idle loops.
+*/
+#define DBGLOG_USE_INTERRUPT    (UART_SCB_IRQ_INTERNAL)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void     DbgLog_Start(void);
+cystatus DbgLog_Write(const uint8 data[], uint32 len);
+cystatus DbgLog_PutString(const char string[]);
+void     DbgLog_Process(void);
+void     DbgLog_Flush(void);
+uint32   DbgLog_GetDropped(void);
+
+
+/***************************************
+*          Severity Macros
+****************************************/
+
+#if (DBGLOG_LEVEL >= DBGLOG_LEVEL_ERROR)
+    #define DBGLOG_ERROR(string)            (void) DbgLog_PutString(string)
+    #define DBGLOG_ERROR_DATA(data, len)    (void) DbgLog_Write((const uint8 *) (data), (len))
+#else
+    #define DBGLOG_ERROR(string)            do { } while (0)
+    #define DBGLOG_ERROR_DATA(data, len)    do { } while (0)
+#endif /* (DBGLOG_LEVEL >= DBGLOG_LEVEL_ERROR) */
+
+#if (DBGLOG_LEVEL >= DBGLOG_LEVEL_WARN)
+    #define DBGLOG_WARN(string)             (void) DbgLog_PutString(string)
+    #define DBGLOG_WARN_DATA(data, len)     (void) DbgLog_Write((const uint8 *) (data), (len))
+#else
+    #define DBGLOG_WARN(string)             do { } while (0)
+    #define DBGLOG_WARN_DATA(data, len)     do { } while (0)
+#endif /* (DBGLOG_LEVEL >= DBGLOG_LEVEL_WARN) */
+
+#if (DBGLOG_LEVEL >= DBGLOG_LEVEL_INFO)
+    #define DBGLOG_INFO(string)             (void) DbgLog_PutString(string)
+    #define DBGLOG_INFO_DATA(data, len)     (void) DbgLog_Write((const uint8 *) (data), (len))
+#else
+    #define DBGLOG_INFO(string)             do { } while (0)
+    #define DBGLOG_INFO_DATA(data, len)     do { } while (0)
+#endif /* (DBGLOG_LEVEL >= DBGLOG_LEVEL_INFO) */
+
+#if (DBGLOG_LEVEL >= DBGLOG_LEVEL_DEBUG)
+    #define DBGLOG_DEBUG(string)            (void) DbgLog_PutString(string)
+    #define DBGLOG_DEBUG_DATA(data, len)    (void) DbgLog_Write((const uint8 *) (data), (len))
+#else
+    #define DBGLOG_DEBUG(string)            do { } while (0)
+    #define DBGLOG_DEBUG_DATA(data, len)    do { } while (0)
+#endif /* (DBGLOG_LEVEL >= DBGLOG_LEVEL_DEBUG) */
+
+
+#endif /* (CY_DBGLOG_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,228 @@
+/*******************************************************************************
+* File Name: dispense.c
+*
+* Version: 1.00
+*
+* Description:
+*  Schedule runner. Once a minute the time of day is compared with the
+*  "HH:MM" time of every schedule entry; an entry that is due and has a
+*  dosage is dispensed through DISPENSE_DRIVE() and recorded with
+*  DoseLog_Add(), which queues it for the bulk upload.
+*
+*  Nothing is dispensed until the clock has been set from a server
+*  response. A minute that is skipped, for example while a blocking
+*  transfer runs, is caught up on the next call, so a dose is not lost to
+*  a late call. A step of the clock resynchronises without running the
+*  skipped minutes, so a dose is never given twice.
+*
+*******************************************************************************/
+
+#include <dispense.h>
+#include <doselog.h>
+#include <schedule.h>
+#include <dbglog.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+#define DISPENSE_NO_TIME        (0xFFFFFFFFu)
+
+/* Minutes caught up at most; a longer gap is a clock step, not a delay */
+#define DISPENSE_CATCHUP_MIN    (10u)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void Dispense_Minute(uint32 minute);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+/* Last minute of the day that was run, DISPENSE_NO_TIME before the first */
+static uint32 dispenseLastMinute = DISPENSE_NO_TIME;
+
+
+/*******************************************************************************
+* Function Name: Dispense_Process
+********************************************************************************
+* Summary:
+*  Runs the schedule for every minute since the previous call. Call it from
+*  the main loop.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Dispense_Process(void)
+{
+    uint32 now = DoseLog_GetTime();
+    uint32 minute;
+    uint32 gap;
+
+    if (now < DOSELOG_TIME_VALID)
+    {
+        return;
+    }
+
+    minute = (uint32) ((int32) ((now / 60u) % DISPENSE_MIN_PER_DAY) + DISPENSE_UTC_OFFSET_MIN +
+                       (int32) DISPENSE_MIN_PER_DAY) % DISPENSE_MIN_PER_DAY;
+
+    if (DISPENSE_NO_TIME == dispenseLastMinute)
+    {
+        /* Start with the current minute, not with the day so far */
+        dispenseLastMinute = (minute + (DISPENSE_MIN_PER_DAY - 1u)) % DISPENSE_MIN_PER_DAY;
+    }
+
+    gap = (minute + DISPENSE_MIN_PER_DAY - dispenseLastMinute) % DISPENSE_MIN_PER_DAY;
+
+    if (gap > DISPENSE_CATCHUP_MIN)
+    {
+        /* Clock was stepped: a step back would repeat doses already given */
+        dispenseLastMinute = minute;
+    }
+
+    while (dispenseLastMinute != minute)
+    {
+        dispenseLastMinute = (dispenseLastMinute + 1u) % DISPENSE_MIN_PER_DAY;
+        Dispense_Minute(dispenseLastMinute);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Dispense_ParseTime
+********************************************************************************
+* Summary:
+*  Converts a schedule time "H:MM" or "HH:MM" to the minute of the day.
+*
+* Parameters:
+*  text - zero-terminated schedule time.
+*
+* Return:
+*  Minute of the day, or DISPENSE_MIN_PER_DAY if the text is not a time.
+*
+*******************************************************************************/
+uint32 Dispense_ParseTime(const char text[])
+{
+    uint32 hours = 0u;
+    uint32 minutes = 0u;
+    uint32 i = 0u;
+    uint32 j;
+
+    while ((i < 2u) && (text[i] >= '0') && (text[i] <= '9'))
+    {
+        hours = (hours * 10u) + (uint32) (text[i] - '0');
+        ++i;
+    }
+
+    if ((0u == i) || (':' != text[i]))
+    {
+        return (DISPENSE_MIN_PER_DAY);
+    }
+
+    for (j = i + 1u; j < (i + 3u); ++j)
+    {
+        if ((text[j] < '0') || (text[j] > '9'))
+        {
+            return (DISPENSE_MIN_PER_DAY);
+        }
+        minutes = (minutes * 10u) + (uint32) (text[j] - '0');
+    }
+
+    if ((0 != text[j]) || (hours > 23u) || (minutes > 59u))
+    {
+        return (DISPENSE_MIN_PER_DAY);
+    }
+
+    return ((hours * 60u) + minutes);
+}
+
+
+/*******************************************************************************
+* Function Name: Dispense_ParseAmount
+********************************************************************************
+* Summary:
+*  Converts a schedule dosage such as "2" or "1.25" to hundredths. Digits
+*  beyond the second decimal are ignored.
+*
+* Parameters:
+*  text - zero-terminated schedule dosage.
+*
+* Return:
+*  Dose in hundredths, 0 if the text is empty or not a number.
+*
+*******************************************************************************/
+uint32 Dispense_ParseAmount(const char text[])
+{
+    uint32 amount = 0u;
+    uint32 scale = 100u;
+    uint32 i;
+
+    for (i = 0u; (text[i] >= '0') && (text[i] <= '9'); ++i)
+    {
+        amount = (amount * 10u) + (uint32) (text[i] - '0');
+    }
+
+    amount *= 100u;
+
+    if ('.' == text[i])
+    {
+        for (++i; (text[i] >= '0') && (text[i] <= '9'); ++i)
+        {
+            scale /= 10u;
+            amount += scale * (uint32) (text[i] - '0');
+        }
+    }
+
+    return ((0 == text[i]) ? amount : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Dispense_Minute
+********************************************************************************
+* Summary:
+*  Dispenses and logs every schedule entry due at the given minute.
+*
+* Parameters:
+*  minute - minute of the day.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Dispense_Minute(uint32 minute)
+{
+    uint32 amount;
+    uint32 slot;
+
+    for (slot = 0u; slot < SCHED_ENTRIES; ++slot)
+    {
+        if (Dispense_ParseTime(schedule.entry[slot].time) == minute)
+        {
+            amount = Dispense_ParseAmount(schedule.entry[slot].dosage);
+
+            if (0u != amount)
+            {
+                DISPENSE_DRIVE(slot, amount);
+
+                if (CYRET_SUCCESS != DoseLog_Add(slot, amount))
+                {
+                    DBGLOG_WARN("Dose log full\r\n");
+                }
+            }
+        }
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,54 @@
+/*******************************************************************************
+* File Name: dispense.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the schedule
+*  runner that dispenses and logs the doses.
+*
+*******************************************************************************/
+
+#if !defined(CY_DISPENSE_H)
+#define CY_DISPENSE_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Schedule times are local; the clock is UTC from the HTTP Date header */
+#if !defined(DISPENSE_UTC_OFFSET_MIN)
+    #define DISPENSE_UTC_OFFSET_MIN (0)
+#endif /* !defined(DISPENSE_UTC_OFFSET_MIN) */
+
+#define DISPENSE_MIN_PER_DAY    (1440u)
+
+
+/***************************************
+*               Macros
+****************************************/
+
+/* Drives the dispenser for one dose. The design has no actuator output yet;
+* define this to the output routine once it has.
+*/
+#if !defined(DISPENSE_DRIVE)
+    #define DISPENSE_DRIVE(slot, amount)    do { } while (0)
+#endif /* !defined(DISPENSE_DRIVE) */
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void   Dispense_Process(void);
+uint32 Dispense_ParseTime(const char text[]);
+uint32 Dispense_ParseAmount(const char text[]);
+
+
+#endif /* (CY_DISPENSE_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,800 @@
+/*******************************************************************************
+* File Name: doselog.c
+*
+* Version: 1.00
+*
+* Description:
+*  Dose event log. Dispensed doses are queued in RAM and uploaded to
+*  ThingSpeak in one bulk_update.json POST per interval, so the connect and
+*  CIPSEND overhead is paid once per batch rather than once per event.
+*
+*  The RAM queue holds exactly one flash row of events. When it is full, or
+*  when an upload fails, it is written to a ring of reserved flash rows
+*  through the flash queue. Spilled rows are uploaded first, oldest first,
+*  and erased once the server has accepted them; they survive a reset.
+*
+*  Event times come from the RTC_P4 component when DOSELOG_USE_RTC is set.
+*  Otherwise a software clock counts from the last DoseLog_SetTime(), which
+*  the poller calls with the Date header of every ThingSpeak response.
+*  Events logged before the clock is first set carry seconds since reset;
+*  the offset found when it is set converts them at upload, and nothing is
+*  uploaded until then.
+*
+*******************************************************************************/
+
+#include <doselog.h>
+#include <espat.h>
+#include <cfgstore.h>
+#include <flashq.h>
+#include <crc.h>
+#include <systime.h>
+#include <dbglog.h>
+#include <fmt.h>
+#include <string.h>
+
+#if (DOSELOG_USE_RTC)
+    #include <RTC.h>
+#endif /* (DOSELOG_USE_RTC) */
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+#define DOSELOG_SEQ_ERASED      (0u)
+
+#define DOSELOG_ROW_ADDR(row)   ((uint32) doseLogFlash + ((uint32) (row) * CY_FLASH_SIZEOF_ROW))
+#define DOSELOG_ROW_PTR(row)    ((const DOSELOG_ROW *) DOSELOG_ROW_ADDR(row))
+#define DOSELOG_ROW_NUM(row)    (DOSELOG_ROW_ADDR(row) / CY_FLASH_SIZEOF_ROW)
+
+/* Server, CFG_KEY_HOST overrides the default as for the poller */
+#define DOSELOG_DEFAULT_HOST    "api.thingspeak.com"
+#define DOSELOG_HOST_SIZE       (48u)
+#define DOSELOG_PORT            (80u)
+#define DOSELOG_KEY_SIZE        (24u)
+
+/* Upload request: the body is built behind room for the headers, which
+*  are put in front once the body length is known.
+*/
+#define DOSELOG_EVENT_JSON      (80u)
+#define DOSELOG_HEADER_ROOM     (224u)
+#define DOSELOG_REQUEST_SIZE    (DOSELOG_HEADER_ROOM + 64u + (DOSELOG_ROW_EVENTS * DOSELOG_EVENT_JSON))
+
+#define DOSELOG_LEN(text)       (sizeof(text) - 1u)
+
+/* Days from 0000-03-01 to 1970-01-01 */
+#define DOSELOG_EPOCH_DAYS      (719468u)
+#define DOSELOG_DAY_SECONDS     (86400u)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+/* One flash row of the spill ring */
+typedef struct
+{
+    uint32 seq;
+    uint16 count;
+    uint16 crc;         /* CRC-16/CCITT of the events */
+    DOSELOG_EVENT event[DOSELOG_ROW_EVENTS];
+} DOSELOG_ROW;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static uint32 DoseLog_IsValid(const DOSELOG_ROW *row);
+static cystatus DoseLog_Spill(void);
+static void DoseLog_RowWritten(uint32 rowNum, uint32 status);
+static cystatus DoseLog_Upload(const DOSELOG_EVENT event[], uint32 count, uint32 offset);
+static uint32 DoseLog_PutEvent(char buffer[], const DOSELOG_EVENT *event, uint32 offset);
+static uint32 DoseLog_PutDate(char buffer[], uint32 unixTime);
+static uint32 DoseLog_Days(uint32 year, uint32 month, uint32 day);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+/* Spill ring, accessed only through its address */
+static const uint8 CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+    doseLogFlash[DOSELOG_SPILL_ROWS * CY_FLASH_SIZEOF_ROW] = {0u};
+
+/* Written over a row once its events are uploaded */
+static const uint8 doseLogErased[CY_FLASH_SIZEOF_ROW] = {0u};
+
+static DOSELOG_EVENT doseLogRam[DOSELOG_ROW_EVENTS];
+static uint32 doseLogRamCount = 0u;
+
+/* Oldest spilled row, number of spilled rows and the next sequence */
+static uint32 doseLogHead = 0u;
+static uint32 doseLogRows = 0u;
+static uint32 doseLogSeq = 1u;
+
+/* First sequence spilled in this run, and the clock offset of this run's
+*  stamps taken before the clock was set (0 until it is set)
+*/
+static uint32 doseLogRunSeq = 1u;
+static uint32 doseLogOffset = 0u;
+
+/* Row image for the flash queue, busy until written */
+static DOSELOG_ROW doseLogRow;
+static volatile uint32 doseLogRowBusy = 0u;
+
+static uint32 doseLogDropped = 0u;
+static uint32 doseLogLast;
+static uint32 doseLogWait = DOSELOG_UPLOAD_MS;
+
+static char doseLogRequest[DOSELOG_REQUEST_SIZE];
+
+#if (!DOSELOG_USE_RTC)
+    static uint32 doseLogEpoch = 0u;
+    static uint32 doseLogEpochMs = 0u;
+#endif /* (!DOSELOG_USE_RTC) */
+
+
+/*******************************************************************************
+* Function Name: DoseLog_Start
+********************************************************************************
+* Summary:
+*  Finds the events left in the spill ring by a previous run. The valid rows
+*  are contiguous in ring order, starting with the lowest sequence number.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void DoseLog_Start(void)
+{
+    const DOSELOG_ROW *row;
+    uint32 oldest = 0xFFFFFFFFu;
+    uint32 i;
+
+    doseLogRows = 0u;
+    doseLogHead = 0u;
+    doseLogSeq  = 1u;
+
+    for (i = 0u; i < DOSELOG_SPILL_ROWS; ++i)
+    {
+        row = DOSELOG_ROW_PTR(i);
+
+        if (0u != DoseLog_IsValid(row))
+        {
+            ++doseLogRows;
+
+            if (row->seq < oldest)
+            {
+                oldest = row->seq;
+                doseLogHead = i;
+            }
+
+            if (row->seq >= doseLogSeq)
+            {
+                doseLogSeq = row->seq + 1u;
+            }
+        }
+    }
+
+    doseLogRunSeq = doseLogSeq;
+    doseLogLast = SysTime_GetMs();
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_Add
+********************************************************************************
+* Summary:
+*  Records a dispensed dose with the current time. A full RAM queue is
+*  spilled to flash first.
+*
+* Parameters:
+*  slot - schedule entry the dose belongs to.
+*  amount - dose in hundredths.
+*
+* Return:
+*  CYRET_SUCCESS, or CYRET_MEMORY if the event was dropped because neither
+*  the RAM queue nor the spill ring had room.
+*
+*******************************************************************************/
+cystatus DoseLog_Add(uint32 slot, uint32 amount)
+{
+    DOSELOG_EVENT *event;
+
+    if ((DOSELOG_ROW_EVENTS == doseLogRamCount) && (CYRET_SUCCESS != DoseLog_Spill()))
+    {
+        ++doseLogDropped;
+        return (CYRET_MEMORY);
+    }
+
+    event = &doseLogRam[doseLogRamCount++];
+    event->time     = DoseLog_GetTime();
+    event->slot     = (uint8) slot;
+    event->reserved = 0u;
+    event->amount   = (uint16) amount;
+
+    return (CYRET_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_Process
+********************************************************************************
+* Summary:
+*  Uploads one batch when the interval has elapsed: the oldest spilled row
+*  if there is one, otherwise the RAM queue. A RAM batch that fails is
+*  spilled so it survives a reset while the network is down.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void DoseLog_Process(void)
+{
+    const DOSELOG_ROW *row;
+    cystatus status;
+
+    if (0u == DoseLog_IsDue())
+    {
+        return;
+    }
+
+    doseLogLast = SysTime_GetMs();
+
+    if (0u != doseLogRows)
+    {
+        row = DOSELOG_ROW_PTR(doseLogHead);
+
+        /* A row whose write did not complete is dropped. Stamps before
+        *  the clock was set in an earlier run cannot be converted.
+        */
+        status = (0u != DoseLog_IsValid(row)) ?
+                 DoseLog_Upload(row->event, row->count, (row->seq >= doseLogRunSeq) ? doseLogOffset : 0u) :
+                 CYRET_SUCCESS;
+
+        if (CYRET_SUCCESS == status)
+        {
+            (void) FlashQ_Submit(DOSELOG_ROW_NUM(doseLogHead), doseLogErased, NULL);
+            doseLogHead = (doseLogHead + 1u) % DOSELOG_SPILL_ROWS;
+            --doseLogRows;
+        }
+    }
+    else
+    {
+        status = DoseLog_Upload(doseLogRam, doseLogRamCount, doseLogOffset);
+
+        if (CYRET_SUCCESS == status)
+        {
+            doseLogRamCount = 0u;
+        }
+        else
+        {
+            (void) DoseLog_Spill();
+        }
+    }
+
+    doseLogWait = ((CYRET_SUCCESS == status) && (0u != DoseLog_GetPending())) ?
+                  DOSELOG_CATCHUP_MS : DOSELOG_UPLOAD_MS;
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_IsDue
+********************************************************************************
+* Summary:
+*  Reports whether DoseLog_Process() would upload a batch now, so a caller
+*  sharing the connection can free it first.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Non-zero if an upload is due.
+*
+*******************************************************************************/
+uint32 DoseLog_IsDue(void)
+{
+    uint32 due = 0u;
+
+    /* Also wait for the clock, for a spill write in progress and for room
+    *  to erase a row
+    */
+    if ((SysTime_Elapsed(doseLogLast) >= doseLogWait) && (0u != DoseLog_GetPending()) &&
+        (DoseLog_GetTime() >= DOSELOG_TIME_VALID) && (0u == doseLogRowBusy) && (0u != FlashQ_GetFree()))
+    {
+        due = 1u;
+    }
+
+    return (due);
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_GetPending
+********************************************************************************
+* Summary:
+*  Returns the number of batches waiting for upload.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Spilled rows plus one if the RAM queue holds events.
+*
+*******************************************************************************/
+uint32 DoseLog_GetPending(void)
+{
+    return (doseLogRows + ((0u != doseLogRamCount) ? 1u : 0u));
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_GetDropped
+********************************************************************************
+* Summary:
+*  Returns the number of events lost because the log was full.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Dropped event count.
+*
+*******************************************************************************/
+uint32 DoseLog_GetDropped(void)
+{
+    return (doseLogDropped);
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_GetTime
+********************************************************************************
+* Summary:
+*  Returns the current time used to stamp events.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Unix time in seconds, or seconds since reset while the clock is not set.
+*
+*******************************************************************************/
+uint32 DoseLog_GetTime(void)
+{
+#if (DOSELOG_USE_RTC)
+    return ((uint32) RTC_GetUnixTime());
+#else
+    return (doseLogEpoch + (SysTime_Elapsed(doseLogEpochMs) / 1000u));
+#endif /* (DOSELOG_USE_RTC) */
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_SetTime
+********************************************************************************
+* Summary:
+*  Sets the clock used to stamp events. The first time, also records the
+*  offset that converts the earlier stamps of this run.
+*
+* Parameters:
+*  unixTime - Unix time in seconds.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void DoseLog_SetTime(uint32 unixTime)
+{
+    uint32 before = DoseLog_GetTime();
+
+    if ((before < DOSELOG_TIME_VALID) && (unixTime >= DOSELOG_TIME_VALID))
+    {
+        doseLogOffset = unixTime - before;
+    }
+
+#if (DOSELOG_USE_RTC)
+    RTC_SetUnixTime((uint64) unixTime);
+#else
+    doseLogEpoch   = unixTime;
+    doseLogEpochMs = SysTime_GetMs();
+#endif /* (DOSELOG_USE_RTC) */
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_SetTimeHttp
+********************************************************************************
+* Summary:
+*  Sets the clock from an HTTP date such as "Sun, 18 Oct 2026 12:34:56 GMT".
+*  Text that does not parse is ignored.
+*
+* Parameters:
+*  date - date text, not terminated.
+*  len - text length.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void DoseLog_SetTimeHttp(const char date[], uint32 len)
+{
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    uint32 value[6];    /* day, month, year, hour, minute, second */
+    uint32 field = 0u;
+    uint32 i;
+    uint32 m;
+
+    (void) memset(value, 0, sizeof(value));
+
+    /* "Www, DD Mmm YYYY hh:mm:ss" */
+    for (i = 5u; (i < len) && (field < 6u) && ('\r' != date[i]); ++i)
+    {
+        if ((date[i] >= '0') && (date[i] <= '9'))
+        {
+            value[field] = (value[field] * 10u) + (uint32) (date[i] - '0');
+        }
+        else if ((1u == field) && ((i + 3u) <= len) && (date[i] >= 'A') && (date[i] <= 'Z'))
+        {
+            for (m = 0u; (m < 12u) && (0 != memcmp(&date[i], &months[m * 3u], 3u)); ++m)
+            {
+            }
+            value[1] = m + 1u;
+            i += 2u;
+        }
+        else if ((' ' == date[i]) || (':' == date[i]))
+        {
+            ++field;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if ((field >= 5u) && (value[0] >= 1u) && (value[1] >= 1u) && (value[1] <= 12u) && (value[2] >= 1970u))
+    {
+        DoseLog_SetTime((DoseLog_Days(value[2], value[1], value[0]) * DOSELOG_DAY_SECONDS) +
+                        (value[3] * 3600u) + (value[4] * 60u) + value[5]);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_IsValid
+********************************************************************************
+* Summary:
+*  Checks a spill row.
+*
+* Parameters:
+*  row - row in flash.
+*
+* Return:
+*  Non-zero if the row holds events that were not uploaded yet.
+*
+*******************************************************************************/
+static uint32 DoseLog_IsValid(const DOSELOG_ROW *row)
+{
+    return ((DOSELOG_SEQ_ERASED != row->seq) && (0u != row->count) && (row->count <= DOSELOG_ROW_EVENTS) &&
+            (row->crc == Crc16_Update(CRC16_INIT, (const uint8 *) row->event,
+                                      row->count * sizeof(DOSELOG_EVENT))));
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_Spill
+********************************************************************************
+* Summary:
+*  Queues the RAM events for writing to the next row of the spill ring and
+*  empties the RAM queue.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  CYRET_SUCCESS, or CYRET_MEMORY if the ring, the row buffer or the flash
+*  queue is busy or full.
+*
+*******************************************************************************/
+static cystatus DoseLog_Spill(void)
+{
+    uint32 row;
+
+    if ((0u != doseLogRowBusy) || (DOSELOG_SPILL_ROWS == doseLogRows) || (0u == FlashQ_GetFree()))
+    {
+        return (CYRET_MEMORY);
+    }
+
+    (void) memset(&doseLogRow, 0, sizeof(doseLogRow));
+    doseLogRow.seq   = doseLogSeq++;
+    doseLogRow.count = (uint16) doseLogRamCount;
+    (void) memcpy(doseLogRow.event, doseLogRam, doseLogRamCount * sizeof(DOSELOG_EVENT));
+    doseLogRow.crc   = Crc16_Update(CRC16_INIT, (const uint8 *) doseLogRow.event,
+                                    doseLogRamCount * sizeof(DOSELOG_EVENT));
+
+    row = (doseLogHead + doseLogRows) % DOSELOG_SPILL_ROWS;
+    doseLogRowBusy = 1u;
+    (void) FlashQ_Submit(DOSELOG_ROW_NUM(row), (const uint8 *) &doseLogRow, &DoseLog_RowWritten);
+
+    ++doseLogRows;
+    doseLogRamCount = 0u;
+
+    return (CYRET_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_RowWritten
+********************************************************************************
+* Summary:
+*  Flash queue callback. Releases the row buffer; a failed write leaves an
+*  invalid row that DoseLog_Process() drops.
+*
+* Parameters:
+*  rowNum - flash row number.
+*  status - CY_SYS_FLASH_x result of the write.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void DoseLog_RowWritten(uint32 rowNum, uint32 status)
+{
+    (void) rowNum;
+
+    if (CY_SYS_FLASH_SUCCESS != status)
+    {
+        doseLogDropped += doseLogRow.count;
+    }
+
+    doseLogRowBusy = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_Upload
+********************************************************************************
+* Summary:
+*  Sends a batch of events in one bulk_update.json POST. The target is taken
+*  from CFG_KEY_UPLOAD as "<channel ID>,<write API key>", the server from
+*  CFG_KEY_HOST.
+*
+* Parameters:
+*  event - events to send.
+*  count - number of events.
+*  offset - added to stamps taken before the clock was set, 0 if unknown.
+*
+* Return:
+*  CYRET_SUCCESS if the server accepted the batch, CYRET_INVALID_STATE if no
+*  upload channel is configured, or the link error.
+*
+*******************************************************************************/
+static cystatus DoseLog_Upload(const DOSELOG_EVENT event[], uint32 count, uint32 offset)
+{
+    char config[FMT_UINT32_SIZE + DOSELOG_KEY_SIZE];
+    char host[DOSELOG_HOST_SIZE];
+    char *key;
+    char *body = &doseLogRequest[DOSELOG_HEADER_ROOM];
+    uint32 bodyLen = 0u;
+    uint32 len;
+    uint32 i;
+    cystatus status;
+
+    if (0u == CfgStore_Read(CFG_KEY_UPLOAD, (uint8 *) config, sizeof(config)))
+    {
+        return (CYRET_INVALID_STATE);
+    }
+
+    key = strchr(config, ',');
+    if (NULL == key)
+    {
+        return (CYRET_INVALID_STATE);
+    }
+    *key++ = 0;
+
+    if (0u == CfgStore_Read(CFG_KEY_HOST, (uint8 *) host, sizeof(host)))
+    {
+        (void) strcpy(host, DOSELOG_DEFAULT_HOST);
+    }
+
+    /* Body */
+    (void) strcpy(body, "{\"write_api_key\":\"");
+    (void) strcat(body, key);
+    (void) strcat(body, "\",\"updates\":[");
+    bodyLen = strlen(body);
+
+    for (i = 0u; i < count; ++i)
+    {
+        if (0u != i)
+        {
+            body[bodyLen++] = ',';
+        }
+        bodyLen += DoseLog_PutEvent(&body[bodyLen], &event[i], offset);
+    }
+
+    body[bodyLen++] = ']';
+    body[bodyLen++] = '}';
+
+    /* Headers, now that the content length is known */
+    (void) strcpy(doseLogRequest, "POST /channels/");
+    (void) strcat(doseLogRequest, config);
+    (void) strcat(doseLogRequest, "/bulk_update.json HTTP/1.1\r\nHost: ");
+    (void) strcat(doseLogRequest, host);
+    (void) strcat(doseLogRequest, "\r\n"
+                                  "Connection: close\r\n"
+                                  "Content-Type: application/json\r\n"
+                                  "Content-Length: ");
+    len = strlen(doseLogRequest);
+    len += Fmt_Dec(&doseLogRequest[len], bodyLen);
+    (void) memcpy(&doseLogRequest[len], "\r\n\r\n", DOSELOG_LEN("\r\n\r\n"));
+    len += DOSELOG_LEN("\r\n\r\n");
+
+    (void) memmove(&doseLogRequest[len], body, bodyLen);
+    len += bodyLen;
+
+    status = Esp_Connect(host, DOSELOG_PORT);
+
+    if (ESP_TOKEN_SUCCESS == status)
+    {
+        status = Esp_Send((const uint8 *) doseLogRequest, len);
+
+        if (ESP_TOKEN_SUCCESS == status)
+        {
+            status = Esp_Receive((uint8 *) doseLogRequest, sizeof(doseLogRequest) - 1u, &len,
+                                 "CLOSED", ESP_TIMEOUT_RECEIVE);
+        }
+
+        if (ESP_TOKEN_SUCCESS == status)
+        {
+            doseLogRequest[len] = 0;
+            status = (NULL != strstr(doseLogRequest, "\"success\":true")) ? CYRET_SUCCESS : CYRET_BAD_DATA;
+        }
+        else
+        {
+            (void) Esp_Command("AT+CIPCLOSE", "OK", "ERROR", ESP_TIMEOUT_CMD);
+        }
+    }
+
+    if (CYRET_SUCCESS != status)
+    {
+        DBGLOG_WARN("Dose upload failed\r\n");
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_PutEvent
+********************************************************************************
+* Summary:
+*  Formats one event as a bulk update entry: field1 is the slot, field2 the
+*  amount. An event stamped before the clock was set is moved by the
+*  offset; without one it goes without created_at and gets the upload time.
+*
+* Parameters:
+*  buffer - output, at least DOSELOG_EVENT_JSON bytes.
+*  event - event to format.
+*  offset - added to stamps taken before the clock was set, 0 if unknown.
+*
+* Return:
+*  Number of characters written.
+*
+*******************************************************************************/
+static uint32 DoseLog_PutEvent(char buffer[], const DOSELOG_EVENT *event, uint32 offset)
+{
+    uint32 time = event->time;
+    uint32 len = 0u;
+
+    if (time < DOSELOG_TIME_VALID)
+    {
+        time += offset;
+    }
+
+    buffer[len++] = '{';
+
+    if (time >= DOSELOG_TIME_VALID)
+    {
+        (void) strcpy(&buffer[len], "\"created_at\":\"");
+        len += DOSELOG_LEN("\"created_at\":\"");
+        len += DoseLog_PutDate(&buffer[len], time);
+        (void) strcpy(&buffer[len], "\",");
+        len += DOSELOG_LEN("\",");
+    }
+
+    (void) strcpy(&buffer[len], "\"field1\":");
+    len += DOSELOG_LEN("\"field1\":");
+    len += Fmt_Dec(&buffer[len], event->slot);
+    (void) strcpy(&buffer[len], ",\"field2\":");
+    len += DOSELOG_LEN(",\"field2\":");
+    len += Fmt_Fixed(&buffer[len], (int32) event->amount, 2u);
+    buffer[len++] = '}';
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_PutDate
+********************************************************************************
+* Summary:
+*  Formats a Unix time as ISO 8601 UTC, "YYYY-MM-DDThh:mm:ssZ".
+*
+* Parameters:
+*  buffer - output, at least 21 bytes.
+*  unixTime - Unix time in seconds.
+*
+* Return:
+*  Number of characters written, without the terminator.
+*
+*******************************************************************************/
+static uint32 DoseLog_PutDate(char buffer[], uint32 unixTime)
+{
+    uint32 days = (unixTime / DOSELOG_DAY_SECONDS) + DOSELOG_EPOCH_DAYS;
+    uint32 secs = unixTime % DOSELOG_DAY_SECONDS;
+    uint32 era = days / 146097u;
+    uint32 doe = days - (era * 146097u);
+    uint32 yoe = (doe - (doe / 1460u) + (doe / 36524u) - (doe / 146096u)) / 365u;
+    uint32 doy = doe - ((365u * yoe) + (yoe / 4u) - (yoe / 100u));
+    uint32 mp = ((5u * doy) + 2u) / 153u;
+    uint32 day = doy - (((153u * mp) + 2u) / 5u) + 1u;
+    uint32 month = (mp < 10u) ? (mp + 3u) : (mp - 9u);
+    uint32 year = (yoe + (era * 400u)) + ((month <= 2u) ? 1u : 0u);
+    uint32 len;
+
+    len  = Fmt_DecPad(&buffer[0], year, 4u);
+    buffer[len++] = '-';
+    len += Fmt_DecPad(&buffer[len], month, 2u);
+    buffer[len++] = '-';
+    len += Fmt_DecPad(&buffer[len], day, 2u);
+    buffer[len++] = 'T';
+    len += Fmt_DecPad(&buffer[len], secs / 3600u, 2u);
+    buffer[len++] = ':';
+    len += Fmt_DecPad(&buffer[len], (secs / 60u) % 60u, 2u);
+    buffer[len++] = ':';
+    len += Fmt_DecPad(&buffer[len], secs % 60u, 2u);
+    buffer[len++] = 'Z';
+    buffer[len] = 0;
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: DoseLog_Days
+********************************************************************************
+* Summary:
+*  Converts a calendar date to days since 1970-01-01.
+*
+* Parameters:
+*  year - year, 1970 or later.
+*  month - month, 1 to 12.
+*  day - day of the month.
+*
+* Return:
+*  Days since the Unix epoch.
+*
+*******************************************************************************/
+static uint32 DoseLog_Days(uint32 year, uint32 month, uint32 day)
+{
+    uint32 era;
+    uint32 yoe;
+    uint32 doy;
+
+    year -= (month <= 2u) ? 1u : 0u;
+    era = year / 400u;
+    yoe = year - (era * 400u);
+    doy = ((((153u * ((month > 2u) ? (month - 3u) : (month + 9u))) + 2u) / 5u) + day) - 1u;
+
+    return ((era * 146097u) + (yoe * 365u) + (yoe / 4u) - (yoe / 100u) + doy - DOSELOG_EPOCH_DAYS);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,73 @@
+/*******************************************************************************
+* File Name: doselog.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the dose event
+*  log and its batched upload to ThingSpeak.
+*
+*******************************************************************************/
+
+#if !defined(CY_DOSELOG_H)
+#define CY_DOSELOG_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Set to 1 when the design has an RTC_P4 component named RTC */
+#if !defined(DOSELOG_USE_RTC)
+    #define DOSELOG_USE_RTC     (0u)
+#endif /* !defined(DOSELOG_USE_RTC) */
+
+/* Flash rows kept for events that could not be uploaded */
+#define DOSELOG_SPILL_ROWS      (8u)
+
+/* One upload per interval; a backlog is sent at the ThingSpeak rate limit */
+#define DOSELOG_UPLOAD_MS       (300000u)
+#define DOSELOG_CATCHUP_MS      (15000u)
+
+/* Events per flash row, and the size of the RAM queue */
+#define DOSELOG_ROW_HEADER      (8u)
+#define DOSELOG_ROW_EVENTS      ((CY_FLASH_SIZEOF_ROW - DOSELOG_ROW_HEADER) / sizeof(DOSELOG_EVENT))
+
+/* Times below this are seconds since reset: the clock was not set yet */
+#define DOSELOG_TIME_VALID      (1500000000u)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+typedef struct
+{
+    uint32 time;        /* Unix time in seconds */
+    uint8 slot;         /* Index into schedule.entry[] */
+    uint8 reserved;
+    uint16 amount;      /* Dose in hundredths */
+} DOSELOG_EVENT;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void     DoseLog_Start(void);
+cystatus DoseLog_Add(uint32 slot, uint32 amount);
+void     DoseLog_Process(void);
+uint32   DoseLog_IsDue(void);
+uint32   DoseLog_GetPending(void);
+uint32   DoseLog_GetDropped(void);
+uint32   DoseLog_GetTime(void);
+void     DoseLog_SetTime(uint32 unixTime);
+void     DoseLog_SetTimeHttp(const char date[], uint32 len);
+
+
+#endif /* (CY_DOSELOG_H) */
+
+
+/* [] END OF FILE */
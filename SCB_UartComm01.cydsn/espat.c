@@ -0,0 +1,539 @@
+/*******************************************************************************
+* File Name: espat.c
+*
+* Version: 1.00
+*
+* Description:
+*  ESP8266 AT command link. Commands are written to the WIFI SCB and the
+*  response is matched line by line against the expected result tokens.
+*  Every wait is bounded by a timeout and runs the background services
+*  through Esp_Idle().
+*
+*  Connection data can arrive unsolicited in the middle of an exchange, for
+*  example a "+IPD" frame before the "SEND OK" of AT+CIPSEND. While a data
+*  sink is registered, every byte is offered to it first and the bytes it
+*  takes are kept out of the token matching.
+*
+*******************************************************************************/
+
+#include <espat.h>
+#include <systime.h>
+#include <ilotrim.h>
+#include <flashq.h>
+#include <linkstat.h>
+#include <attrace.h>
+#include <dbglog.h>
+#include <stackmon.h>
+#include <fmt.h>
+#include <prof.h>
+#include <string.h>
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static cystatus Esp_ReadUntil(uint8 buffer[], uint32 size, uint32 *stored,
+                              const char success[], const char fail[], uint32 timeoutMs);
+static uint32 Esp_LineIs(const char line[], uint32 len, const char token[]);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static espIdleHook espIdle = NULL;
+static espDataSink espSink = NULL;
+
+
+/*******************************************************************************
+* Function Name: Esp_PutString
+********************************************************************************
+* Summary:
+*  Sends a zero-terminated string to the ESP8266.
+*
+* Parameters:
+*  string - string to send.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Esp_PutString(const char string[])
+{
+    uint32 i;
+
+    for (i = 0u; 0 != string[i]; ++i)
+    {
+        LinkStat_NoteTx(LINKSTAT_WIFI);
+        WIFI_UartPutChar((uint32) string[i]);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_PutNumber
+********************************************************************************
+* Summary:
+*  Sends an unsigned number in decimal.
+*
+* Parameters:
+*  number - value to send.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Esp_PutNumber(uint32 number)
+{
+    char digits[FMT_UINT32_SIZE];
+
+    (void) Fmt_Dec(digits, number);
+    Esp_PutString(digits);
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_PutData
+********************************************************************************
+* Summary:
+*  Sends a block of bytes to the ESP8266 as one transfer, writing the TX
+*  FIFO in bursts instead of one API call per byte.
+*
+* Parameters:
+*  data - bytes to send.
+*  len - number of bytes.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Esp_PutData(const uint8 data[], uint32 len)
+{
+#if (WIFI_INTERNAL_TX_SW_BUFFER_CONST)
+    /* The component queues the block in its software buffer */
+    LinkStat_NoteTx(LINKSTAT_WIFI);
+    WIFI_SpiUartPutArray(data, len);
+#else
+    uint32 i = 0u;
+
+    /* Fill the TX FIFO directly whenever it has room */
+    while (i < len)
+    {
+        if (WIFI_SPI_UART_FIFO_SIZE == WIFI_GET_TX_FIFO_ENTRIES)
+        {
+            LinkStat_NoteTx(LINKSTAT_WIFI);
+
+            while (WIFI_SPI_UART_FIFO_SIZE == WIFI_GET_TX_FIFO_ENTRIES)
+            {
+            }
+        }
+
+        do
+        {
+            WIFI_TX_FIFO_WR_REG = data[i];
+            ++i;
+        }
+        while ((i < len) && (WIFI_SPI_UART_FIFO_SIZE != WIFI_GET_TX_FIFO_ENTRIES));
+    }
+#endif /* (WIFI_INTERNAL_TX_SW_BUFFER_CONST) */
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_ReadByte
+********************************************************************************
+* Summary:
+*  Waits for one byte from the ESP8266.
+*
+* Parameters:
+*  byte - pointer to store the byte.
+*  timeoutMs - maximum wait in milliseconds.
+*
+* Return:
+*  CYRET_SUCCESS or CYRET_TIMEOUT.
+*
+*******************************************************************************/
+cystatus Esp_ReadByte(uint8 *byte, uint32 timeoutMs)
+{
+    uint32 start = SysTime_GetMs();
+    cystatus status = CYRET_TIMEOUT;
+
+    do
+    {
+        LinkStat_SampleRx(LINKSTAT_WIFI);
+
+        if (0u != WIFI_SpiUartGetRxBufferSize())
+        {
+            *byte = (uint8) WIFI_SpiUartReadRxData();
+            status = CYRET_SUCCESS;
+            break;
+        }
+
+        Esp_Idle();
+    }
+    while (SysTime_Elapsed(start) < timeoutMs);
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_WaitToken
+********************************************************************************
+* Summary:
+*  Reads response lines until a line equals the success or the fail token.
+*  A token is matched as soon as the line is complete up to its length, so
+*  prompts without a line end such as ">" are recognised.
+*
+* Parameters:
+*  success - token that ends the wait successfully.
+*  fail - token that ends the wait with failure, or NULL.
+*  timeoutMs - maximum wait in milliseconds.
+*
+* Return:
+*  ESP_TOKEN_SUCCESS, ESP_TOKEN_FAIL or CYRET_TIMEOUT.
+*
+*******************************************************************************/
+cystatus Esp_WaitToken(const char success[], const char fail[], uint32 timeoutMs)
+{
+    return (Esp_ReadUntil(NULL, 0u, NULL, success, fail, timeoutMs));
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_Receive
+********************************************************************************
+* Summary:
+*  Stores everything the ESP8266 sends until a line equals the token, for
+*  example the "CLOSED" that follows a complete HTTP response. Bytes beyond
+*  the buffer size are read and dropped.
+*
+* Parameters:
+*  buffer - storage for the received bytes, token line included.
+*  size - size of the buffer.
+*  len - pointer to store the number of bytes stored.
+*  token - token that ends the reception.
+*  timeoutMs - maximum wait in milliseconds.
+*
+* Return:
+*  ESP_TOKEN_SUCCESS or CYRET_TIMEOUT.
+*
+*******************************************************************************/
+cystatus Esp_Receive(uint8 buffer[], uint32 size, uint32 *len, const char token[], uint32 timeoutMs)
+{
+    return (Esp_ReadUntil(buffer, size, len, token, NULL, timeoutMs));
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_Command
+********************************************************************************
+* Summary:
+*  Sends an AT command terminated by CR LF and waits for its result.
+*
+* Parameters:
+*  command - command text without line end.
+*  success - result token for success, typically "OK".
+*  fail - result token for failure, typically "ERROR".
+*  timeoutMs - maximum wait in milliseconds.
+*
+* Return:
+*  ESP_TOKEN_SUCCESS, ESP_TOKEN_FAIL or CYRET_TIMEOUT.
+*
+*******************************************************************************/
+cystatus Esp_Command(const char command[], const char success[], const char fail[], uint32 timeoutMs)
+{
+    AtTrace_Command(command, strlen(command));
+    Esp_PutString(command);
+    Esp_PutString("\r\n");
+
+    return (Esp_WaitToken(success, fail, timeoutMs));
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_Join
+********************************************************************************
+* Summary:
+*  Joins an access point with AT+CWJAP.
+*
+* Parameters:
+*  ssid - network name.
+*  pass - network password.
+*
+* Return:
+*  ESP_TOKEN_SUCCESS, ESP_TOKEN_FAIL or CYRET_TIMEOUT.
+*
+*******************************************************************************/
+cystatus Esp_Join(const char ssid[], const char pass[])
+{
+    AtTrace_Command("AT+CWJAP", 0u);
+    Esp_PutString("AT+CWJAP=\"");
+    Esp_PutString(ssid);
+    Esp_PutString("\",\"");
+    Esp_PutString(pass);
+    Esp_PutString("\"\r\n");
+
+    return (Esp_WaitToken("OK", "FAIL", ESP_TIMEOUT_JOIN));
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_Connect
+********************************************************************************
+* Summary:
+*  Opens a TCP connection.
+*
+* Parameters:
+*  host - server name or address.
+*  port - TCP port.
+*
+* Return:
+*  ESP_TOKEN_SUCCESS, ESP_TOKEN_FAIL or CYRET_TIMEOUT.
+*
+*******************************************************************************/
+cystatus Esp_Connect(const char host[], uint32 port)
+{
+    AtTrace_Command("AT+CIPSTART", 0u);
+    Esp_PutString("AT+CIPSTART=\"TCP\",\"");
+    Esp_PutString(host);
+    Esp_PutString("\",");
+    Esp_PutNumber(port);
+    Esp_PutString("\r\n");
+
+    return (Esp_WaitToken("OK", "ERROR", ESP_TIMEOUT_CONNECT));
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_Send
+********************************************************************************
+* Summary:
+*  Sends a block of data over the open connection with AT+CIPSEND.
+*
+* Parameters:
+*  data - bytes to send.
+*  len - number of bytes, up to 2048.
+*
+* Return:
+*  ESP_TOKEN_SUCCESS, ESP_TOKEN_FAIL or CYRET_TIMEOUT.
+*
+*******************************************************************************/
+cystatus Esp_Send(const uint8 data[], uint32 len)
+{
+    cystatus status;
+
+    AtTrace_Command("AT+CIPSEND", 0u);
+    Esp_PutString("AT+CIPSEND=");
+    Esp_PutNumber(len);
+    Esp_PutString("\r\n");
+
+    status = Esp_WaitToken(">", "CLOSED", ESP_TIMEOUT_CMD);
+
+    if (ESP_TOKEN_SUCCESS == status)
+    {
+        Esp_PutData(data, len);
+        AtTrace_Event(ATTRACE_EV_DATA, 0u, len);
+        status = Esp_WaitToken("SEND OK", "CLOSED", ESP_TIMEOUT_SEND);
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_Idle
+********************************************************************************
+* Summary:
+*  Runs the background services while waiting for the ESP8266.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Esp_Idle(void)
+{
+    IloTrim_Process();
+    FlashQ_Process();
+    DbgLog_Process();
+    StackMon_Process();
+
+    if (NULL != espIdle)
+    {
+        espIdle();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_SetIdleHook
+********************************************************************************
+* Summary:
+*  Registers a function that Esp_Idle() calls in addition to the background
+*  services, for example a debug console.
+*
+* Parameters:
+*  hook - function to call, or NULL.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Esp_SetIdleHook(espIdleHook hook)
+{
+    espIdle = hook;
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_SetDataSink
+********************************************************************************
+* Summary:
+*  Registers the function that takes the connection data received while
+*  waiting for a token, for example the "+IPD" framing of an MQTT session.
+*  The sink may change or clear the registration from within the call.
+*
+* Parameters:
+*  sink - function to call, or NULL.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Esp_SetDataSink(espDataSink sink)
+{
+    espSink = sink;
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_ReadUntil
+********************************************************************************
+* Summary:
+*  Common part of Esp_WaitToken() and Esp_Receive(): reads until a line
+*  equals one of the tokens, optionally keeping a copy of the bytes.
+*
+* Parameters:
+*  buffer - storage for the received bytes, or NULL.
+*  size - size of the buffer.
+*  stored - pointer to store the number of bytes kept, or NULL.
+*  success - token that ends the wait successfully.
+*  fail - token that ends the wait with failure, or NULL.
+*  timeoutMs - maximum wait in milliseconds.
+*
+* Return:
+*  ESP_TOKEN_SUCCESS, ESP_TOKEN_FAIL or CYRET_TIMEOUT.
+*
+*******************************************************************************/
+static cystatus Esp_ReadUntil(uint8 buffer[], uint32 size, uint32 *stored,
+                              const char success[], const char fail[], uint32 timeoutMs)
+{
+    char line[ESP_LINE_SIZE];
+    uint32 len = 0u;
+    uint32 received = 0u;
+    uint32 start = SysTime_GetMs();
+    uint32 elapsed = 0u;
+    cystatus status = CYRET_TIMEOUT;
+    uint8 byte;
+
+    AtTrace_Wait(success);
+
+    while (CYRET_SUCCESS == Esp_ReadByte(&byte, timeoutMs - elapsed))
+    {
+        if ((NULL != buffer) && (received < size))
+        {
+            buffer[received] = byte;
+        }
+        ++received;
+
+        if (1u == received)
+        {
+            PROF_END(PROF_STAGE_FIRST_BYTE);
+        }
+
+        if ((NULL != espSink) && (0u != espSink(byte)))
+        {
+            /* Connection data: a token starts on a fresh line after it */
+            len = 0u;
+        }
+        else if ('\n' == byte)
+        {
+            if (0u != len)
+            {
+                AtTrace_Line(line, len);
+            }
+            len = 0u;
+        }
+        else if (('\r' != byte) && (len < ESP_LINE_SIZE))
+        {
+            line[len++] = (char) byte;
+
+            if (0u != Esp_LineIs(line, len, success))
+            {
+                status = ESP_TOKEN_SUCCESS;
+                break;
+            }
+
+            if ((NULL != fail) && (0u != Esp_LineIs(line, len, fail)))
+            {
+                status = ESP_TOKEN_FAIL;
+                break;
+            }
+        }
+        else
+        {
+            /* Line end or overlong line */
+        }
+
+        elapsed = SysTime_Elapsed(start);
+        if (elapsed >= timeoutMs)
+        {
+            break;
+        }
+    }
+
+    if (NULL != stored)
+    {
+        *stored = (received < size) ? received : size;
+    }
+
+    if (CYRET_TIMEOUT == status)
+    {
+        AtTrace_Event(ATTRACE_EV_TIMEOUT, 0u, received);
+    }
+    else
+    {
+        AtTrace_Line(line, len);
+        AtTrace_Event(ATTRACE_EV_DONE, 0u, received);
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Esp_LineIs
+********************************************************************************
+* Summary:
+*  Compares the received part of a line with a token.
+*
+* Parameters:
+*  line - received characters, not terminated.
+*  len - number of received characters.
+*  token - zero-terminated token.
+*
+* Return:
+*  Non-zero if the line equals the token.
+*
+*******************************************************************************/
+static uint32 Esp_LineIs(const char line[], uint32 len, const char token[])
+{
+    return ((len == strlen(token)) && (0 == memcmp(line, token, len)));
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,72 @@
+/*******************************************************************************
+* File Name: espat.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the ESP8266 AT
+*  command link on the WIFI SCB.
+*
+*******************************************************************************/
+
+#if !defined(CY_ESPAT_H)
+#define CY_ESPAT_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Longest response line kept for token matching */
+#define ESP_LINE_SIZE           (64u)
+
+/* Default timeouts in milliseconds */
+#define ESP_TIMEOUT_CMD         (2000u)
+#define ESP_TIMEOUT_JOIN        (20000u)
+#define ESP_TIMEOUT_CONNECT     (10000u)
+#define ESP_TIMEOUT_SEND        (5000u)
+#define ESP_TIMEOUT_RECEIVE     (10000u)
+
+/* Esp_WaitToken() results besides CYRET_TIMEOUT */
+#define ESP_TOKEN_SUCCESS       (CYRET_SUCCESS)
+#define ESP_TOKEN_FAIL          (CYRET_BAD_DATA)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+/* Called from Esp_Idle() while waiting for the module */
+typedef void (*espIdleHook)(void);
+
+/* Called for every byte received while waiting for a token; returns
+*  non-zero if the byte was connection data that it has taken.
+*/
+typedef uint32 (*espDataSink)(uint8 byte);
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void     Esp_PutString(const char string[]);
+void     Esp_PutNumber(uint32 number);
+void     Esp_PutData(const uint8 data[], uint32 len);
+cystatus Esp_ReadByte(uint8 *byte, uint32 timeoutMs);
+cystatus Esp_WaitToken(const char success[], const char fail[], uint32 timeoutMs);
+cystatus Esp_Receive(uint8 buffer[], uint32 size, uint32 *len, const char token[], uint32 timeoutMs);
+cystatus Esp_Command(const char command[], const char success[], const char fail[], uint32 timeoutMs);
+cystatus Esp_Join(const char ssid[], const char pass[]);
+cystatus Esp_Connect(const char host[], uint32 port);
+cystatus Esp_Send(const uint8 data[], uint32 len);
+void     Esp_Idle(void);
+void     Esp_SetIdleHook(espIdleHook hook);
+void     Esp_SetDataSink(espDataSink sink);
+
+
+#endif /* (CY_ESPAT_H) */
+
+
+/* [] END OF FILE */
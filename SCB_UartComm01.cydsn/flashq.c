@@ -0,0 +1,324 @@
+/*******************************************************************************
+* File Name: flashq.c
+*
+* Version: 1.00
+*
+* Description:
+*  Background flash row write queue. All flash writes in the project go
+*  through this queue so that only one write is in flight at a time.
+*
+*  On devices with parallel flash programming each row is started with
+*  CySysFlashStartWriteRow() and completed from FlashQ_Process() with
+*  CySysFlashResumeWriteRow(), so interrupts keep being serviced while the
+*  row is erased and programmed. Other devices (including the PSoC 4200 BLE
+*  this project is built for) have to stall the CPU for the whole write; there
+*  the queue defers each row until the WIFI receiver has been quiet for
+*  FLASHQ_QUIET_MS, i.e. between ESP8266 transactions.
+*
+*******************************************************************************/
+
+#include <flashq.h>
+#include <systime.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+typedef struct
+{
+    uint32 rowNum;
+    const uint8 *rowData;
+    flashQCallback callback;
+} FLASHQ_ENTRY;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void FlashQ_Complete(uint32 status);
+static void FlashQ_SyncCallback(uint32 rowNum, uint32 status);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static FLASHQ_ENTRY flashQ[FLASHQ_DEPTH];
+static uint32 flashQHead = 0u;
+static uint32 flashQCount = 0u;
+
+/* Skip the quiet period check while flushing */
+static uint32 flashQForce = 0u;
+
+#if (FLASHQ_NON_BLOCKING)
+    static uint32 flashQActive = 0u;
+#else
+    static uint32 flashQQuietStart = 0u;
+#endif /* (FLASHQ_NON_BLOCKING) */
+
+static uint32 flashQSyncStatus;
+
+
+/*******************************************************************************
+* Function Name: FlashQ_Submit
+********************************************************************************
+* Summary:
+*  Queues a row write. The row data is not copied and must stay unchanged
+*  until the callback has been called.
+*
+* Parameters:
+*  rowNum - flash row number.
+*  rowData - CY_FLASH_SIZEOF_ROW bytes to write.
+*  callback - function called on completion, or NULL.
+*
+* Return:
+*  CYRET_SUCCESS if queued, CYRET_MEMORY if the queue is full.
+*
+*******************************************************************************/
+cystatus FlashQ_Submit(uint32 rowNum, const uint8 rowData[], flashQCallback callback)
+{
+    FLASHQ_ENTRY *entry;
+    cystatus status = CYRET_MEMORY;
+
+    if (flashQCount < FLASHQ_DEPTH)
+    {
+        entry = &flashQ[(flashQHead + flashQCount) % FLASHQ_DEPTH];
+        entry->rowNum   = rowNum;
+        entry->rowData  = rowData;
+        entry->callback = callback;
+
+    #if (!FLASHQ_NON_BLOCKING)
+        if (0u == flashQCount)
+        {
+            flashQQuietStart = SysTime_GetMs();
+        }
+    #endif /* (!FLASHQ_NON_BLOCKING) */
+
+        ++flashQCount;
+        status = CYRET_SUCCESS;
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: FlashQ_GetFree
+********************************************************************************
+* Summary:
+*  Returns the number of free queue entries.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of rows that can be submitted.
+*
+*******************************************************************************/
+uint32 FlashQ_GetFree(void)
+{
+    return (FLASHQ_DEPTH - flashQCount);
+}
+
+
+/*******************************************************************************
+* Function Name: FlashQ_GetPending
+********************************************************************************
+* Summary:
+*  Returns the number of rows not yet written, including the one in progress.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of pending rows.
+*
+*******************************************************************************/
+uint32 FlashQ_GetPending(void)
+{
+    return (flashQCount);
+}
+
+
+/*******************************************************************************
+* Function Name: FlashQ_Process
+********************************************************************************
+* Summary:
+*  Advances the row write at the head of the queue. Call it from the main
+*  loop and from busy-wait loops.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void FlashQ_Process(void)
+{
+    const FLASHQ_ENTRY *entry;
+    uint32 status;
+
+    if (0u == flashQCount)
+    {
+        return;
+    }
+
+    entry = &flashQ[flashQHead];
+
+#if (FLASHQ_NON_BLOCKING)
+    if (0u == flashQActive)
+    {
+        status = CySysFlashStartWriteRow(entry->rowNum, entry->rowData);
+
+        if (CY_SYS_FLASH_SUCCESS == status)
+        {
+            flashQActive = 1u;
+        }
+        else
+        {
+            FlashQ_Complete(status);
+        }
+    }
+    else
+    {
+        status = CySysFlashGetWriteRowStatus();
+
+        if (CY_SYS_FLASH_PENDING_RESUME == status)
+        {
+            (void) CySysFlashResumeWriteRow();
+        }
+        else if (CY_SYS_FLASH_CALL_IN_PROGRESS != status)
+        {
+            flashQActive = 0u;
+            FlashQ_Complete((CY_SYS_FLASH_RESUME_COMPLETED == status) ? CY_SYS_FLASH_SUCCESS : status);
+        }
+        else
+        {
+            /* SPC is still busy */
+        }
+    }
+#else
+    if ((0u == flashQForce) && (0u != WIFI_SpiUartGetRxBufferSize()))
+    {
+        /* The ESP8266 is talking: restart the quiet period */
+        flashQQuietStart = SysTime_GetMs();
+    }
+    else if ((0u != flashQForce) || (SysTime_Elapsed(flashQQuietStart) >= FLASHQ_QUIET_MS))
+    {
+        status = CySysFlashWriteRow(entry->rowNum, entry->rowData);
+        FlashQ_Complete(status);
+        flashQQuietStart = SysTime_GetMs();
+    }
+    else
+    {
+        /* Wait for the quiet period */
+    }
+#endif /* (FLASHQ_NON_BLOCKING) */
+}
+
+
+/*******************************************************************************
+* Function Name: FlashQ_Flush
+********************************************************************************
+* Summary:
+*  Blocks until all queued rows have been written.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void FlashQ_Flush(void)
+{
+    flashQForce = 1u;
+
+    while (0u != flashQCount)
+    {
+        FlashQ_Process();
+    }
+
+    flashQForce = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: FlashQ_WriteRow
+********************************************************************************
+* Summary:
+*  Writes a row and waits for completion. Replaces CySysFlashWriteRow() for
+*  callers that need the result immediately, keeping the write ordered with
+*  the rows already queued.
+*
+* Parameters:
+*  rowNum - flash row number.
+*  rowData - CY_FLASH_SIZEOF_ROW bytes to write.
+*
+* Return:
+*  CY_SYS_FLASH_x status of the write.
+*
+*******************************************************************************/
+uint32 FlashQ_WriteRow(uint32 rowNum, const uint8 rowData[])
+{
+    FlashQ_Flush();
+
+    (void) FlashQ_Submit(rowNum, rowData, &FlashQ_SyncCallback);
+    FlashQ_Flush();
+
+    return (flashQSyncStatus);
+}
+
+
+/*******************************************************************************
+* Function Name: FlashQ_Complete
+********************************************************************************
+* Summary:
+*  Removes the head entry and reports its status.
+*
+* Parameters:
+*  status - CY_SYS_FLASH_x result of the write.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void FlashQ_Complete(uint32 status)
+{
+    FLASHQ_ENTRY entry = flashQ[flashQHead];
+
+    flashQHead = (flashQHead + 1u) % FLASHQ_DEPTH;
+    --flashQCount;
+
+    if (NULL != entry.callback)
+    {
+        entry.callback(entry.rowNum, status);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: FlashQ_SyncCallback
+********************************************************************************
+* Summary:
+*  Completion callback of FlashQ_WriteRow().
+*
+* Parameters:
+*  rowNum - flash row number.
+*  status - CY_SYS_FLASH_x result of the write.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void FlashQ_SyncCallback(uint32 rowNum, uint32 status)
+{
+    (void) rowNum;
+    flashQSyncStatus = status;
+}
+
+
+/* [] END OF FILE */
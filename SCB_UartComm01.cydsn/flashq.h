@@ -0,0 +1,59 @@
+/*******************************************************************************
+* File Name: flashq.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the background
+*  flash row write queue.
+*
+*******************************************************************************/
+
+#if !defined(CY_FLASHQ_H)
+#define CY_FLASHQ_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Number of row writes that can be queued */
+#define FLASHQ_DEPTH            (4u)
+
+/* Devices without parallel programming commit a row only after the WIFI
+* receiver has been idle for this many milliseconds.
+*/
+#define FLASHQ_QUIET_MS         (5u)
+
+/* Set when the device can program flash while executing from it */
+#define FLASHQ_NON_BLOCKING     (CY_IP_FLASH_PARALLEL_PGM_EN && (CY_IP_FLASH_MACROS > 1u))
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+/* Called from FlashQ_Process() when a row write has finished. status is a
+* CY_SYS_FLASH_x code.
+*/
+typedef void (*flashQCallback)(uint32 rowNum, uint32 status);
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+cystatus FlashQ_Submit(uint32 rowNum, const uint8 rowData[], flashQCallback callback);
+uint32   FlashQ_GetFree(void);
+uint32   FlashQ_GetPending(void);
+void     FlashQ_Process(void);
+void     FlashQ_Flush(void);
+uint32   FlashQ_WriteRow(uint32 rowNum, const uint8 rowData[]);
+
+
+#endif /* (CY_FLASHQ_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,262 @@
+/*******************************************************************************
+* File Name: fmt.c
+*
+* Version: 1.00
+*
+* Description:
+*  Integer formatting into caller buffers without printf, recursion or the
+*  heap. The Cortex-M0 has no divide instruction, so decimal digits are
+*  produced by subtracting powers of ten instead of dividing by 10.
+*
+*  All functions write a zero-terminated string and return its length.
+*  Fields wider than the value are padded with leading zeros.
+*
+*  Fmt_PutDec() prints on the debug UART. It is only built in projects that
+*  have an SCB UART named UART; the RTC_P4 example shares this file with a
+*  different UART.
+*
+*******************************************************************************/
+
+#include <project.h>
+#include <fmt.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+#define FMT_DEC_DIGITS          (10u)
+#define FMT_HEX_DIGITS          (8u)
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static const uint32 fmtPow10[FMT_DEC_DIGITS] =
+{
+    1000000000u, 100000000u, 10000000u, 1000000u, 100000u,
+    10000u, 1000u, 100u, 10u, 1u
+};
+
+static const char fmtHex[] = "0123456789ABCDEF";
+
+
+/*******************************************************************************
+* Function Name: Fmt_Dec
+********************************************************************************
+* Summary:
+*  Formats an unsigned decimal number.
+*
+* Parameters:
+*  buffer - output, at least FMT_UINT32_SIZE bytes.
+*  value - number to format.
+*
+* Return:
+*  Number of characters written, without the terminator.
+*
+*******************************************************************************/
+uint32 Fmt_Dec(char buffer[], uint32 value)
+{
+    return (Fmt_DecPad(buffer, value, 1u));
+}
+
+
+/*******************************************************************************
+* Function Name: Fmt_DecPad
+********************************************************************************
+* Summary:
+*  Formats an unsigned decimal number zero-padded to a minimum width.
+*
+* Parameters:
+*  buffer - output, at least max(width, 10) + 1 bytes.
+*  value - number to format.
+*  width - minimum number of digits.
+*
+* Return:
+*  Number of characters written, without the terminator.
+*
+*******************************************************************************/
+uint32 Fmt_DecPad(char buffer[], uint32 value, uint32 width)
+{
+    uint32 len = 0u;
+    uint32 i;
+    char digit;
+
+    for (; width > FMT_DEC_DIGITS; --width)
+    {
+        buffer[len++] = '0';
+    }
+
+    for (i = 0u; i < FMT_DEC_DIGITS; ++i)
+    {
+        digit = '0';
+        while (value >= fmtPow10[i])
+        {
+            value -= fmtPow10[i];
+            ++digit;
+        }
+
+        /* Skip leading zeros outside the field, keep the last digit */
+        if (('0' != digit) || (0u != len) || ((FMT_DEC_DIGITS - i) <= width) || ((FMT_DEC_DIGITS - 1u) == i))
+        {
+            buffer[len++] = digit;
+        }
+    }
+
+    buffer[len] = 0;
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: Fmt_Hex
+********************************************************************************
+* Summary:
+*  Formats an unsigned number in upper case hex, zero-padded to a minimum
+*  width.
+*
+* Parameters:
+*  buffer - output, at least max(width, 8) + 1 bytes.
+*  value - number to format.
+*  width - minimum number of digits.
+*
+* Return:
+*  Number of characters written, without the terminator.
+*
+*******************************************************************************/
+uint32 Fmt_Hex(char buffer[], uint32 value, uint32 width)
+{
+    uint32 digits = 1u;
+    uint32 len = 0u;
+
+    while ((digits < FMT_HEX_DIGITS) && (0u != (value >> (digits * 4u))))
+    {
+        ++digits;
+    }
+
+    for (; width > digits; --width)
+    {
+        buffer[len++] = '0';
+    }
+
+    while (0u != digits)
+    {
+        --digits;
+        buffer[len++] = fmtHex[(value >> (digits * 4u)) & 0x0Fu];
+    }
+
+    buffer[len] = 0;
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: Fmt_Fixed
+********************************************************************************
+* Summary:
+*  Formats a signed fixed-point number, e.g. value 1250 with 2 decimals is
+*  printed as "12.50" and -5 with 2 decimals as "-0.05".
+*
+* Parameters:
+*  buffer - output, at least FMT_FIXED_SIZE bytes.
+*  value - number in units of 10^-decimals.
+*  decimals - digits after the decimal point, 0 to 9.
+*
+* Return:
+*  Number of characters written, without the terminator.
+*
+*******************************************************************************/
+uint32 Fmt_Fixed(char buffer[], int32 value, uint32 decimals)
+{
+    uint32 magnitude = (uint32) value;
+    uint32 sign = 0u;
+    uint32 len;
+    uint32 i;
+
+    if (value < 0)
+    {
+        buffer[0u] = '-';
+        magnitude = 0u - magnitude;
+        sign = 1u;
+    }
+
+    /* Digits with at least one before the point, then open up the point */
+    len = Fmt_DecPad(&buffer[sign], magnitude, decimals + 1u) + sign;
+
+    if (0u != decimals)
+    {
+        for (i = len; i > (len - decimals); --i)
+        {
+            buffer[i] = buffer[i - 1u];
+        }
+        buffer[len - decimals] = '.';
+        ++len;
+        buffer[len] = 0;
+    }
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: Fmt_Bcd
+********************************************************************************
+* Summary:
+*  Formats the low digits of a packed BCD value, e.g. the RTC_P4 time and
+*  date fields. A nibble above 9 is printed as '?'.
+*
+* Parameters:
+*  buffer - output, at least digits + 1 bytes.
+*  bcd - packed BCD value, least significant digit in bits 3:0.
+*  digits - number of digits to print, 1 to 8.
+*
+* Return:
+*  Number of characters written, without the terminator.
+*
+*******************************************************************************/
+uint32 Fmt_Bcd(char buffer[], uint32 bcd, uint32 digits)
+{
+    uint32 len = 0u;
+    uint32 nibble;
+
+    while (0u != digits)
+    {
+        --digits;
+        nibble = (bcd >> (digits * 4u)) & 0x0Fu;
+        buffer[len++] = (nibble <= 9u) ? (char) ('0' + nibble) : '?';
+    }
+
+    buffer[len] = 0;
+
+    return (len);
+}
+
+
+#if defined(CY_SCB_UART_H)
+/*******************************************************************************
+* Function Name: Fmt_PutDec
+********************************************************************************
+* Summary:
+*  Prints a decimal number on the debug UART.
+*
+* Parameters:
+*  value - value to print.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Fmt_PutDec(uint32 value)
+{
+    char digits[FMT_UINT32_SIZE];
+
+    (void) Fmt_Dec(digits, value);
+    UART_UartPutString(digits);
+}
+#endif /* (CY_SCB_UART_H) */
+
+
+/* [] END OF FILE */
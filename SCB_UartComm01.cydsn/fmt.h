@@ -0,0 +1,44 @@
+/*******************************************************************************
+* File Name: fmt.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides constants and function prototypes for the integer
+*  formatting routines.
+*
+*******************************************************************************/
+
+#if !defined(CY_FMT_H)
+#define CY_FMT_H
+
+#include <cytypes.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Buffer size that holds any uint32 in decimal or hex plus the terminator */
+#define FMT_UINT32_SIZE         (11u)
+
+/* Buffer size that holds any int32 in fixed point plus the terminator */
+#define FMT_FIXED_SIZE          (13u)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+uint32 Fmt_Dec(char buffer[], uint32 value);
+uint32 Fmt_DecPad(char buffer[], uint32 value, uint32 width);
+uint32 Fmt_Hex(char buffer[], uint32 value, uint32 width);
+uint32 Fmt_Fixed(char buffer[], int32 value, uint32 decimals);
+uint32 Fmt_Bcd(char buffer[], uint32 bcd, uint32 digits);
+void   Fmt_PutDec(uint32 value);
+
+
+#endif /* (CY_FMT_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,359 @@
+/*******************************************************************************
+* File Name: ilotrim.c
+*
+* Version: 1.00
+*
+* Description:
+*  Background ILO calibration service. The ILO is measured against SYSCLK
+*  (sourced by the IMO) periodically and on request. On devices with an ILO
+*  trim register the measurement is used to converge the trim with
+*  CySysClkIloTrim(); on other devices only the error is measured. In both
+*  cases the remaining error is published in parts per thousand so that
+*  WDT and ILO based sleep periods can be compensated.
+*
+*******************************************************************************/
+
+#include <ilotrim.h>
+#include <systime.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+/* Devices that have the ILO trim register */
+#define ILOTRIM_HAS_TRIM    (CY_IP_SRSSV2 && (!(CY_PSOC4_4100 || CY_PSOC4_4200)))
+
+/* Measurement window for devices without trim: 1 second worth of ILO cycles */
+#define ILOTRIM_MEASURE_US  (1000000u)
+
+#define ILOTRIM_PPT         (1000)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static cystatus IloTrim_RunStep(int32 *accuracyPpt);
+static void IloTrim_Complete(cystatus status, int32 accuracyPpt);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static uint32 iloTrimState = ILOTRIM_STATE_IDLE;
+static uint32 iloTrimEnabled = 0u;
+static uint32 iloTrimValid = 0u;
+static uint32 iloTrimPeriod = ILOTRIM_PERIOD_MS;
+static uint32 iloTrimLastRun = 0u;
+static uint32 iloTrimRunStart = 0u;
+static volatile uint32 iloTrimPending = 0u;
+static int32 iloTrimAccuracy = 0;
+
+
+/*******************************************************************************
+* Function Name: IloTrim_Start
+********************************************************************************
+* Summary:
+*  Starts the ILO and the measurement counters and schedules the first
+*  calibration run on the next IloTrim_Process() call.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void IloTrim_Start(void)
+{
+    CySysClkIloStart();
+    CySysClkIloStartMeasurement();
+
+    iloTrimState   = ILOTRIM_STATE_IDLE;
+    iloTrimPeriod  = ILOTRIM_PERIOD_MS;
+    iloTrimPending = ILOTRIM_TRIG_WAKEUP;
+    iloTrimEnabled = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: IloTrim_Stop
+********************************************************************************
+* Summary:
+*  Stops the measurement counters. Must be called before entering Deep Sleep.
+*  The last published accuracy stays valid.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void IloTrim_Stop(void)
+{
+    CySysClkIloStopMeasurement();
+
+    iloTrimState   = ILOTRIM_STATE_IDLE;
+    iloTrimEnabled = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: IloTrim_Trigger
+********************************************************************************
+* Summary:
+*  Requests a calibration run as soon as possible. Call it when the die
+*  temperature or the supply voltage has changed, after the system clock has
+*  been changed and after wake up from Deep Sleep. Safe to call from an ISR.
+*
+* Parameters:
+*  reason - one or more of the ILOTRIM_TRIG_* flags.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void IloTrim_Trigger(uint32 reason)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+    iloTrimPending |= reason;
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: IloTrim_Process
+********************************************************************************
+* Summary:
+*  Advances the calibration state machine. Never blocks; call it from the
+*  main loop or from any busy-wait loop.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void IloTrim_Process(void)
+{
+    cystatus status;
+    int32 accuracyPpt;
+    uint32 pending;
+    uint8 interruptState;
+
+    if (0u == iloTrimEnabled)
+    {
+        return;
+    }
+
+    if (ILOTRIM_STATE_IDLE == iloTrimState)
+    {
+        interruptState = CyEnterCriticalSection();
+        pending = iloTrimPending;
+        iloTrimPending = 0u;
+        CyExitCriticalSection(interruptState);
+
+        if ((0u != pending) || (SysTime_Elapsed(iloTrimLastRun) >= iloTrimPeriod))
+        {
+            if (0u != (pending & ILOTRIM_TRIG_CLOCK))
+            {
+                /* Counters are sourced by SYSCLK: reconfigure after a change */
+                CySysClkIloStartMeasurement();
+            }
+
+            iloTrimRunStart = SysTime_GetMs();
+            iloTrimState    = ILOTRIM_STATE_RUNNING;
+        }
+    }
+    else
+    {
+        status = IloTrim_RunStep(&accuracyPpt);
+
+        if (CYRET_STARTED != status)
+        {
+            IloTrim_Complete(status, accuracyPpt);
+        }
+        else if (SysTime_Elapsed(iloTrimRunStart) > ILOTRIM_RUN_TIMEOUT_MS)
+        {
+            IloTrim_Complete(CYRET_TIMEOUT, 0);
+        }
+        else
+        {
+            /* Measurement is in progress */
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: IloTrim_GetState
+********************************************************************************
+* Summary:
+*  Returns the state of the service.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  ILOTRIM_STATE_IDLE or ILOTRIM_STATE_RUNNING.
+*
+*******************************************************************************/
+uint32 IloTrim_GetState(void)
+{
+    return (iloTrimState);
+}
+
+
+/*******************************************************************************
+* Function Name: IloTrim_GetAccuracy
+********************************************************************************
+* Summary:
+*  Returns the ILO error measured by the last successful calibration run.
+*  A positive value means the ILO runs fast.
+*
+* Parameters:
+*  accuracyPpt - pointer to store the error in parts per thousand.
+*
+* Return:
+*  CYRET_SUCCESS if a measurement is available, CYRET_INVALID_STATE otherwise.
+*
+*******************************************************************************/
+cystatus IloTrim_GetAccuracy(int32 *accuracyPpt)
+{
+    cystatus status = CYRET_INVALID_STATE;
+
+    if (0u != iloTrimValid)
+    {
+        *accuracyPpt = iloTrimAccuracy;
+        status = CYRET_SUCCESS;
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: IloTrim_GetIloCycles
+********************************************************************************
+* Summary:
+*  Converts a desired interval to ILO cycles, corrected by the last published
+*  ILO error. Use the result as the WDT match or period value.
+*
+* Parameters:
+*  desiredUs - interval in microseconds, up to 4 000 000 000.
+*
+* Return:
+*  Number of ILO cycles.
+*
+*******************************************************************************/
+uint32 IloTrim_GetIloCycles(uint32 desiredUs)
+{
+    uint32 iloHz = CY_SYS_CLK_ILO_DESIRED_FREQ_HZ;
+
+    if (0u != iloTrimValid)
+    {
+        iloHz = (uint32) ((int32) iloHz + ((((int32) iloHz) * iloTrimAccuracy) / ILOTRIM_PPT));
+    }
+
+    /* 4e9 us at a fast ILO is about 2^47 before the division */
+    return ((uint32) (((uint64) desiredUs * iloHz) / 1000000u));
+}
+
+
+/*******************************************************************************
+* Function Name: IloTrim_RunStep
+********************************************************************************
+* Summary:
+*  Performs one non-blocking step of the measurement.
+*
+* Parameters:
+*  accuracyPpt - pointer to store the measured error when complete.
+*
+* Return:
+*  CYRET_STARTED while in progress, CYRET_SUCCESS when the error has been
+*  measured or an error status.
+*
+*******************************************************************************/
+static cystatus IloTrim_RunStep(int32 *accuracyPpt)
+{
+    cystatus status;
+
+#if (ILOTRIM_HAS_TRIM)
+    /* Returns CYRET_STARTED both while measuring and after the trim register
+    * was adjusted; keep calling until the error is in range.
+    */
+    status = CySysClkIloTrim(CY_SYS_CLK_NON_BLOCKING, accuracyPpt);
+#else
+    uint32 cycles;
+
+    status = CySysClkIloCompensate(ILOTRIM_MEASURE_US, &cycles);
+
+    if (CYRET_SUCCESS == status)
+    {
+        *accuracyPpt = (((int32) cycles - (int32) CY_SYS_CLK_ILO_DESIRED_FREQ_HZ) * ILOTRIM_PPT) /
+                        (int32) CY_SYS_CLK_ILO_DESIRED_FREQ_HZ;
+    }
+#endif /* (ILOTRIM_HAS_TRIM) */
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: IloTrim_Complete
+********************************************************************************
+* Summary:
+*  Publishes the result of a calibration run and schedules the next one. A
+*  shorter period is used while the error keeps changing.
+*
+* Parameters:
+*  status - result of the run.
+*  accuracyPpt - measured error, valid if status is CYRET_SUCCESS.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void IloTrim_Complete(cystatus status, int32 accuracyPpt)
+{
+    int32 drift;
+
+    if (CYRET_SUCCESS == status)
+    {
+        drift = accuracyPpt - iloTrimAccuracy;
+
+        if ((0u == iloTrimValid) || (drift > ILOTRIM_DRIFT_PPT) || (drift < -ILOTRIM_DRIFT_PPT))
+        {
+            iloTrimPeriod = ILOTRIM_FAST_PERIOD_MS;
+        }
+        else
+        {
+            iloTrimPeriod = ILOTRIM_PERIOD_MS;
+        }
+
+        iloTrimAccuracy = accuracyPpt;
+        iloTrimValid    = 1u;
+    }
+    else
+    {
+        /* Keep the previous result and retry soon */
+        iloTrimPeriod = ILOTRIM_FAST_PERIOD_MS;
+
+        if (CYRET_INVALID_STATE == status)
+        {
+            CySysClkIloStartMeasurement();
+        }
+    }
+
+    iloTrimLastRun = SysTime_GetMs();
+    iloTrimState   = ILOTRIM_STATE_IDLE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,61 @@
+/*******************************************************************************
+* File Name: ilotrim.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the background
+*  ILO calibration service.
+*
+*******************************************************************************/
+
+#if !defined(CY_ILOTRIM_H)
+#define CY_ILOTRIM_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Recalibration period while the ILO is stable, in milliseconds */
+#define ILOTRIM_PERIOD_MS           (60000u)
+
+/* Recalibration period after a drift has been detected, in milliseconds */
+#define ILOTRIM_FAST_PERIOD_MS      (5000u)
+
+/* Accuracy change between two runs that is considered a drift, in PPT */
+#define ILOTRIM_DRIFT_PPT           (10)
+
+/* Maximum time one calibration run may take before it is abandoned */
+#define ILOTRIM_RUN_TIMEOUT_MS      (100u)
+
+/* Reasons passed to IloTrim_Trigger() */
+#define ILOTRIM_TRIG_TEMPERATURE    (0x01u)
+#define ILOTRIM_TRIG_VOLTAGE        (0x02u)
+#define ILOTRIM_TRIG_CLOCK          (0x04u)
+#define ILOTRIM_TRIG_WAKEUP         (0x08u)
+
+/* Service states returned by IloTrim_GetState() */
+#define ILOTRIM_STATE_IDLE          (0u)
+#define ILOTRIM_STATE_RUNNING       (1u)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void     IloTrim_Start(void);
+void     IloTrim_Stop(void);
+void     IloTrim_Process(void);
+void     IloTrim_Trigger(uint32 reason);
+uint32   IloTrim_GetState(void);
+cystatus IloTrim_GetAccuracy(int32 *accuracyPpt);
+uint32   IloTrim_GetIloCycles(uint32 desiredUs);
+
+
+#endif /* (CY_ILOTRIM_H) */
+
+
+/* [] END OF FILE */
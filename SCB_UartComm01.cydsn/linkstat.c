@@ -0,0 +1,419 @@
+/*******************************************************************************
+* File Name: linkstat.c
+*
+* Version: 1.00
+*
+* Description:
+*  UART link health counters for the UART and WIFI SCBs.
+*
+*  The SCB reports RX overflow, framing and parity errors as sticky INTR_RX
+*  bits, which WIFI_UartGetChar() clears without reporting them. Those bits
+*  are sampled and cleared here before data is read, so every observed error
+*  condition is counted once. Several errors between two samples count as
+*  one. The RX fill level is sampled at the same time for the high-water mark.
+*
+*  The SCB interrupt entry and exit callbacks (enabled in cyapicallbacks.h)
+*  accumulate the time spent in the handler. The interrupt only runs when
+*  the component is configured with an RX or TX buffer larger than its FIFO;
+*  with the FIFO-only configuration there is no handler and the dump shows
+*  the ISR columns as n/a.
+*
+*******************************************************************************/
+
+#include <linkstat.h>
+#include <systime.h>
+#include <UART_SPI_UART_PVT.h>
+#include <WIFI_SPI_UART_PVT.h>
+#include <fmt.h>
+#include <string.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+/* INTR_RX bits counted as errors; the bit positions are the same for all SCBs */
+#define LINKSTAT_RX_ERRORS      (WIFI_INTR_RX_OVERFLOW | WIFI_INTR_RX_FRAME_ERROR | WIFI_INTR_RX_PARITY_ERROR)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void LinkStat_Count(LINKSTAT_COUNTERS *counters, uint32 errors, uint32 level);
+static void LinkStat_IsrExit(LINKSTAT_COUNTERS *counters, uint32 entry);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static LINKSTAT_COUNTERS linkStat[LINKSTAT_SCBS];
+
+/* Cycle stamp at ISR entry */
+static uint32 linkStatIsrEntry[LINKSTAT_SCBS];
+
+static const char * const linkStatNames[LINKSTAT_SCBS] =
+{
+    "UART",
+    "WIFI",
+};
+
+/* Set for an SCB that has its internal interrupt, in linkStatNames[] order */
+static const uint8 linkStatHasIsr[LINKSTAT_SCBS] =
+{
+    (UART_SCB_IRQ_INTERNAL) ? 1u : 0u,
+    (WIFI_SCB_IRQ_INTERNAL) ? 1u : 0u,
+};
+
+
+/*******************************************************************************
+* Function Name: LinkStat_Reset
+********************************************************************************
+* Summary:
+*  Clears all counters.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void LinkStat_Reset(void)
+{
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+    (void) memset(linkStat, 0, sizeof(linkStat));
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: LinkStat_SampleRx
+********************************************************************************
+* Summary:
+*  Counts and clears the pending RX error conditions of an SCB and updates
+*  its RX high-water mark.
+*
+* Parameters:
+*  scb - LINKSTAT_UART or LINKSTAT_WIFI.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void LinkStat_SampleRx(uint32 scb)
+{
+    uint8 interruptState;
+    uint32 errors;
+
+    interruptState = CyEnterCriticalSection();
+
+    if (LINKSTAT_WIFI == scb)
+    {
+        errors = WIFI_GetRxInterruptSource() & LINKSTAT_RX_ERRORS;
+        WIFI_ClearRxInterruptSource(errors);
+
+    #if (WIFI_INTERNAL_RX_SW_BUFFER_CONST)
+        if (0u != WIFI_rxBufferOverflow)
+        {
+            errors |= WIFI_INTR_RX_OVERFLOW;
+            WIFI_rxBufferOverflow = 0u;
+        }
+    #endif /* (WIFI_INTERNAL_RX_SW_BUFFER_CONST) */
+
+        LinkStat_Count(&linkStat[LINKSTAT_WIFI], errors, WIFI_SpiUartGetRxBufferSize());
+    }
+    else
+    {
+        errors = UART_GetRxInterruptSource() & LINKSTAT_RX_ERRORS;
+        UART_ClearRxInterruptSource(errors);
+
+    #if (UART_INTERNAL_RX_SW_BUFFER_CONST)
+        if (0u != UART_rxBufferOverflow)
+        {
+            errors |= UART_INTR_RX_OVERFLOW;
+            UART_rxBufferOverflow = 0u;
+        }
+    #endif /* (UART_INTERNAL_RX_SW_BUFFER_CONST) */
+
+        LinkStat_Count(&linkStat[LINKSTAT_UART], errors, UART_SpiUartGetRxBufferSize());
+    }
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: LinkStat_NoteTx
+********************************************************************************
+* Summary:
+*  Call before writing a byte to an SCB: counts a TX stall if the write is
+*  going to wait for space in the TX FIFO or buffer.
+*
+* Parameters:
+*  scb - LINKSTAT_UART or LINKSTAT_WIFI.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void LinkStat_NoteTx(uint32 scb)
+{
+    if (LINKSTAT_WIFI == scb)
+    {
+        if (WIFI_SpiUartGetTxBufferSize() >= WIFI_TX_BUFFER_SIZE)
+        {
+            ++linkStat[LINKSTAT_WIFI].txStall;
+        }
+    }
+    else
+    {
+        if (UART_SpiUartGetTxBufferSize() >= UART_TX_BUFFER_SIZE)
+        {
+            ++linkStat[LINKSTAT_UART].txStall;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LinkStat_WifiGetChar
+********************************************************************************
+* Summary:
+*  WIFI_UartGetChar() that counts RX errors before they are cleared.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Received byte, or 0 if none is available or an error occurred.
+*
+*******************************************************************************/
+uint32 LinkStat_WifiGetChar(void)
+{
+    LinkStat_SampleRx(LINKSTAT_WIFI);
+
+    return (WIFI_UartGetChar());
+}
+
+
+/*******************************************************************************
+* Function Name: LinkStat_Get
+********************************************************************************
+* Summary:
+*  Returns the counters of an SCB.
+*
+* Parameters:
+*  scb - LINKSTAT_UART or LINKSTAT_WIFI.
+*
+* Return:
+*  Pointer to the counters, or NULL for an invalid SCB.
+*
+*******************************************************************************/
+const LINKSTAT_COUNTERS * LinkStat_Get(uint32 scb)
+{
+    return ((scb < LINKSTAT_SCBS) ? &linkStat[scb] : NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: LinkStat_Dump
+********************************************************************************
+* Summary:
+*  Prints the counters of both SCBs on the debug UART. The ISR columns of an
+*  SCB without an internal interrupt read n/a.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void LinkStat_Dump(void)
+{
+    const LINKSTAT_COUNTERS *counters;
+    uint32 i;
+
+    UART_UartPutString("\r\nscb: ovf frame parity stall hwm isr isr-cycles isr-max\r\n");
+
+    for (i = 0u; i < LINKSTAT_SCBS; ++i)
+    {
+        counters = &linkStat[i];
+
+        UART_UartPutString(linkStatNames[i]);
+        UART_UartPutString(": ");
+        Fmt_PutDec(counters->rxOverflow);
+        UART_UartPutChar(' ');
+        Fmt_PutDec(counters->rxFrameError);
+        UART_UartPutChar(' ');
+        Fmt_PutDec(counters->rxParityError);
+        UART_UartPutChar(' ');
+        Fmt_PutDec(counters->txStall);
+        UART_UartPutChar(' ');
+        Fmt_PutDec(counters->rxHighWater);
+
+        if (0u != linkStatHasIsr[i])
+        {
+            UART_UartPutChar(' ');
+            Fmt_PutDec(counters->isrCount);
+            UART_UartPutChar(' ');
+            Fmt_PutDec(counters->isrCycles);
+            UART_UartPutChar(' ');
+            Fmt_PutDec(counters->isrMaxCycles);
+        }
+        else
+        {
+            UART_UartPutString(" n/a n/a n/a");
+        }
+        UART_UartPutString("\r\n");
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: WIFI_SPI_UART_ISR_EntryCallback
+********************************************************************************
+* Summary:
+*  WIFI SCB interrupt entry hook: stamps the entry time and samples the RX
+*  state before the handler drains the FIFO.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void WIFI_SPI_UART_ISR_EntryCallback(void)
+{
+    linkStatIsrEntry[LINKSTAT_WIFI] = SysTime_GetCycles();
+    LinkStat_SampleRx(LINKSTAT_WIFI);
+}
+
+
+/*******************************************************************************
+* Function Name: WIFI_SPI_UART_ISR_ExitCallback
+********************************************************************************
+* Summary:
+*  WIFI SCB interrupt exit hook: accumulates the time spent in the handler.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void WIFI_SPI_UART_ISR_ExitCallback(void)
+{
+    LinkStat_IsrExit(&linkStat[LINKSTAT_WIFI], linkStatIsrEntry[LINKSTAT_WIFI]);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SPI_UART_ISR_EntryCallback
+********************************************************************************
+* Summary:
+*  UART SCB interrupt entry hook, see WIFI_SPI_UART_ISR_EntryCallback().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void UART_SPI_UART_ISR_EntryCallback(void)
+{
+    linkStatIsrEntry[LINKSTAT_UART] = SysTime_GetCycles();
+    LinkStat_SampleRx(LINKSTAT_UART);
+}
+
+
+/*******************************************************************************
+* Function Name: UART_SPI_UART_ISR_ExitCallback
+********************************************************************************
+* Summary:
+*  UART SCB interrupt exit hook, see WIFI_SPI_UART_ISR_ExitCallback().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void UART_SPI_UART_ISR_ExitCallback(void)
+{
+    LinkStat_IsrExit(&linkStat[LINKSTAT_UART], linkStatIsrEntry[LINKSTAT_UART]);
+}
+
+
+/*******************************************************************************
+* Function Name: LinkStat_Count
+********************************************************************************
+* Summary:
+*  Adds sampled RX error bits and fill level to the counters.
+*
+* Parameters:
+*  counters - counters of the SCB.
+*  errors - INTR_RX error bits that were set.
+*  level - bytes waiting in the RX FIFO or buffer.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void LinkStat_Count(LINKSTAT_COUNTERS *counters, uint32 errors, uint32 level)
+{
+    if (0u != (errors & WIFI_INTR_RX_OVERFLOW))
+    {
+        ++counters->rxOverflow;
+    }
+    if (0u != (errors & WIFI_INTR_RX_FRAME_ERROR))
+    {
+        ++counters->rxFrameError;
+    }
+    if (0u != (errors & WIFI_INTR_RX_PARITY_ERROR))
+    {
+        ++counters->rxParityError;
+    }
+    if (level > counters->rxHighWater)
+    {
+        counters->rxHighWater = level;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LinkStat_IsrExit
+********************************************************************************
+* Summary:
+*  Adds one handler run to the ISR counters.
+*
+* Parameters:
+*  counters - counters of the SCB.
+*  entry - cycle stamp taken at handler entry.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void LinkStat_IsrExit(LINKSTAT_COUNTERS *counters, uint32 entry)
+{
+    uint32 cycles = SysTime_GetCycles() - entry;
+
+    ++counters->isrCount;
+    counters->isrCycles += cycles;
+    if (cycles > counters->isrMaxCycles)
+    {
+        counters->isrMaxCycles = cycles;
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,60 @@
+/*******************************************************************************
+* File Name: linkstat.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides constants, types and function prototypes for the UART
+*  link health counters of the UART and WIFI SCBs.
+*
+*******************************************************************************/
+
+#if !defined(CY_LINKSTAT_H)
+#define CY_LINKSTAT_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* SCB identifiers */
+#define LINKSTAT_UART           (0u)
+#define LINKSTAT_WIFI           (1u)
+#define LINKSTAT_SCBS           (2u)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+typedef struct
+{
+    uint32 rxOverflow;      /* RX FIFO or software buffer overflows seen */
+    uint32 rxFrameError;
+    uint32 rxParityError;
+    uint32 txStall;         /* Writes that had to wait for TX space */
+    uint32 rxHighWater;     /* Most RX bytes waiting at once */
+    uint32 isrCount;
+    uint32 isrCycles;       /* Total cycles spent in the SCB interrupt */
+    uint32 isrMaxCycles;
+} LINKSTAT_COUNTERS;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void LinkStat_Reset(void);
+void LinkStat_SampleRx(uint32 scb);
+void LinkStat_NoteTx(uint32 scb);
+uint32 LinkStat_WifiGetChar(void);
+const LINKSTAT_COUNTERS * LinkStat_Get(uint32 scb);
+void LinkStat_Dump(void);
+
+
+#endif /* (CY_LINKSTAT_H) */
+
+
+/* [] END OF FILE */
@@ -1,468 +1,249 @@
 #include <project.h>
-/*
-GET /channels/173247(48)(50)(52)/feeds.json?results=2 HTTP/1.1
-Host: api.thingspeak.com
-User-Agent: test
-*/
-int printstopper(char* buff,char success[],char fail[]){
-    uint32 ch=WIFI_UartGetChar();
-    uint32 i=0;
-    uint8 d = '\r';
-    uint8 e = '\n';
-    uint8 s = '\"';
-    int flag=0;
-    int slen = strlen(success);
-    int flen = strlen(fail);
-    int ptr,eptr;
-    while(1){
-        while(ch==0u)ch=WIFI_UartGetChar();
-        while(ch!=0u){
-            buff[i++]=ch;
-            //UART_UartPutChar(ch);
-            ptr=i-slen-1;
-            if((ptr>=0) & (buff[ptr]==e)){
-                ptr++;
-                eptr=ptr+slen;
-                int j=0,flag=1;
-                for(;ptr<eptr;ptr++)
-                    if(buff[ptr]!=success[j++]){
-                        flag=0;
-                        break;
-                    }
-                if(flag){
-                    return i;
-                }
-            }
-            ptr=i-flen-1;
-            if((ptr>=0) & (buff[ptr]==e)){
-                ptr++;
-                eptr=ptr+flen;
-                int j=0,flag=1;
-                for(;ptr<eptr;ptr++)
-                    if(buff[ptr]!=fail[j++]){
-                        flag=0;
-                        break;
-                    }
-                if(flag){
-                    return i;
-                }
-            }
-            ch=WIFI_UartGetChar();
-        }       
-        if(flag)
-            break;
+#include <systime.h>
+#include <ilotrim.h>
+#include <clkgov.h>
+#include <cfgstore.h>
+#include <schedule.h>
+#include <flashq.h>
+#include <ota.h>
+#include <prof.h>
+#include <linkstat.h>
+#include <attrace.h>
+#include <dbglog.h>
+#include <espat.h>
+#include <poller.h>
+#include <doselog.h>
+#include <mqtt.h>
+#include <bridge.h>
+#include <stackmon.h>
+#include <dispense.h>
+//CONFIG LINE ENTRY: ABANDONED AFTER THIS LONG WITHOUT ENTER
+#define CONSOLE_TIMEOUT_MS  (60000u)
+//c<KEY> <VALUE>: ONE KEY DIGIT, THE SPACE, THE LONGEST VALUE AND THE NUL
+#define CONSOLE_LINE_SIZE   (1u+1u+CFGSTORE_DATA_MAX+1u)
+//KEYS THAT HOLD TEXT AND CAN BE SET FROM THE CONSOLE
+#define CONSOLE_KEYS        ((1u<<CFG_KEY_WIFI_SSID)|(1u<<CFG_KEY_WIFI_PASS)|(1u<<CFG_KEY_HOST)|\
+                             (1u<<CFG_KEY_OTA_URL)|(1u<<CFG_KEY_UPLOAD)|(1u<<CFG_KEY_MQTT_BROKER))
+
+//SCHEDULE PUSH: THE CHANNEL INDEX FOLLOWS THE LAST '/', THE PAYLOAD IS A FEED BODY
+#define MQTT_CLIENT_ID      "dispenser"
+#define MQTT_TOPIC_SCHEDULE "dispenser/schedule/+"
+#define MQTT_TOPIC_STATUS   "dispenser/status"
+
+//DEBUG CONSOLE: p = PROFILE, l = LINK COUNTERS, t = AT TRACE, s = STACK/HEAP PEAKS, b = BRIDGE TO ESP8266 (QUIT: PAUSE ~~~ PAUSE)
+//c = CONFIG: c<KEY> <VALUE><ENTER> STORES A TEXT KEY (SEE cfgstore.h), c<KEY><ENTER> CLEARS IT
+//    DOSE UPLOAD: c7 <CHANNEL ID>,<WRITE API KEY>
+static char consolePending='\0';
+
+//RUNS INSIDE EVERY AT WAIT: ONLY THE DUMPS ARE SHORT ENOUGH, THE REST WAITS FOR console_run()
+void debug_poll(void){
+    char c;
+    if(consolePending!='\0')
+        return;
+    c=(char)UART_UartGetChar();
+    switch(c){
+        case 'p':DbgLog_Flush();Prof_Dump();break;
+        case 'l':DbgLog_Flush();LinkStat_Dump();break;
+        case 't':DbgLog_Flush();AtTrace_Dump();break;
+        case 's':DbgLog_Flush();StackMon_Dump();break;
+        case 'b':
+        case 'c':consolePending=c;break;
+        default:break;
     }
-    return i;
 }
-char num2char(int a){
-    switch(a){
-        case 1:return '1';
-        case 2:return '2';
-        case 3:return '3';
-        case 4:return '4';
-        case 5:return '5';
-        case 6:return '6';
-        case 7:return '7';
-        case 8:return '8';
-        case 9:return '9';
-        case 0:return '0';
-        default:return '.';
+
+//READS ONE LINE WITH ECHO, BACKSPACE EDITS; CYRET_MEMORY IF CHARACTERS DID NOT FIT
+cystatus console_line(char line[],uint32 size,uint32 *len){
+    uint32 start=SysTime_GetMs(),full=0u;
+    char c;
+    *len=0u;
+    while(SysTime_Elapsed(start)<CONSOLE_TIMEOUT_MS){
+        c=(char)UART_UartGetChar();
+        if((c=='\r')||(c=='\n')){
+            UART_UartPutString("\r\n");
+            line[*len]='\0';
+            return (full!=0u)?CYRET_MEMORY:CYRET_SUCCESS;
+        }
+        if((c=='\b')&&(*len>0u)){
+            (*len)--;
+            UART_UartPutString("\b \b");
+        }
+        else if((c>=' ')&&(c<='~')){
+            if(*len<(size-1u)){
+                line[(*len)++]=c;
+                UART_UartPutChar(c);
+            }
+            else
+                full=1u;
+        }
     }
+    UART_UartPutString("\r\n");
+    return CYRET_TIMEOUT;
 }
-void printnum(int num){
-    if(num==0){
-        UART_UartPutString("Number:");
+
+//c<KEY> <VALUE>: FLASH WRITES STALL THE CPU, SO ONLY BETWEEN AT EXCHANGES
+void console_config(void){
+    char line[CONSOLE_LINE_SIZE];
+    uint32 len,key=0u,i=0u;
+    cystatus status;
+    DbgLog_Flush();
+    UART_UartPutString("c");
+    status=console_line(line,sizeof(line),&len);
+    if(status==CYRET_MEMORY)
+        UART_UartPutString("too long\r\n");
+    if(status!=CYRET_SUCCESS)
+        return;
+    while((i<len)&&(line[i]>='0')&&(line[i]<='9')&&(key<CFGSTORE_KEY_NUM))
+        key=(key*10u)+(uint32)(line[i++]-'0');
+    if((i==0u)||(key>=CFGSTORE_KEY_NUM)||(((1u<<key)&CONSOLE_KEYS)==0u)||((i<len)&&(line[i]!=' '))){
+        UART_UartPutString("bad key\r\n");
         return;
     }
-    char ch=num2char(num%10);
-    printnum(num/10);
-    UART_UartPutChar(ch);
+    if(i<len)
+        i++;
+    if(CfgStore_Write(key,(const uint8*)&line[i],len-i)==CY_SYS_FLASH_SUCCESS)
+        UART_UartPutString("saved\r\n");
+    else
+        UART_UartPutString("write failed\r\n");
 }
 
-void output(char suc[],char fa[]){
-     char buff[5000];
-     int len=printstopper(buff,suc,fa);
-     int i,j;
-     //printnum(i);
-     for(i=0,j=0;i<len;i++)
-         UART_UartPutChar(buff[i]);
+//CALLED FROM THE TOP LEVEL ONLY, WHEN NO AT EXCHANGE IS IN FLIGHT: THE BRIDGE WOULD TAKE THE ESP8266 FROM UNDER IT
+void console_run(void){
+    char c=consolePending;
+    consolePending='\0';
+    if(c=='c')
+        console_config();
+    else if(c=='b'){
+        DbgLog_Flush();
+        Bridge_Run();
+        Bridge_Dump();
+    }
 }
 
-void buff_print(char buff[],int len){
-    int i;
-    for(i=0;i<len;i++)
-         UART_UartPutChar(buff[i]);
-    UART_UartPutChar('\n');
+//SCHEDULE_SAVE IS LOCKED WHILE A SAVE IS IN FLIGHT: KEEP TRYING UNTIL THE NEWEST SCHEDULE IS QUEUED
+static uint32 scheduleDirty=0u;
+void schedule_save(void){
+    if((scheduleDirty!=0u)&&(Schedule_Save()==CYRET_SUCCESS))
+        scheduleDirty=0u;
 }
 
-int get_field(char json[],int len,char name[],int nlen,char value[]){
-    int i=0,j=0,not_found=0;
-    while(i<len){
-        j=0;
-        //compare field;
-        not_found=0;
-        i++;
-        while(json[i]!='\"'){
-            if(json[i]==name[j]){
-                i++;
-                j++;
-              //  buff_print(name,j);
-                if(j>=nlen){
-                    break;
-                }
-            }else{
-                not_found=1;
-                break;
-            }
-        }
-        if(not_found){
-           while(json[i]!=','&&i<len)i++;
-           //buff_print(json,i);
-           i++;
-        }else{
-            i+=3;
-            int j=0;
-            if(json[i-1]=='n'){
-               i--; 
-               while(json[i]!=',' & i<len)value[j++]=json[i++];
-            }
-            else
-                while(json[i]!='\"' & i<len)value[j++]=json[i++];
-            return j;
+void mqtt_message(const char topic[],uint32 topicLen,const uint8 payload[],uint32 len){
+    uint32 channel=0u,i=topicLen;
+    while((i>0u)&&(topic[i-1u]!='/'))
+        i--;
+    if(i==topicLen)
+        return;
+    for(;i<topicLen;i++){
+        if((topic[i]<'0')||(topic[i]>'9'))
+            return;
+        channel=(channel*10u)+(uint32)(topic[i]-'0');
+    }
+    if(Poller_Apply(channel,(const char*)payload,len)==POLLER_UPDATED){
+        DBGLOG_INFO("Schedule pushed\r\n");
+        scheduleDirty=1u;
+    }
+}
+
+//ONE TCP CONNECTION (CIPMUX=0): POLL WHILE THE BROKER IS UNREACHABLE
+void mqtt_session(void){
+    if(Mqtt_IsConnected()==0u){
+        if(Mqtt_Connect()==CYRET_SUCCESS){
+            (void)Mqtt_Subscribe(MQTT_TOPIC_SCHEDULE);
+            (void)Mqtt_Publish(MQTT_TOPIC_STATUS,(const uint8*)"online",6u);
         }
     }
-    return 0;
+    if(Mqtt_IsConnected()==0u){
+        if(Poller_Process()!=0u)
+            scheduleDirty=1u;
+    }
 }
+
 int main()
 {
-    uint32 ch;
-    uint8 d = '\r';
-    uint8 e = '\n';
-    uint8 s = '\"';
-    int cn1=1,cn2=2,cn3=3,cn4=4;
     UART_Start();
+    DbgLog_Start();
     WIFI_Start();
+    SysTime_Start();
+    StackMon_Start();
+    CyGlobalIntEnable;
+    IloTrim_Start();
+    ClkGov_Start();
+    CfgStore_Init();
+    Esp_SetIdleHook(debug_poll);
+
+    //LAST KNOWN SCHEDULE IS ACTIVE UNTIL THE REFRESH COMPLETES
+    if(Schedule_Load()==CYRET_SUCCESS)
+        DBGLOG_INFO("Cached schedule loaded\r\n");
+    DoseLog_Start();
     
     WIFI_SpiUartClearRxBuffer();
 
     CyDelay(1000);
-    int t;
-    char buff[5000],json[5000];
+    char ssid[33],pass[65];
+    //NO CREDENTIALS IN THE IMAGE: WAIT FOR c1 <SSID> (AND c2 <PASSWORD>) ON THE CONSOLE
+    if(CfgStore_Read(CFG_KEY_WIFI_SSID,(uint8*)ssid,sizeof(ssid))==0u)
+        DBGLOG_ERROR("No WiFi SSID, enter c1 <ssid>\r\n");
+    while(CfgStore_Read(CFG_KEY_WIFI_SSID,(uint8*)ssid,sizeof(ssid))==0u){
+        Esp_Idle();
+        console_run();
+    }
+    (void)CfgStore_Read(CFG_KEY_WIFI_PASS,(uint8*)pass,sizeof(pass));
     
         //CONNECTING TO THE WIFI
-        WIFI_UartPutString("AT+CWJAP=");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutString("Sherlocked");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutChar(',');
-        WIFI_UartPutChar(s);
-        WIFI_UartPutString("iamsherlocked");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        ch=0u;
-        output("OK","ERROR");
+        PROF_BEGIN(PROF_STAGE_JOIN);
+        if(Esp_Join(ssid,pass)!=ESP_TOKEN_SUCCESS)
+            DBGLOG_ERROR("Join failed\r\n");
+        PROF_END(PROF_STAGE_JOIN);
         
         //SETTING CIPMUX=0
-        WIFI_UartPutString("AT+CIPMUX=0");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output("OK","ERROR");
-        
-       
-        //STARTING A TCP CONNECTION WITH THINGSPEAK
-        WIFI_UartPutString("AT+CIPSTART=");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutString("TCP");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutChar(',');
-        WIFI_UartPutChar(s);
-        WIFI_UartPutString("api.thingspeak.com");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutChar(',');
-        WIFI_UartPutString("80");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output("OK","ERROR");
-        
-        //SENDING THE COMMAND LENGTH
-        WIFI_UartPutString("AT+CIPSEND=98");
-           WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output(">","CLOSED");
-               
-        //SENDING THE COMMAND
-        WIFI_UartPutString("GET /channels/173247/feeds.json?results=1 HTTP/1.1");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutString("Host: api.thingspeak.com");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutString("User-Agent: test");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output("SEND OK","CLOSED");
-        CyDelay(50);
-        //output("CLOSED","CLOSED");
-        //PARSING THE PARTICULAR NAME
-         int len=printstopper(buff,"CLOSED","CLOSED");
-        int end;
-        for(end=len-1;end>0;end--){
-            if(buff[end]=='}')
-                break;
-        }
-        end-=2;
-        int start=end-1;
-        while(buff[start]!='{')
-            start--;
-        int i=0;
-        start++;
-        for(;start<end;start++)
-            json[i++]=buff[start];
-            int p;
-       //buff_print(json,i);
-        char time1[10],time2[10],time3[10],dosage1[10],dosage2[10],dosage3[10];
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field1",6,time1);
-        buff_print(time1,p);
-        p=get_field(json,len,"field2",6,dosage1);
-        buff_print(dosage1,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field3",6,time2);
-        buff_print(time2,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field4",6,dosage2);
-        buff_print(dosage2,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field5",6,time3);
-        buff_print(time3,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field6",6,dosage3);
-        buff_print(dosage3,p);
-        
-                
-        
-        
-        
-        
-        //STARTING A TCP CONNECTION WITH THINGSPEAK
-        WIFI_UartPutString("AT+CIPSTART=");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutString("TCP");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutChar(',');
-        WIFI_UartPutChar(s);
-        WIFI_UartPutString("api.thingspeak.com");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutChar(',');
-        WIFI_UartPutString("80");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output("OK","ERROR");
-        
-        //SENDING THE COMMAND LENGTH
-        WIFI_UartPutString("AT+CIPSEND=98");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output(">","CLOSED");
-               
-        //SENDING THE COMMAND
-        WIFI_UartPutString("GET /channels/173248/feeds.json?results=1 HTTP/1.1");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutString("Host: api.thingspeak.com");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutString("User-Agent: test");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output("SEND OK","CLOSED");
-        CyDelay(50);
-
-        //PARSING THE PARTICULAR NAME
-        len=printstopper(buff,"CLOSED","CLOSED");
-        for(end=len-1;end>0;end--){
-            if(buff[end]=='}')
-                break;
-        }
-        end-=2;
-         start=end-1;
-        while(buff[start]!='{')
-            start--;
-         i=0;
-        start++;
-        for(;start<end;start++)
-            json[i++]=buff[start];
-        
-        //buff_print(json,i);
-        char time4[10],time5[10],time6[10],dosage4[10],dosage5[10],dosage6[10];
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field1",6,time4);
-        buff_print(time4,p);
-        p=get_field(json,len,"field2",6,dosage4);
-        buff_print(dosage4,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field3",6,time5);
-        buff_print(time5,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field4",6,dosage5);
-        buff_print(dosage5,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field5",6,time6);
-        buff_print(time6,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field6",6,dosage6);
-        buff_print(dosage6,p);
-        
-                                        
-        
-        
-        
-        //STARTING A TCP CONNECTION WITH THINGSPEAK
-        WIFI_UartPutString("AT+CIPSTART=");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutString("TCP");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutChar(',');
-        WIFI_UartPutChar(s);
-        WIFI_UartPutString("api.thingspeak.com");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutChar(',');
-        WIFI_UartPutString("80");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output("OK","ERROR");
-        
-        //SENDING THE COMMAND LENGTH
-        WIFI_UartPutString("AT+CIPSEND=98");
-           WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output(">","CLOSED");
-               
-        //SENDING THE COMMAND
-        WIFI_UartPutString("GET /channels/173250/feeds.json?results=1 HTTP/1.1");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutString("Host: api.thingspeak.com");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutString("User-Agent: test");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output("SEND OK","CLOSED");
-        CyDelay(50);
-        //output("CLOSED","CLOSED");
-        //PARSING THE PARTICULAR NAME
-         len=printstopper(buff,"CLOSED","CLOSED");
-        
-        for(end=len-1;end>0;end--){
-            if(buff[end]=='}')
-                break;
+        (void)Esp_Command("AT+CIPMUX=0","OK","ERROR",ESP_TIMEOUT_CMD);
+        
+        //FIRST ROUND: EVERY CHANNEL OF THE TABLE IS DUE
+        Poller_Start();
+        if(Poller_Process()!=0u)
+            scheduleDirty=1u;
+        schedule_save();
+        FlashQ_Flush();
+        DbgLog_Flush();
+        Prof_Dump();
+        LinkStat_Dump();
+        
+        //FIRMWARE UPDATE, ONE ATTEMPT PER REQUEST
+        char url[OTA_URL_SIZE];
+        if(CfgStore_Read(CFG_KEY_OTA_URL,(uint8*)url,sizeof(url))!=0u){
+            DBGLOG_INFO("OTA download\r\n");
+            if(Ota_DownloadUrl(url)==CYRET_SUCCESS)
+                DBGLOG_INFO("OTA image verified\r\n");
+            else
+                DBGLOG_ERROR("OTA failed\r\n");
+            (void)CfgStore_Write(CFG_KEY_OTA_URL,(const uint8*)"",0u);
         }
-        end-=2;
-         start=end-1;
-        while(buff[start]!='{')
-            start--;
-        i=0;
-        start++;
-        for(;start<end;start++)
-            json[i++]=buff[start];
-            
-       //buff_print(json,i);
-        char time7[10],time8[10],time9[10],dosage7[10],dosage8[10],dosage9[10];
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field1",6,time7);
-        buff_print(time7,p);
-        p=get_field(json,len,"field2",6,dosage7);
-        buff_print(dosage7,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field3",6,time8);
-        buff_print(time8,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field4",6,dosage8);
-        buff_print(dosage8,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field5",6,time9);
-        buff_print(time9,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field6",6,dosage9);
-        buff_print(dosage9,p);
-                                
-                
-        //STARTING A TCP CONNECTION WITH THINGSPEAK
-        WIFI_UartPutString("AT+CIPSTART=");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutString("TCP");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutChar(',');
-        WIFI_UartPutChar(s);
-        WIFI_UartPutString("api.thingspeak.com");
-        WIFI_UartPutChar(s);
-        WIFI_UartPutChar(',');
-        WIFI_UartPutString("80");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output("OK","ERROR");
         
-        //SENDING THE COMMAND LENGTH
-        WIFI_UartPutString("AT+CIPSEND=98");
-           WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output(">","CLOSED");
-               
-        //SENDING THE COMMAND
-        WIFI_UartPutString("GET /channels/173252/feeds.json?results=1 HTTP/1.1");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutString("Host: api.thingspeak.com");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutString("User-Agent: test");
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        WIFI_UartPutChar(d);
-        WIFI_UartPutChar(e);
-        output("SEND OK","CLOSED");
-        CyDelay(50);
-        //output("CLOSED","CLOSED");
-        //PARSING THE PARTICULAR NAME
-         len=printstopper(buff,"CLOSED","CLOSED");
-        for(end=len-1;end>0;end--){
-            if(buff[end]=='}')
-                break;
+        //SCHEDULE UPDATES ARE PUSHED WHEN A BROKER IS CONFIGURED
+        char broker[MQTT_HOST_SIZE+6u];
+        uint32 push=CfgStore_Read(CFG_KEY_MQTT_BROKER,(uint8*)broker,sizeof(broker));
+        if(push!=0u)
+            Mqtt_Start(broker,MQTT_CLIENT_ID,mqtt_message);
+        
+        //REFRESH EACH CHANNEL WHEN ITS PERIOD HAS ELAPSED
+        for(;;){
+            //DUE DOSES ARE GIVEN AND QUEUED BEFORE THE UPLOAD CHECK
+            Dispense_Process();
+            if(push!=0u){
+                //THE UPLOAD BORROWS THE CONNECTION
+                if(DoseLog_IsDue()!=0u)
+                    Mqtt_Disconnect();
+                DoseLog_Process();
+                mqtt_session();
+                Mqtt_Process();
+            }
+            else{
+                if(Poller_Process()!=0u)
+                    scheduleDirty=1u;
+                DoseLog_Process();
+            }
+            schedule_save();
+            Esp_Idle();
+            console_run();
         }
-        end-=2;
-        start=end-1;
-        while(buff[start]!='{')
-            start--;
-        i=0;
-        start++;
-        for(;start<end;start++)
-            json[i++]=buff[start];
-       //buff_print(json,i);
-        char time10[10],time11[10],time12[10],dosage10[10],dosage11[10],dosage12[10];
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field1",6,time10);
-        buff_print(time10,p);
-        p=get_field(json,len,"field2",6,dosage10);
-        buff_print(dosage10,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field3",6,time11);
-        buff_print(time11,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field4",6,dosage11);
-        buff_print(dosage11,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field5",6,time12);
-        buff_print(time12,p);
-        UART_UartPutChar(e);
-        p=get_field(json,len,"field6",6,dosage12);
-        buff_print(dosage12,p);
-        return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,903 @@
+/*******************************************************************************
+* File Name: mqtt.c
+*
+* Version: 1.00
+*
+* Description:
+*  MQTT 3.1.1 client on the ESP8266 TCP link: CONNECT, SUBSCRIBE, PUBLISH
+*  and PINGREQ at QoS 0. Packets are encoded into and decoded from fixed
+*  buffers; nothing is allocated.
+*
+*  The connection uses the normal receive mode of the ESP8266, so broker
+*  data arrives unsolicited as "+IPD,<n>:<bytes>". Mqtt_Process() strips
+*  that framing, feeds the bytes to the packet decoder and sends a PINGREQ
+*  when the link has been quiet for most of the keepalive period. A missing
+*  PINGRESP or a "CLOSED" from the module marks the connection as down.
+*
+*  Frames that arrive while an AT exchange waits for its result, typically
+*  a CONNACK or PINGRESP ahead of "SEND OK", reach the same framer through
+*  the data sink of the AT link, which is registered for the session.
+*
+*******************************************************************************/
+
+#include <mqtt.h>
+#include <espat.h>
+#include <systime.h>
+#include <dbglog.h>
+#include <string.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+#define MQTT_STATE_DOWN         (0u)
+#define MQTT_STATE_CONNECTING   (1u)
+#define MQTT_STATE_UP           (2u)
+
+/* Decoder states */
+#define MQTT_RX_HEADER          (0u)
+#define MQTT_RX_LENGTH          (1u)
+#define MQTT_RX_BODY            (2u)
+#define MQTT_RX_SKIP            (3u)
+#define MQTT_RX_ERROR           (4u)
+
+/* "+IPD,<n>:" framing states */
+#define MQTT_IPD_SCAN           (0u)
+#define MQTT_IPD_LENGTH         (1u)
+#define MQTT_IPD_DATA           (2u)
+
+/* Keepalive: ping after three quarters of the period without traffic */
+#define MQTT_PING_MS            (((MQTT_KEEPALIVE_S * 1000u) / 4u) * 3u)
+
+/* Fixed header: type byte and up to two length bytes for these sizes */
+#define MQTT_HEADER_MAX         (3u)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static cystatus Mqtt_Transmit(uint32 len);
+static void Mqtt_Close(void);
+static cystatus Mqtt_Await(volatile const uint32 *flag, uint32 pending);
+static void Mqtt_Poll(void);
+static uint32 Mqtt_Sink(uint8 byte);
+static void Mqtt_Frame(uint8 byte);
+static void Mqtt_Dispatch(void);
+static uint32 Mqtt_PutHeader(uint8 buffer[], uint32 type, uint32 remaining);
+static uint32 Mqtt_PutString(uint8 buffer[], const char string[], uint32 len);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static char mqttHost[MQTT_HOST_SIZE];
+static uint32 mqttPort = MQTT_DEFAULT_PORT;
+static const char *mqttClientId;
+static mqttMessageCallback mqttCallback;
+
+static uint32 mqttState = MQTT_STATE_DOWN;
+static uint32 mqttSubAcked;
+static uint32 mqttPingPending;
+static uint32 mqttPacketId = 0u;
+
+static uint32 mqttLastTx;
+static uint32 mqttPingSent;
+static uint32 mqttLastAttempt;
+static uint32 mqttAttempted = 0u;
+
+static uint8 mqttTx[MQTT_TX_SIZE];
+
+/* Packet decoder */
+static uint8 mqttRx[MQTT_RX_SIZE];
+static uint32 mqttRxState = MQTT_RX_HEADER;
+static uint32 mqttRxType;
+static uint32 mqttRxRemaining;
+static uint32 mqttRxShift;
+static uint32 mqttRxFill;
+
+/* ESP8266 framing */
+static uint32 mqttIpdState = MQTT_IPD_SCAN;
+static uint32 mqttIpdMatch;
+static uint32 mqttIpdLen;
+static uint32 mqttClosedMatch;
+
+static const char mqttIpd[] = "+IPD,";
+static const char mqttClosed[] = "CLOSED";
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Start
+********************************************************************************
+* Summary:
+*  Sets the broker and the client identity. Does not connect.
+*
+* Parameters:
+*  broker - "host[:port]"; the port defaults to 1883.
+*  clientId - client identifier, kept by reference.
+*  callback - function for received PUBLISH packets, or NULL.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Mqtt_Start(const char broker[], const char clientId[], mqttMessageCallback callback)
+{
+    uint32 len = 0u;
+
+    while ((0 != broker[len]) && (':' != broker[len]) && (len < (MQTT_HOST_SIZE - 1u)))
+    {
+        mqttHost[len] = broker[len];
+        ++len;
+    }
+    mqttHost[len] = 0;
+
+    mqttPort = MQTT_DEFAULT_PORT;
+    if (':' == broker[len])
+    {
+        mqttPort = 0u;
+        for (++len; (broker[len] >= '0') && (broker[len] <= '9'); ++len)
+        {
+            mqttPort = (mqttPort * 10u) + (uint32) (broker[len] - '0');
+        }
+    }
+
+    mqttClientId  = clientId;
+    mqttCallback  = callback;
+    mqttState     = MQTT_STATE_DOWN;
+    mqttAttempted = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Connect
+********************************************************************************
+* Summary:
+*  Opens the TCP connection, sends CONNECT with a clean session and waits
+*  for CONNACK. Attempts are spaced by MQTT_RETRY_MS.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  CYRET_SUCCESS when connected, CYRET_LOCKED if the last attempt was too
+*  recent, CYRET_BAD_DATA if the broker refused, or the link error.
+*
+*******************************************************************************/
+cystatus Mqtt_Connect(void)
+{
+    cystatus status;
+
+    if (MQTT_STATE_UP == mqttState)
+    {
+        return (CYRET_SUCCESS);
+    }
+
+    if ((0u != mqttAttempted) && (SysTime_Elapsed(mqttLastAttempt) < MQTT_RETRY_MS))
+    {
+        return (CYRET_LOCKED);
+    }
+
+    mqttAttempted   = 1u;
+    mqttLastAttempt = SysTime_GetMs();
+
+    status = Esp_Connect(mqttHost, mqttPort);
+
+    if (ESP_TOKEN_SUCCESS == status)
+    {
+        mqttRxState     = MQTT_RX_HEADER;
+        mqttIpdState    = MQTT_IPD_SCAN;
+        mqttIpdMatch    = 0u;
+        mqttClosedMatch = 0u;
+        mqttPingPending = 0u;
+        mqttState       = MQTT_STATE_CONNECTING;
+        Esp_SetDataSink(Mqtt_Sink);
+
+        status = Mqtt_Transmit(Mqtt_EncodeConnect(mqttTx, mqttClientId, MQTT_KEEPALIVE_S));
+
+        if (CYRET_SUCCESS == status)
+        {
+            status = Mqtt_Await(&mqttState, MQTT_STATE_CONNECTING);
+        }
+
+        if (MQTT_STATE_UP != mqttState)
+        {
+            status = (CYRET_SUCCESS == status) ? CYRET_BAD_DATA : status;
+            Mqtt_Close();
+        }
+    }
+
+    if (CYRET_SUCCESS == status)
+    {
+        DBGLOG_INFO("MQTT connected\r\n");
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Disconnect
+********************************************************************************
+* Summary:
+*  Sends DISCONNECT and closes the TCP connection. Does nothing when not
+*  connected.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Mqtt_Disconnect(void)
+{
+    if (MQTT_STATE_UP == mqttState)
+    {
+        (void) Mqtt_Transmit(Mqtt_PutHeader(mqttTx, MQTT_DISCONNECT, 0u));
+        Mqtt_Close();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_IsConnected
+********************************************************************************
+* Summary:
+*  Reports whether the session is up.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Non-zero if connected.
+*
+*******************************************************************************/
+uint32 Mqtt_IsConnected(void)
+{
+    return ((MQTT_STATE_UP == mqttState) ? 1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Subscribe
+********************************************************************************
+* Summary:
+*  Subscribes to a topic filter at QoS 0 and waits for SUBACK.
+*
+* Parameters:
+*  topic - topic filter, wildcards allowed.
+*
+* Return:
+*  CYRET_SUCCESS, CYRET_INVALID_STATE if not connected, CYRET_BAD_PARAM if
+*  the topic does not fit, or the link error.
+*
+*******************************************************************************/
+cystatus Mqtt_Subscribe(const char topic[])
+{
+    cystatus status = CYRET_INVALID_STATE;
+    uint32 len;
+
+    if (MQTT_STATE_UP == mqttState)
+    {
+        mqttPacketId = (mqttPacketId % 0xFFFFu) + 1u;
+        len = Mqtt_EncodeSubscribe(mqttTx, mqttPacketId, topic);
+        mqttSubAcked = 0u;
+
+        status = (0u != len) ? Mqtt_Transmit(len) : CYRET_BAD_PARAM;
+
+        if (CYRET_SUCCESS == status)
+        {
+            status = Mqtt_Await(&mqttSubAcked, 0u);
+        }
+        else if (CYRET_BAD_PARAM != status)
+        {
+            Mqtt_Close();
+        }
+        else
+        {
+            /* Topic too long; the session is still usable */
+        }
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Publish
+********************************************************************************
+* Summary:
+*  Publishes a message at QoS 0.
+*
+* Parameters:
+*  topic - topic name.
+*  payload - message bytes.
+*  len - message length.
+*
+* Return:
+*  CYRET_SUCCESS, CYRET_INVALID_STATE if not connected, CYRET_BAD_PARAM if
+*  the message does not fit, or the link error.
+*
+*******************************************************************************/
+cystatus Mqtt_Publish(const char topic[], const uint8 payload[], uint32 len)
+{
+    cystatus status = CYRET_INVALID_STATE;
+
+    if (MQTT_STATE_UP == mqttState)
+    {
+        len = Mqtt_EncodePublish(mqttTx, topic, payload, len);
+        status = (0u != len) ? Mqtt_Transmit(len) : CYRET_BAD_PARAM;
+
+        if ((CYRET_SUCCESS != status) && (CYRET_BAD_PARAM != status))
+        {
+            Mqtt_Close();
+        }
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Process
+********************************************************************************
+* Summary:
+*  Handles received data and the keepalive. Call from the main loop.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Mqtt_Process(void)
+{
+    if (MQTT_STATE_DOWN == mqttState)
+    {
+        return;
+    }
+
+    Mqtt_Poll();
+
+    if (MQTT_STATE_UP != mqttState)
+    {
+        /* Closed by the broker */
+    }
+    else if (0u != mqttPingPending)
+    {
+        if (SysTime_Elapsed(mqttPingSent) >= MQTT_TIMEOUT_MS)
+        {
+            DBGLOG_WARN("MQTT keepalive lost\r\n");
+            Mqtt_Close();
+        }
+    }
+    else if (SysTime_Elapsed(mqttLastTx) >= MQTT_PING_MS)
+    {
+        mqttPingPending = 1u;
+        mqttPingSent = SysTime_GetMs();
+
+        if (CYRET_SUCCESS != Mqtt_Transmit(Mqtt_PutHeader(mqttTx, MQTT_PINGREQ, 0u)))
+        {
+            Mqtt_Close();
+        }
+    }
+    else
+    {
+        /* Idle */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_EncodeConnect
+********************************************************************************
+* Summary:
+*  Encodes a CONNECT packet with a clean session and no credentials.
+*
+* Parameters:
+*  buffer - output, MQTT_TX_SIZE bytes.
+*  clientId - client identifier.
+*  keepalive - keepalive in seconds.
+*
+* Return:
+*  Packet length, or 0 if it does not fit.
+*
+*******************************************************************************/
+uint32 Mqtt_EncodeConnect(uint8 buffer[], const char clientId[], uint32 keepalive)
+{
+    static const uint8 header[] = { 0x00u, 0x04u, 'M', 'Q', 'T', 'T', 0x04u, 0x02u };
+    uint32 idLen = strlen(clientId);
+    uint32 len;
+
+    if ((MQTT_HEADER_MAX + sizeof(header) + 4u + idLen) > MQTT_TX_SIZE)
+    {
+        return (0u);
+    }
+
+    len = Mqtt_PutHeader(buffer, MQTT_CONNECT, sizeof(header) + 4u + idLen);
+    (void) memcpy(&buffer[len], header, sizeof(header));
+    len += sizeof(header);
+    buffer[len++] = (uint8) (keepalive >> 8u);
+    buffer[len++] = (uint8) keepalive;
+    len += Mqtt_PutString(&buffer[len], clientId, idLen);
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_EncodeSubscribe
+********************************************************************************
+* Summary:
+*  Encodes a SUBSCRIBE packet for one topic filter at QoS 0.
+*
+* Parameters:
+*  buffer - output, MQTT_TX_SIZE bytes.
+*  packetId - packet identifier, not 0.
+*  topic - topic filter.
+*
+* Return:
+*  Packet length, or 0 if it does not fit.
+*
+*******************************************************************************/
+uint32 Mqtt_EncodeSubscribe(uint8 buffer[], uint32 packetId, const char topic[])
+{
+    uint32 topicLen = strlen(topic);
+    uint32 len;
+
+    if ((MQTT_HEADER_MAX + 5u + topicLen) > MQTT_TX_SIZE)
+    {
+        return (0u);
+    }
+
+    len = Mqtt_PutHeader(buffer, MQTT_SUBSCRIBE, 5u + topicLen);
+    buffer[len++] = (uint8) (packetId >> 8u);
+    buffer[len++] = (uint8) packetId;
+    len += Mqtt_PutString(&buffer[len], topic, topicLen);
+    buffer[len++] = 0u;
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_EncodePublish
+********************************************************************************
+* Summary:
+*  Encodes a PUBLISH packet at QoS 0.
+*
+* Parameters:
+*  buffer - output, MQTT_TX_SIZE bytes.
+*  topic - topic name.
+*  payload - message bytes.
+*  len - message length.
+*
+* Return:
+*  Packet length, or 0 if it does not fit.
+*
+*******************************************************************************/
+uint32 Mqtt_EncodePublish(uint8 buffer[], const char topic[], const uint8 payload[], uint32 len)
+{
+    uint32 topicLen = strlen(topic);
+    uint32 pos;
+
+    if ((MQTT_HEADER_MAX + 2u + topicLen + len) > MQTT_TX_SIZE)
+    {
+        return (0u);
+    }
+
+    pos = Mqtt_PutHeader(buffer, MQTT_PUBLISH, 2u + topicLen + len);
+    pos += Mqtt_PutString(&buffer[pos], topic, topicLen);
+    (void) memcpy(&buffer[pos], payload, len);
+
+    return (pos + len);
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Decode
+********************************************************************************
+* Summary:
+*  Feeds one byte of the broker stream to the packet decoder. Complete
+*  packets are handled immediately; packets larger than MQTT_RX_SIZE are
+*  skipped. A remaining length longer than four bytes is a protocol error:
+*  the rest of the stream is ignored and the next Mqtt_Poll() drops the
+*  connection, as the decoder can run inside an AT exchange.
+*
+* Parameters:
+*  byte - received byte.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Mqtt_Decode(uint8 byte)
+{
+    if (MQTT_RX_HEADER == mqttRxState)
+    {
+        mqttRxType      = byte;
+        mqttRxRemaining = 0u;
+        mqttRxShift     = 0u;
+        mqttRxFill      = 0u;
+        mqttRxState     = MQTT_RX_LENGTH;
+    }
+    else if (MQTT_RX_LENGTH == mqttRxState)
+    {
+        mqttRxRemaining |= ((uint32) byte & 0x7Fu) << mqttRxShift;
+        mqttRxShift += 7u;
+
+        if (0u != (byte & 0x80u))
+        {
+            /* At most four length bytes */
+            mqttRxState = (mqttRxShift < 28u) ? MQTT_RX_LENGTH : MQTT_RX_ERROR;
+        }
+        else if (0u == mqttRxRemaining)
+        {
+            Mqtt_Dispatch();
+            mqttRxState = MQTT_RX_HEADER;
+        }
+        else
+        {
+            mqttRxState = (mqttRxRemaining <= MQTT_RX_SIZE) ? MQTT_RX_BODY : MQTT_RX_SKIP;
+        }
+    }
+    else if (MQTT_RX_BODY == mqttRxState)
+    {
+        mqttRx[mqttRxFill++] = byte;
+
+        if (mqttRxFill == mqttRxRemaining)
+        {
+            Mqtt_Dispatch();
+            mqttRxState = MQTT_RX_HEADER;
+        }
+    }
+    else if (MQTT_RX_SKIP == mqttRxState)
+    {
+        if (0u == --mqttRxRemaining)
+        {
+            mqttRxState = MQTT_RX_HEADER;
+        }
+    }
+    else
+    {
+        /* Protocol error: nothing more is decoded */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Transmit
+********************************************************************************
+* Summary:
+*  Sends the packet in the transmit buffer.
+*
+* Parameters:
+*  len - packet length; 0 is rejected.
+*
+* Return:
+*  CYRET_SUCCESS, CYRET_BAD_PARAM for an empty packet, or the link error.
+*
+*******************************************************************************/
+static cystatus Mqtt_Transmit(uint32 len)
+{
+    cystatus status = CYRET_BAD_PARAM;
+
+    if (0u != len)
+    {
+        status = Esp_Send(mqttTx, len);
+        mqttLastTx = SysTime_GetMs();
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Close
+********************************************************************************
+* Summary:
+*  Closes the TCP connection without a DISCONNECT packet.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Mqtt_Close(void)
+{
+    Esp_SetDataSink(NULL);
+    (void) Esp_Command("AT+CIPCLOSE", "OK", "ERROR", ESP_TIMEOUT_CMD);
+    mqttState = MQTT_STATE_DOWN;
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Await
+********************************************************************************
+* Summary:
+*  Processes received data until a flag set by the decoder leaves its
+*  pending value or MQTT_TIMEOUT_MS elapses. The packet may already have
+*  arrived during the transmission.
+*
+* Parameters:
+*  flag - variable that changes when the expected packet arrives.
+*  pending - value of the flag while the packet is outstanding.
+*
+* Return:
+*  CYRET_SUCCESS or CYRET_TIMEOUT.
+*
+*******************************************************************************/
+static cystatus Mqtt_Await(volatile const uint32 *flag, uint32 pending)
+{
+    uint32 start = SysTime_GetMs();
+
+    while (*flag == pending)
+    {
+        if ((SysTime_Elapsed(start) >= MQTT_TIMEOUT_MS) || (MQTT_STATE_DOWN == mqttState))
+        {
+            return (CYRET_TIMEOUT);
+        }
+
+        Mqtt_Poll();
+    }
+
+    return (CYRET_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Poll
+********************************************************************************
+* Summary:
+*  Reads everything the ESP8266 has sent so far without waiting, and drops
+*  the connection after a protocol error.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Mqtt_Poll(void)
+{
+    uint8 byte;
+
+    while (CYRET_SUCCESS == Esp_ReadByte(&byte, 0u))
+    {
+        Mqtt_Frame(byte);
+    }
+
+    if ((MQTT_RX_ERROR == mqttRxState) && (MQTT_STATE_DOWN != mqttState))
+    {
+        DBGLOG_WARN("MQTT protocol error\r\n");
+
+        if (MQTT_STATE_UP == mqttState)
+        {
+            Mqtt_Disconnect();
+        }
+        else
+        {
+            Mqtt_Close();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Sink
+********************************************************************************
+* Summary:
+*  Data sink of the AT link: passes the bytes received during an AT
+*  exchange to the framer.
+*
+* Parameters:
+*  byte - byte from the ESP8266.
+*
+* Return:
+*  Non-zero if the byte was payload of a "+IPD" frame.
+*
+*******************************************************************************/
+static uint32 Mqtt_Sink(uint8 byte)
+{
+    uint32 payload = (MQTT_IPD_DATA == mqttIpdState) ? 1u : 0u;
+
+    Mqtt_Frame(byte);
+
+    return (payload);
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Frame
+********************************************************************************
+* Summary:
+*  Removes the "+IPD,<n>:" framing of the ESP8266 and passes the payload to
+*  the decoder. Outside of payload data, a "CLOSED" line ends the session.
+*
+* Parameters:
+*  byte - byte from the ESP8266.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Mqtt_Frame(uint8 byte)
+{
+    if (MQTT_IPD_DATA == mqttIpdState)
+    {
+        Mqtt_Decode(byte);
+
+        if (0u == --mqttIpdLen)
+        {
+            mqttIpdState = MQTT_IPD_SCAN;
+        }
+    }
+    else if (MQTT_IPD_LENGTH == mqttIpdState)
+    {
+        if ((byte >= (uint8) '0') && (byte <= (uint8) '9'))
+        {
+            mqttIpdLen = (mqttIpdLen * 10u) + (uint32) (byte - (uint8) '0');
+        }
+        else
+        {
+            mqttIpdState = ((':' == byte) && (0u != mqttIpdLen)) ? MQTT_IPD_DATA : MQTT_IPD_SCAN;
+        }
+    }
+    else
+    {
+        mqttIpdMatch = (byte == (uint8) mqttIpd[mqttIpdMatch]) ? (mqttIpdMatch + 1u) :
+                       (('+' == byte) ? 1u : 0u);
+
+        if ((sizeof(mqttIpd) - 1u) == mqttIpdMatch)
+        {
+            mqttIpdMatch = 0u;
+            mqttIpdLen   = 0u;
+            mqttIpdState = MQTT_IPD_LENGTH;
+        }
+
+        mqttClosedMatch = (byte == (uint8) mqttClosed[mqttClosedMatch]) ? (mqttClosedMatch + 1u) :
+                          (('C' == byte) ? 1u : 0u);
+
+        if ((sizeof(mqttClosed) - 1u) == mqttClosedMatch)
+        {
+            mqttClosedMatch = 0u;
+            mqttState = MQTT_STATE_DOWN;
+            Esp_SetDataSink(NULL);
+            DBGLOG_WARN("MQTT closed by broker\r\n");
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_Dispatch
+********************************************************************************
+* Summary:
+*  Handles a complete received packet.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Mqtt_Dispatch(void)
+{
+    uint32 topicLen;
+    uint32 pos;
+
+    switch (mqttRxType & 0xF0u)
+    {
+        case MQTT_CONNACK:
+            if ((MQTT_STATE_CONNECTING == mqttState) && (2u == mqttRxFill))
+            {
+                /* Return code 0: accepted */
+                mqttState = (0u == mqttRx[1u]) ? MQTT_STATE_UP : MQTT_STATE_DOWN;
+            }
+            break;
+
+        case MQTT_SUBACK:
+            mqttSubAcked = 1u;
+            break;
+
+        case MQTT_PINGRESP:
+            mqttPingPending = 0u;
+            break;
+
+        case MQTT_PUBLISH:
+            if (mqttRxFill >= 2u)
+            {
+                topicLen = ((uint32) mqttRx[0u] << 8u) | mqttRx[1u];
+                pos = 2u + topicLen;
+
+                /* QoS 1 and 2 carry a packet identifier */
+                if (0u != (mqttRxType & 0x06u))
+                {
+                    pos += 2u;
+                }
+
+                if ((pos <= mqttRxFill) && (NULL != mqttCallback))
+                {
+                    mqttCallback((const char *) &mqttRx[2u], topicLen, &mqttRx[pos], mqttRxFill - pos);
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_PutHeader
+********************************************************************************
+* Summary:
+*  Writes the fixed header: packet type and remaining length.
+*
+* Parameters:
+*  buffer - output.
+*  type - first header byte.
+*  remaining - length of the rest of the packet.
+*
+* Return:
+*  Number of bytes written.
+*
+*******************************************************************************/
+static uint32 Mqtt_PutHeader(uint8 buffer[], uint32 type, uint32 remaining)
+{
+    uint32 len = 0u;
+
+    buffer[len++] = (uint8) type;
+
+    do
+    {
+        buffer[len] = (uint8) (remaining & 0x7Fu);
+        remaining >>= 7u;
+
+        if (0u != remaining)
+        {
+            buffer[len] |= 0x80u;
+        }
+        ++len;
+    }
+    while (0u != remaining);
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: Mqtt_PutString
+********************************************************************************
+* Summary:
+*  Writes a length-prefixed MQTT string.
+*
+* Parameters:
+*  buffer - output.
+*  string - characters, not necessarily terminated.
+*  len - number of characters.
+*
+* Return:
+*  Number of bytes written.
+*
+*******************************************************************************/
+static uint32 Mqtt_PutString(uint8 buffer[], const char string[], uint32 len)
+{
+    buffer[0u] = (uint8) (len >> 8u);
+    buffer[1u] = (uint8) len;
+    (void) memcpy(&buffer[2u], string, len);
+
+    return (len + 2u);
+}
+
+
+/* [] END OF FILE */
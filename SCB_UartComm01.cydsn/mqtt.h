@@ -0,0 +1,82 @@
+/*******************************************************************************
+* File Name: mqtt.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the MQTT 3.1.1
+*  client on the ESP8266 TCP link.
+*
+*******************************************************************************/
+
+#if !defined(CY_MQTT_H)
+#define CY_MQTT_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+#define MQTT_DEFAULT_PORT       (1883u)
+#define MQTT_HOST_SIZE          (48u)
+
+/* Keepalive sent in CONNECT; a PINGREQ goes out after this much silence */
+#define MQTT_KEEPALIVE_S        (60u)
+
+/* Time allowed for CONNACK, SUBACK and PINGRESP */
+#define MQTT_TIMEOUT_MS         (5000u)
+
+/* Minimum time between connection attempts */
+#define MQTT_RETRY_MS           (30000u)
+
+/* Largest packet sent or received; bigger received packets are dropped */
+#define MQTT_TX_SIZE            (256u)
+#define MQTT_RX_SIZE            (384u)
+
+/* Packet types, upper nibble of the fixed header */
+#define MQTT_CONNECT            (0x10u)
+#define MQTT_CONNACK            (0x20u)
+#define MQTT_PUBLISH            (0x30u)
+#define MQTT_SUBSCRIBE          (0x82u)
+#define MQTT_SUBACK             (0x90u)
+#define MQTT_PINGREQ            (0xC0u)
+#define MQTT_PINGRESP           (0xD0u)
+#define MQTT_DISCONNECT         (0xE0u)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+/* Called for every received PUBLISH, also from within an AT exchange, so it
+*  must not start one itself. The topic and the payload are not terminated
+*  and are valid only during the call.
+*/
+typedef void (*mqttMessageCallback)(const char topic[], uint32 topicLen,
+                                    const uint8 payload[], uint32 len);
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void     Mqtt_Start(const char broker[], const char clientId[], mqttMessageCallback callback);
+cystatus Mqtt_Connect(void);
+void     Mqtt_Disconnect(void);
+uint32   Mqtt_IsConnected(void);
+cystatus Mqtt_Subscribe(const char topic[]);
+cystatus Mqtt_Publish(const char topic[], const uint8 payload[], uint32 len);
+void     Mqtt_Process(void);
+
+uint32   Mqtt_EncodeConnect(uint8 buffer[], const char clientId[], uint32 keepalive);
+uint32   Mqtt_EncodeSubscribe(uint8 buffer[], uint32 packetId, const char topic[]);
+uint32   Mqtt_EncodePublish(uint8 buffer[], const char topic[], const uint8 payload[], uint32 len);
+void     Mqtt_Decode(uint8 byte);
+
+
+#endif /* (CY_MQTT_H) */
+
+
+/* [] END OF FILE */
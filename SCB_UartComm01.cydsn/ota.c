@@ -0,0 +1,570 @@
+/*******************************************************************************
+* File Name: ota.c
+*
+* Version: 1.00
+*
+* Description:
+*  Over-the-air firmware download. The image (see tools/ota_pack.py) is
+*  fetched over HTTP through the ESP8266 and programmed row by row into a
+*  reserved flash slot.
+*
+*  The ESP8266 is put into passive receive mode (AT+CIPRECVMODE=1) and the
+*  data is pulled one flash row at a time with AT+CIPRECVDATA, so the module
+*  buffers the stream while a row is programmed. Two row buffers are used:
+*  one is filled from the link while the other is being written by the flash
+*  queue. On parts with parallel flash programming the next row is pulled
+*  while the previous one programs; on the other parts the queue is flushed
+*  between pulls, when the link is idle.
+*
+*  After the last row the payload CRC is verified from flash and the image
+*  header is recorded under CFG_KEY_OTA_IMAGE. Switching to the new image is
+*  up to the bootloader, which is not part of this project.
+*
+*******************************************************************************/
+
+#include <ota.h>
+#include <espat.h>
+#include <flashq.h>
+#include <cfgstore.h>
+#include <crc.h>
+#include <systime.h>
+#include <attrace.h>
+#include <string.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+#define OTA_STATE_HEADERS       (0u)
+#define OTA_STATE_BODY          (1u)
+#define OTA_STATE_DONE          (2u)
+#define OTA_STATE_ERROR         (3u)
+
+#define OTA_ROW_BUFFERS         (2u)
+
+/* Bytes handed to Ota_Feed() at once while pulling a chunk */
+#define OTA_FEED_SIZE           (32u)
+
+#define OTA_SLOT_ADDR           ((uint32) otaSlot)
+#define OTA_SLOT_ROW(offset)    ((OTA_SLOT_ADDR + (offset)) / CY_FLASH_SIZEOF_ROW)
+
+#define OTA_DEFAULT_PORT        (80u)
+#define OTA_HOST_SIZE           (48u)
+#define OTA_REQUEST_SIZE        (OTA_URL_SIZE + OTA_HOST_SIZE + 32u)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void Ota_SubmitRow(void);
+static void Ota_RowWritten(uint32 rowNum, uint32 status);
+static cystatus Ota_ReceiveChunk(uint32 *received);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+/* Download slot, accessed only through its address */
+static const uint8 CY_ALIGN(CY_FLASH_SIZEOF_ROW) otaSlot[OTA_SLOT_SIZE] = {0u};
+
+static uint8 otaRow[OTA_ROW_BUFFERS][CY_FLASH_SIZEOF_ROW];
+static volatile uint8 otaRowBusy[OTA_ROW_BUFFERS];
+static volatile uint32 otaWriteError;
+
+static uint32 otaState;
+static uint32 otaRowIdx;        /* Buffer being filled */
+static uint32 otaRowFill;       /* Bytes in that buffer */
+static uint32 otaOffset;        /* File offset of that buffer */
+static uint32 otaExpected;      /* File length, 0 until the header is seen */
+static uint32 otaHttpMatch;     /* Progress through the header terminator */
+
+static const char otaHttpEnd[] = "\r\n\r\n";
+
+
+/*******************************************************************************
+* Function Name: Ota_Begin
+********************************************************************************
+* Summary:
+*  Prepares a new download. The data passed to Ota_Feed() must start with the
+*  HTTP response headers.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Ota_Begin(void)
+{
+    FlashQ_Flush();
+
+    otaState      = OTA_STATE_HEADERS;
+    otaRowIdx     = 0u;
+    otaRowFill    = 0u;
+    otaOffset     = 0u;
+    otaExpected   = 0u;
+    otaHttpMatch  = 0u;
+    otaWriteError = 0u;
+    otaRowBusy[0u] = 0u;
+    otaRowBusy[1u] = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Ota_Feed
+********************************************************************************
+* Summary:
+*  Consumes the next part of the HTTP response. Body bytes are collected into
+*  row buffers and queued for programming as each row completes.
+*
+* Parameters:
+*  data - received bytes.
+*  len - number of bytes.
+*
+* Return:
+*  CYRET_SUCCESS, or CYRET_BAD_DATA if the image header is invalid or the
+*  image does not fit the slot.
+*
+*******************************************************************************/
+cystatus Ota_Feed(const uint8 data[], uint32 len)
+{
+    OTA_HEADER header;
+    uint32 i = 0u;
+    uint32 n;
+
+    while ((i < len) && (otaState < OTA_STATE_DONE))
+    {
+        if (OTA_STATE_HEADERS == otaState)
+        {
+            if (data[i] == (uint8) otaHttpEnd[otaHttpMatch])
+            {
+                ++otaHttpMatch;
+            }
+            else
+            {
+                otaHttpMatch = ('\r' == data[i]) ? 1u : 0u;
+            }
+
+            if (otaHttpMatch == (sizeof(otaHttpEnd) - 1u))
+            {
+                otaState = OTA_STATE_BODY;
+            }
+            ++i;
+            continue;
+        }
+
+        /* Wait until the buffer has been programmed */
+        while (0u != otaRowBusy[otaRowIdx])
+        {
+            FlashQ_Process();
+        }
+
+        n = CY_FLASH_SIZEOF_ROW - otaRowFill;
+        if (n > (len - i))
+        {
+            n = len - i;
+        }
+        if ((0u != otaExpected) && (n > (otaExpected - otaOffset - otaRowFill)))
+        {
+            n = otaExpected - otaOffset - otaRowFill;
+        }
+
+        (void) memcpy(&otaRow[otaRowIdx][otaRowFill], &data[i], n);
+        otaRowFill += n;
+        i += n;
+
+        if ((0u == otaExpected) && (0u == otaOffset) && (otaRowFill >= sizeof(OTA_HEADER)))
+        {
+            (void) memcpy(&header, otaRow[otaRowIdx], sizeof(header));
+
+            if ((OTA_MAGIC != header.magic) || (header.length > (OTA_SLOT_SIZE - sizeof(OTA_HEADER))))
+            {
+                otaState = OTA_STATE_ERROR;
+                break;
+            }
+
+            otaExpected = header.length + sizeof(OTA_HEADER);
+        }
+
+        if ((CY_FLASH_SIZEOF_ROW == otaRowFill) ||
+            ((0u != otaExpected) && ((otaOffset + otaRowFill) == otaExpected)))
+        {
+            Ota_SubmitRow();
+        }
+    }
+
+    return ((OTA_STATE_ERROR == otaState) ? CYRET_BAD_DATA : CYRET_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Ota_IsComplete
+********************************************************************************
+* Summary:
+*  Checks if the whole image has been received.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Non-zero once all image bytes have been queued for programming.
+*
+*******************************************************************************/
+uint32 Ota_IsComplete(void)
+{
+    return ((OTA_STATE_DONE == otaState) ? 1u : 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Ota_Finish
+********************************************************************************
+* Summary:
+*  Waits for the last rows, verifies the image CRC from flash and records the
+*  image as valid.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  CYRET_SUCCESS if the image is complete and valid, CYRET_BAD_DATA otherwise.
+*
+*******************************************************************************/
+cystatus Ota_Finish(void)
+{
+    const OTA_HEADER *header = (const OTA_HEADER *) OTA_SLOT_ADDR;
+    cystatus status = CYRET_BAD_DATA;
+    uint16 crc;
+
+    FlashQ_Flush();
+
+    if ((OTA_STATE_DONE == otaState) && (0u == otaWriteError) && (OTA_MAGIC == header->magic))
+    {
+        crc = Crc16_Update(CRC16_INIT, (const uint8 *) (OTA_SLOT_ADDR + sizeof(OTA_HEADER)), header->length);
+
+        if ((crc == header->crc) &&
+            (CY_SYS_FLASH_SUCCESS == CfgStore_Write(CFG_KEY_OTA_IMAGE, (const uint8 *) header, sizeof(OTA_HEADER))))
+        {
+            status = CYRET_SUCCESS;
+        }
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Ota_Download
+********************************************************************************
+* Summary:
+*  Downloads an image over HTTP into the slot and verifies it. Blocks until
+*  the download is complete, failed or timed out.
+*
+* Parameters:
+*  host - server name or address.
+*  port - TCP port.
+*  path - absolute path of the image on the server.
+*
+* Return:
+*  CYRET_SUCCESS if a valid image was stored, CYRET_TIMEOUT if the server
+*  stopped sending, or another error status.
+*
+*******************************************************************************/
+cystatus Ota_Download(const char host[], uint32 port, const char path[])
+{
+    char request[OTA_REQUEST_SIZE];
+    cystatus status;
+    uint32 received;
+    uint32 lastData;
+
+    if ((strlen(host) >= OTA_HOST_SIZE) || (strlen(path) >= OTA_URL_SIZE))
+    {
+        return (CYRET_BAD_PARAM);
+    }
+
+    Ota_Begin();
+
+    /* HTTP/1.0: the server closes the connection and does not use chunks */
+    (void) strcpy(request, "GET ");
+    (void) strcat(request, path);
+    (void) strcat(request, " HTTP/1.0\r\nHost: ");
+    (void) strcat(request, host);
+    (void) strcat(request, "\r\n\r\n");
+
+    status = Esp_Command("AT+CIPRECVMODE=1", "OK", "ERROR", ESP_TIMEOUT_CMD);
+
+    if (ESP_TOKEN_SUCCESS == status)
+    {
+        status = Esp_Connect(host, port);
+    }
+
+    if (ESP_TOKEN_SUCCESS == status)
+    {
+        status = Esp_Send((const uint8 *) request, strlen(request));
+    }
+
+    lastData = SysTime_GetMs();
+
+    while ((ESP_TOKEN_SUCCESS == status) && (0u == Ota_IsComplete()))
+    {
+        status = Ota_ReceiveChunk(&received);
+
+        if (0u != received)
+        {
+            lastData = SysTime_GetMs();
+
+        #if (!FLASHQ_NON_BLOCKING)
+            /* The module holds further data until asked: program now */
+            FlashQ_Flush();
+        #endif /* (!FLASHQ_NON_BLOCKING) */
+        }
+        else if (SysTime_Elapsed(lastData) > OTA_TIMEOUT_MS)
+        {
+            status = CYRET_TIMEOUT;
+        }
+        else
+        {
+            /* Nothing buffered yet - poll again */
+            status = ESP_TOKEN_SUCCESS;
+        }
+    }
+
+    (void) Esp_Command("AT+CIPCLOSE", "OK", "ERROR", ESP_TIMEOUT_CMD);
+    (void) Esp_Command("AT+CIPRECVMODE=0", "OK", "ERROR", ESP_TIMEOUT_CMD);
+
+    if (ESP_TOKEN_SUCCESS == status)
+    {
+        status = Ota_Finish();
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Ota_DownloadUrl
+********************************************************************************
+* Summary:
+*  Ota_Download() for an URL of the form "host[:port]/path".
+*
+* Parameters:
+*  url - image location, without the "http://" prefix.
+*
+* Return:
+*  See Ota_Download(). CYRET_BAD_PARAM if the URL cannot be parsed.
+*
+*******************************************************************************/
+cystatus Ota_DownloadUrl(const char url[])
+{
+    char host[OTA_HOST_SIZE];
+    const char *path;
+    uint32 port = OTA_DEFAULT_PORT;
+    uint32 len = 0u;
+
+    while ((0 != url[len]) && (':' != url[len]) && ('/' != url[len]))
+    {
+        ++len;
+    }
+
+    path = &url[len];
+
+    if (':' == *path)
+    {
+        port = 0u;
+        for (++path; (*path >= '0') && (*path <= '9'); ++path)
+        {
+            port = (port * 10u) + (uint32) (*path - '0');
+        }
+    }
+
+    if ((0u == len) || (len >= OTA_HOST_SIZE) || ('/' != *path))
+    {
+        return (CYRET_BAD_PARAM);
+    }
+
+    (void) memcpy(host, url, len);
+    host[len] = 0;
+
+    return (Ota_Download(host, port, path));
+}
+
+
+/*******************************************************************************
+* Function Name: Ota_SubmitRow
+********************************************************************************
+* Summary:
+*  Queues the filled row buffer for programming and switches to the other
+*  buffer.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Ota_SubmitRow(void)
+{
+    /* Clear the unused tail of the last row */
+    (void) memset(&otaRow[otaRowIdx][otaRowFill], 0, CY_FLASH_SIZEOF_ROW - otaRowFill);
+
+    while (0u == FlashQ_GetFree())
+    {
+        FlashQ_Process();
+    }
+
+    otaRowBusy[otaRowIdx] = 1u;
+    (void) FlashQ_Submit(OTA_SLOT_ROW(otaOffset), otaRow[otaRowIdx], &Ota_RowWritten);
+
+    otaOffset += CY_FLASH_SIZEOF_ROW;
+    otaRowFill = 0u;
+    otaRowIdx ^= 1u;
+
+    if ((0u != otaExpected) && (otaOffset >= otaExpected))
+    {
+        otaState = OTA_STATE_DONE;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Ota_RowWritten
+********************************************************************************
+* Summary:
+*  Flash queue callback. Releases the row buffer.
+*
+* Parameters:
+*  rowNum - flash row number.
+*  status - CY_SYS_FLASH_x result of the write.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Ota_RowWritten(uint32 rowNum, uint32 status)
+{
+    uint32 offset = (rowNum * CY_FLASH_SIZEOF_ROW) - OTA_SLOT_ADDR;
+
+    if (CY_SYS_FLASH_SUCCESS != status)
+    {
+        otaWriteError = 1u;
+    }
+
+    /* Buffers alternate with every row */
+    otaRowBusy[(offset / CY_FLASH_SIZEOF_ROW) & 1u] = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Ota_ReceiveChunk
+********************************************************************************
+* Summary:
+*  Pulls up to OTA_CHUNK_SIZE bytes from the ESP8266 and feeds them to the
+*  image writer. Accepts both "+CIPRECVDATA,<n>:" and "+CIPRECVDATA:<n>,"
+*  response forms used by different AT firmware versions; the echoed
+*  "AT+CIPRECVDATA=<n>" is skipped.
+*
+* Parameters:
+*  received - pointer to store the number of bytes received.
+*
+* Return:
+*  ESP_TOKEN_SUCCESS, ESP_TOKEN_FAIL, CYRET_TIMEOUT or CYRET_BAD_DATA.
+*
+*******************************************************************************/
+static cystatus Ota_ReceiveChunk(uint32 *received)
+{
+    static const char prefix[] = "+CIPRECVDATA";
+    uint8 feed[OTA_FEED_SIZE];
+    uint32 match = 0u;
+    uint32 lineStart = 1u;
+    uint32 count = 0u;
+    uint32 fill = 0u;
+    uint32 i;
+    cystatus status;
+    uint8 byte;
+
+    *received = 0u;
+
+    AtTrace_Command("AT+CIPRECVDATA", 0u);
+    Esp_PutString("AT+CIPRECVDATA=");
+    Esp_PutNumber(OTA_CHUNK_SIZE);
+    Esp_PutString("\r\n");
+
+    /* Find the response prefix at a line start, so that the echo of the
+    *  command does not match; a bare ERROR means no data is buffered
+    */
+    for (;;)
+    {
+        status = Esp_ReadByte(&byte, ESP_TIMEOUT_CMD);
+
+        if (CYRET_SUCCESS != status)
+        {
+            return (status);
+        }
+
+        if ((sizeof(prefix) - 1u) == match)
+        {
+            if ((',' == byte) || (':' == byte))
+            {
+                break;
+            }
+            match = 0u;
+        }
+        else if (((0u != match) || (0u != lineStart)) && (byte == (uint8) prefix[match]))
+        {
+            ++match;
+        }
+        else if (('E' == byte) && (0u != lineStart))
+        {
+            /* Rest of "ERROR": nothing received yet, *received stays 0 */
+            return (Esp_WaitToken("RROR", NULL, ESP_TIMEOUT_CMD));
+        }
+        else
+        {
+            match = 0u;
+        }
+
+        lineStart = ('\n' == byte) ? 1u : 0u;
+    }
+
+    /* Length and the separator after it */
+    while (CYRET_SUCCESS == status)
+    {
+        status = Esp_ReadByte(&byte, ESP_TIMEOUT_CMD);
+
+        if ((byte < (uint8) '0') || (byte > (uint8) '9'))
+        {
+            break;
+        }
+        count = (count * 10u) + (uint32) (byte - (uint8) '0');
+    }
+
+    for (i = 0u; (CYRET_SUCCESS == status) && (i < count); ++i)
+    {
+        status = Esp_ReadByte(&feed[fill++], ESP_TIMEOUT_CMD);
+
+        if ((OTA_FEED_SIZE == fill) || ((i + 1u) == count))
+        {
+            if (CYRET_SUCCESS != Ota_Feed(feed, fill))
+            {
+                status = CYRET_BAD_DATA;
+            }
+            fill = 0u;
+        }
+    }
+
+    if (CYRET_SUCCESS == status)
+    {
+        *received = count;
+        status = Esp_WaitToken("OK", "ERROR", ESP_TIMEOUT_CMD);
+    }
+
+    return (status);
+}
+
+
+/* [] END OF FILE */
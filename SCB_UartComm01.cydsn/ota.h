@@ -0,0 +1,68 @@
+/*******************************************************************************
+* File Name: ota.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the over-the-air
+*  firmware download into the flash image slot.
+*
+*******************************************************************************/
+
+#if !defined(CY_OTA_H)
+#define CY_OTA_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Size of the download slot, including the image header */
+#define OTA_SLOT_SIZE           (0x8000u)
+
+/* Image header magic: "OTA1" */
+#define OTA_MAGIC               (0x3141544Fu)
+
+/* Bytes pulled from the ESP8266 per AT+CIPRECVDATA: one flash row */
+#define OTA_CHUNK_SIZE          (CY_FLASH_SIZEOF_ROW)
+
+/* Time without new data before the download is abandoned */
+#define OTA_TIMEOUT_MS          (10000u)
+
+/* Longest "host:port/path" accepted by Ota_DownloadUrl() */
+#define OTA_URL_SIZE            (96u)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+/* Header at the start of the image file, see tools/ota_pack.py */
+typedef struct
+{
+    uint32 magic;
+    uint32 length;      /* Payload length, without this header */
+    uint16 crc;         /* CRC-16/CCITT of the payload */
+    uint16 version;
+    uint32 reserved;
+} OTA_HEADER;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void     Ota_Begin(void);
+cystatus Ota_Feed(const uint8 data[], uint32 len);
+uint32   Ota_IsComplete(void);
+cystatus Ota_Finish(void);
+cystatus Ota_Download(const char host[], uint32 port, const char path[]);
+cystatus Ota_DownloadUrl(const char url[]);
+
+
+#endif /* (CY_OTA_H) */
+
+
+/* [] END OF FILE */
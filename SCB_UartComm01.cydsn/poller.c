@@ -0,0 +1,883 @@
+/*******************************************************************************
+* File Name: poller.c
+*
+* Version: 1.00
+*
+* Description:
+*  ThingSpeak channel poller. The channels are described by a constant table:
+*  channel ID, read key, poll period and which field goes to which schedule
+*  slot. Every channel uses the same request template and the same parser,
+*  so adding a channel takes one table entry (and SCHED_CHANNELS).
+*
+*  A poll opens a TCP connection, requests the latest entry and collects the
+*  response until the server closes the connection. The "+IPD,<n>:" frames
+*  are stripped before the HTTP headers are skipped. The request is
+*  HTTP/1.0, so the body is never chunked. With POLLER_USE_CSV the
+*  entry comes from feeds.csv: the header row is read once to map column
+*  positions to fields, and the data row is then split by column index
+*  without any key comparisons. Otherwise feeds/last.json is parsed by key.
+*
+*  The entry_id is checked first: when it matches the one in the schedule,
+*  which survives resets through the flash copy, the rest of the parse and
+*  the schedule update are skipped.
+*
+*******************************************************************************/
+
+#include <poller.h>
+#include <espat.h>
+#include <cfgstore.h>
+#include <clkgov.h>
+#include <systime.h>
+#include <prof.h>
+#include <dbglog.h>
+#include <fmt.h>
+#include <doselog.h>
+#include <string.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+/* Constant parts of the request. Their lengths are known at build time. */
+#define POLLER_REQ_PATH         "GET /channels/"
+#if (POLLER_USE_CSV)
+    #define POLLER_REQ_QUERY    "/feeds.csv?results=1"
+    #define POLLER_REQ_KEY      "&api_key="
+#else
+    #define POLLER_REQ_QUERY    "/feeds/last.json"
+    #define POLLER_REQ_KEY      "?api_key="
+#endif /* (POLLER_USE_CSV) */
+#define POLLER_REQ_HOST         " HTTP/1.0\r\nHost: "
+#define POLLER_REQ_END          "\r\nUser-Agent: test\r\n\r\n"
+
+#define POLLER_LEN(text)        (sizeof(text) - 1u)
+
+/* Longest read key copied into the request */
+#define POLLER_KEY_MAX          (16u)
+
+#define POLLER_REQUEST_FIXED    (POLLER_LEN(POLLER_REQ_PATH) + POLLER_LEN(POLLER_REQ_QUERY) + \
+                                 POLLER_LEN(POLLER_REQ_HOST) + POLLER_LEN(POLLER_REQ_END))
+#define POLLER_REQUEST_SIZE     (POLLER_REQUEST_FIXED + FMT_UINT32_SIZE + \
+                                 POLLER_LEN(POLLER_REQ_KEY) + POLLER_KEY_MAX + POLLER_HOST_SIZE)
+
+/* Request template segments */
+#define POLLER_SEG_TEXT         (0u)
+#define POLLER_SEG_CHANNEL      (1u)
+#define POLLER_SEG_KEY          (2u)
+#define POLLER_SEG_HOST         (3u)
+
+#define POLLER_SEG(text)        { POLLER_SEG_TEXT, POLLER_LEN(text), (text) }
+
+/* CSV column roles; 1 .. POLLER_MAX_FIELDS is a field number */
+#define POLLER_COL_SKIP         (0u)
+#define POLLER_COL_ENTRY_ID     (0xFFu)
+
+/* created_at, entry_id, eight fields and the location and status columns */
+#define POLLER_MAX_COLUMNS      (16u)
+
+#define POLLER_CHANNEL_COUNT    (sizeof(pollerChannel) / sizeof(pollerChannel[0]))
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+typedef struct
+{
+    uint8 kind;             /* POLLER_SEG_xxx */
+    uint8 len;              /* Length of a text segment */
+    const char *text;
+} POLLER_SEGMENT;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static uint32 Poller_BuildRequest(const POLLER_CHANNEL *desc, char request[]);
+static cystatus Poller_Parse(uint32 channel, char response[], uint32 len);
+static uint32 Poller_Unframe(char data[], uint32 len);
+static void Poller_SetSlot(const POLLER_FIELD *map, const char value[], uint32 len);
+static uint32 Poller_Find(const char data[], uint32 len, const char key[]);
+static uint32 Poller_Number(const char data[], uint32 len);
+
+#if (POLLER_USE_CSV)
+    static uint32 Poller_Column(const char data[], uint32 len, uint32 *pos, uint32 *start, uint32 *valueLen);
+#else
+    static uint32 Poller_Value(const char data[], uint32 len, uint32 pos, uint32 *valueLen);
+#endif /* (POLLER_USE_CSV) */
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+/* Channel descriptors, in schedule.entryId[] order */
+static const POLLER_CHANNEL pollerChannel[] =
+{
+    { 173247u, NULL, POLLER_PERIOD_MS, POLLER_PAIRS3(0u * SCHED_SLOTS_PER_CHANNEL) },
+    { 173248u, NULL, POLLER_PERIOD_MS, POLLER_PAIRS3(1u * SCHED_SLOTS_PER_CHANNEL) },
+    { 173250u, NULL, POLLER_PERIOD_MS, POLLER_PAIRS3(2u * SCHED_SLOTS_PER_CHANNEL) },
+    { 173252u, NULL, POLLER_PERIOD_MS, POLLER_PAIRS3(3u * SCHED_SLOTS_PER_CHANNEL) },
+};
+
+/* Every channel needs its entry_id slot in the schedule */
+typedef char pollerTableCheck[(POLLER_CHANNEL_COUNT == SCHED_CHANNELS) ? 1 : -1];
+
+/* GET request for the latest feed entry of a channel */
+static const POLLER_SEGMENT pollerRequest[] =
+{
+    POLLER_SEG(POLLER_REQ_PATH),
+    { POLLER_SEG_CHANNEL, 0u, NULL },
+    POLLER_SEG(POLLER_REQ_QUERY),
+    { POLLER_SEG_KEY, 0u, NULL },
+    POLLER_SEG(POLLER_REQ_HOST),
+    { POLLER_SEG_HOST, 0u, NULL },
+    POLLER_SEG(POLLER_REQ_END),
+};
+
+static char pollerHost[POLLER_HOST_SIZE];
+static uint32 pollerHostLen;
+static char pollerResponse[POLLER_RESPONSE_SIZE];
+
+static uint32 pollerLast[SCHED_CHANNELS];   /* Time of the last poll */
+static uint32 pollerWait[SCHED_CHANNELS];   /* Time to the next poll */
+
+
+/*******************************************************************************
+* Function Name: Poller_Start
+********************************************************************************
+* Summary:
+*  Reads the host from the configuration store and makes every channel due.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Poller_Start(void)
+{
+    uint32 i;
+
+    if (0u == CfgStore_Read(CFG_KEY_HOST, (uint8 *) pollerHost, sizeof(pollerHost)))
+    {
+        (void) strcpy(pollerHost, POLLER_DEFAULT_HOST);
+    }
+
+    pollerHostLen = strlen(pollerHost);
+
+    for (i = 0u; i < POLLER_CHANNEL_COUNT; ++i)
+    {
+        pollerLast[i] = SysTime_GetMs();
+        pollerWait[i] = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Poller_Process
+********************************************************************************
+* Summary:
+*  Polls every channel whose period has elapsed. After a failed poll the
+*  channel is retried after POLLER_RETRY_MS.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of channels whose schedule entries changed.
+*
+*******************************************************************************/
+uint32 Poller_Process(void)
+{
+    uint32 i;
+    uint32 updated = 0u;
+    cystatus status;
+
+    for (i = 0u; i < POLLER_CHANNEL_COUNT; ++i)
+    {
+        if (SysTime_Elapsed(pollerLast[i]) >= pollerWait[i])
+        {
+            pollerLast[i] = SysTime_GetMs();
+
+            status = Poller_Fetch(i);
+
+            if (POLLER_UPDATED == status)
+            {
+                ++updated;
+            }
+
+            pollerWait[i] = ((POLLER_UPDATED == status) || (POLLER_UNCHANGED == status)) ?
+                            pollerChannel[i].periodMs : POLLER_RETRY_MS;
+        }
+    }
+
+    return (updated);
+}
+
+
+/*******************************************************************************
+* Function Name: Poller_Fetch
+********************************************************************************
+* Summary:
+*  Polls one channel and writes its fields to the schedule if the channel
+*  has a new entry.
+*
+* Parameters:
+*  channel - index into the channel table.
+*
+* Return:
+*  POLLER_UPDATED, POLLER_UNCHANGED, CYRET_BAD_PARAM for an unknown
+*  channel, CYRET_BAD_DATA if the response holds no feed entry, or the link
+*  error.
+*
+*******************************************************************************/
+cystatus Poller_Fetch(uint32 channel)
+{
+    char request[POLLER_REQUEST_SIZE];
+    uint32 len;
+    uint32 level;
+    cystatus status;
+
+    if (channel >= POLLER_CHANNEL_COUNT)
+    {
+        return (CYRET_BAD_PARAM);
+    }
+
+    len = Poller_BuildRequest(&pollerChannel[channel], request);
+
+    /* Only waiting for the ESP8266 here: run slow */
+    level = ClkGov_SetLevel(CLKGOV_LEVEL_LOW);
+
+    PROF_BEGIN(PROF_STAGE_CONNECT);
+    status = Esp_Connect(pollerHost, POLLER_PORT);
+    PROF_END(PROF_STAGE_CONNECT);
+
+    if (ESP_TOKEN_SUCCESS == status)
+    {
+        PROF_BEGIN(PROF_STAGE_SEND);
+        status = Esp_Send((const uint8 *) request, len);
+        PROF_END(PROF_STAGE_SEND);
+
+        if (ESP_TOKEN_SUCCESS == status)
+        {
+            PROF_BEGIN(PROF_STAGE_FIRST_BYTE);
+            PROF_BEGIN(PROF_STAGE_LAST_BYTE);
+            status = Esp_Receive((uint8 *) pollerResponse, sizeof(pollerResponse), &len,
+                                 "CLOSED", ESP_TIMEOUT_RECEIVE);
+            PROF_END(PROF_STAGE_LAST_BYTE);
+        }
+
+        if (ESP_TOKEN_SUCCESS == status)
+        {
+            (void) ClkGov_SetLevel(CLKGOV_LEVEL_BURST);
+            PROF_BEGIN(PROF_STAGE_PARSE);
+            status = Poller_Parse(channel, pollerResponse, len);
+            PROF_END(PROF_STAGE_PARSE);
+        }
+        else
+        {
+            /* The server did not close the connection */
+            (void) Esp_Command("AT+CIPCLOSE", "OK", "ERROR", ESP_TIMEOUT_CMD);
+        }
+    }
+
+    (void) ClkGov_SetLevel(level);
+
+    if (POLLER_UNCHANGED == status)
+    {
+        DBGLOG_DEBUG("Channel unchanged\r\n");
+    }
+    else if (POLLER_UPDATED != status)
+    {
+        DBGLOG_ERROR("Channel poll failed\r\n");
+    }
+    else
+    {
+        /* New entry applied */
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Poller_GetChannelCount
+********************************************************************************
+* Summary:
+*  Returns the number of channels in the table.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of channels.
+*
+*******************************************************************************/
+uint32 Poller_GetChannelCount(void)
+{
+    return (POLLER_CHANNEL_COUNT);
+}
+
+
+/*******************************************************************************
+* Function Name: Poller_BuildRequest
+********************************************************************************
+* Summary:
+*  Assembles the request for a channel from the template segments in one
+*  pass. Text segments are copied with their build-time length; only the
+*  channel ID, read key and host are measured here.
+*
+* Parameters:
+*  desc - channel descriptor.
+*  request - buffer of POLLER_REQUEST_SIZE bytes.
+*
+* Return:
+*  Request length in bytes, the exact count for AT+CIPSEND.
+*
+*******************************************************************************/
+static uint32 Poller_BuildRequest(const POLLER_CHANNEL *desc, char request[])
+{
+    const POLLER_SEGMENT *seg;
+    uint32 len = 0u;
+    uint32 i;
+    uint32 j;
+
+    for (i = 0u; i < (sizeof(pollerRequest) / sizeof(pollerRequest[0])); ++i)
+    {
+        seg = &pollerRequest[i];
+
+        if (POLLER_SEG_TEXT == seg->kind)
+        {
+            (void) memcpy(&request[len], seg->text, seg->len);
+            len += seg->len;
+        }
+        else if (POLLER_SEG_CHANNEL == seg->kind)
+        {
+            len += Fmt_Dec(&request[len], desc->channelId);
+        }
+        else if (POLLER_SEG_KEY == seg->kind)
+        {
+            if (NULL != desc->readKey)
+            {
+                (void) memcpy(&request[len], POLLER_REQ_KEY, POLLER_LEN(POLLER_REQ_KEY));
+                len += POLLER_LEN(POLLER_REQ_KEY);
+
+                for (j = 0u; (j < POLLER_KEY_MAX) && (0 != desc->readKey[j]); ++j)
+                {
+                    request[len++] = desc->readKey[j];
+                }
+            }
+        }
+        else
+        {
+            (void) memcpy(&request[len], pollerHost, pollerHostLen);
+            len += pollerHostLen;
+        }
+    }
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: Poller_Parse
+********************************************************************************
+* Summary:
+*  Takes the HTTP response out of what the ESP8266 sent for a poll, sets the
+*  dose log clock from its Date header and applies its body.
+*
+* Parameters:
+*  channel - index into the channel table.
+*  response - received bytes up to the "CLOSED" line; modified in place.
+*  len - number of received bytes.
+*
+* Return:
+*  See Poller_Apply().
+*
+*******************************************************************************/
+static cystatus Poller_Parse(uint32 channel, char response[], uint32 len)
+{
+    uint32 pos;
+
+    len = Poller_Unframe(response, len);
+
+    /* The server time keeps the dose log clock set */
+    pos = Poller_Find(response, len, "\r\nDate: ");
+    DoseLog_SetTimeHttp(&response[pos], len - pos);
+
+    pos = Poller_Find(response, len, "\r\n\r\n");
+
+    return (Poller_Apply(channel, &response[pos], len - pos));
+}
+
+
+/*******************************************************************************
+* Function Name: Poller_Unframe
+********************************************************************************
+* Summary:
+*  Moves the payload of every "+IPD,<n>:" frame to the front of the buffer,
+*  dropping the framing and whatever the ESP8266 sent between the frames.
+*  A frame cut off by the end of the buffer keeps the part that was stored.
+*
+* Parameters:
+*  data - received bytes; overwritten by the joined payload.
+*  len - number of received bytes.
+*
+* Return:
+*  Payload length.
+*
+*******************************************************************************/
+static uint32 Poller_Unframe(char data[], uint32 len)
+{
+    uint32 pos = 0u;
+    uint32 out = 0u;
+    uint32 frame;
+
+    while (pos < len)
+    {
+        pos += Poller_Find(&data[pos], len - pos, "+IPD,");
+
+        if (pos < len)
+        {
+            frame = Poller_Number(&data[pos], len - pos);
+
+            while ((pos < len) && (':' != data[pos]))
+            {
+                ++pos;
+            }
+
+            if (pos < len)
+            {
+                ++pos;
+
+                if (frame > (len - pos))
+                {
+                    frame = len - pos;
+                }
+
+                (void) memmove(&data[out], &data[pos], frame);
+                out += frame;
+                pos += frame;
+            }
+        }
+    }
+
+    return (out);
+}
+
+
+#if (POLLER_USE_CSV)
+
+/*******************************************************************************
+* Function Name: Poller_Apply
+********************************************************************************
+* Summary:
+*  Applies a channel entry in feeds.csv form, as received from ThingSpeak or
+*  pushed over MQTT. The header row assigns a role to every
+*  column position; the data row is then walked column by column. entry_id
+*  precedes the fields, so an unchanged entry is recognised before any field
+*  is looked at. A field that is missing or empty leaves an empty slot;
+*  values longer than a slot are truncated.
+*
+* Parameters:
+*  channel - index into the channel table.
+*  body - response body.
+*  len - body length.
+*
+* Return:
+*  POLLER_UPDATED, POLLER_UNCHANGED, CYRET_BAD_PARAM for an unknown channel,
+*  or CYRET_BAD_DATA if the body holds no feed entry.
+*
+*******************************************************************************/
+cystatus Poller_Apply(uint32 channel, const char body[], uint32 len)
+{
+    const POLLER_CHANNEL *desc = &pollerChannel[channel];
+    uint8 role[POLLER_MAX_COLUMNS];
+    uint16 valuePos[POLLER_MAX_FIELDS + 1u];
+    uint8 valueLen[POLLER_MAX_FIELDS + 1u];
+    uint32 columns = 0u;
+    uint32 more = 1u;
+    uint32 pos;
+    uint32 start;
+    uint32 vlen;
+    uint32 id = 0u;
+    uint32 i;
+
+    if (channel >= POLLER_CHANNEL_COUNT)
+    {
+        return (CYRET_BAD_PARAM);
+    }
+
+    pos = 0u;
+
+    /* Header row: map column positions to roles */
+    while ((0u != more) && (pos < len))
+    {
+        more = Poller_Column(body, len, &pos, &start, &vlen);
+
+        if (columns < POLLER_MAX_COLUMNS)
+        {
+            role[columns] = POLLER_COL_SKIP;
+
+            if ((8u == vlen) && (0 == memcmp(&body[start], "entry_id", 8u)))
+            {
+                role[columns] = POLLER_COL_ENTRY_ID;
+            }
+            else if ((6u == vlen) && (0 == memcmp(&body[start], "field", 5u)) &&
+                     (body[start + 5u] >= '1') && (body[start + 5u] <= (char) ('0' + POLLER_MAX_FIELDS)))
+            {
+                role[columns] = (uint8) (body[start + 5u] - '0');
+            }
+            else
+            {
+                /* Column not used */
+            }
+
+            ++columns;
+        }
+    }
+
+    (void) memset(valueLen, 0, sizeof(valueLen));
+
+    /* Data row: pick the columns by position */
+    more = 1u;
+    for (i = 0u; (0u != more) && (i < columns) && (pos < len); ++i)
+    {
+        more = Poller_Column(body, len, &pos, &start, &vlen);
+
+        if (POLLER_COL_ENTRY_ID == role[i])
+        {
+            id = Poller_Number(&body[start], vlen);
+
+            if (id == schedule.entryId[channel])
+            {
+                return ((0u == id) ? CYRET_BAD_DATA : POLLER_UNCHANGED);
+            }
+        }
+        else if (POLLER_COL_SKIP != role[i])
+        {
+            valuePos[role[i]] = (uint16) start;
+            valueLen[role[i]] = (uint8) ((vlen < SCHED_VALUE_LEN) ? vlen : SCHED_VALUE_LEN);
+        }
+        else
+        {
+            /* Column not used */
+        }
+    }
+
+    if (0u == id)
+    {
+        return (CYRET_BAD_DATA);
+    }
+
+    schedule.entryId[channel] = id;
+
+    DBGLOG_INFO("\n");
+
+    for (i = 0u; i < desc->fieldCount; ++i)
+    {
+        vlen = valueLen[desc->field[i].field];
+        Poller_SetSlot(&desc->field[i], &body[(0u != vlen) ? valuePos[desc->field[i].field] : 0u], vlen);
+    }
+
+    return (POLLER_UPDATED);
+}
+
+#else
+
+/*******************************************************************************
+* Function Name: Poller_Apply
+********************************************************************************
+* Summary:
+*  Applies a channel entry in feeds/last.json form, as received from
+*  ThingSpeak or pushed over MQTT. If the entry_id of the feed object
+*  differs from the one in the schedule, copies the entry_id and mapped
+*  fields to the schedule. A field that is missing or null leaves an empty
+*  slot; values longer than a slot are truncated.
+*
+* Parameters:
+*  channel - index into the channel table.
+*  body - response body.
+*  len - body length.
+*
+* Return:
+*  POLLER_UPDATED, POLLER_UNCHANGED, CYRET_BAD_PARAM for an unknown channel,
+*  or CYRET_BAD_DATA if the body holds no feed entry.
+*
+*******************************************************************************/
+cystatus Poller_Apply(uint32 channel, const char body[], uint32 len)
+{
+    const POLLER_CHANNEL *desc = &pollerChannel[channel];
+    const char *feed;
+    char key[] = "\"field0\":";
+    uint32 feedLen;
+    uint32 pos;
+    uint32 valueLen;
+    uint32 id;
+    uint32 i;
+
+    if (channel >= POLLER_CHANNEL_COUNT)
+    {
+        return (CYRET_BAD_PARAM);
+    }
+
+    /* The body is the feed object itself */
+    if ((0u == len) || ('{' != body[0]))
+    {
+        return (CYRET_BAD_DATA);
+    }
+
+    feed = body;
+
+    /* entry_id comes right after created_at: decide before the fields */
+    pos = Poller_Find(feed, len, "\"entry_id\":");
+    id = Poller_Number(&feed[pos], len - pos);
+
+    if (0u == id)
+    {
+        return (CYRET_BAD_DATA);
+    }
+
+    if (id == schedule.entryId[channel])
+    {
+        return (POLLER_UNCHANGED);
+    }
+
+    for (feedLen = 0u; (feedLen < len) && ('}' != feed[feedLen]); ++feedLen)
+    {
+    }
+
+    if (feedLen >= len)
+    {
+        return (CYRET_BAD_DATA);
+    }
+
+    schedule.entryId[channel] = id;
+
+    DBGLOG_INFO("\n");
+
+    for (i = 0u; i < desc->fieldCount; ++i)
+    {
+        key[6] = (char) ('0' + desc->field[i].field);
+        pos = Poller_Value(feed, feedLen, Poller_Find(feed, feedLen, key), &valueLen);
+        Poller_SetSlot(&desc->field[i], &feed[pos], valueLen);
+    }
+
+    return (POLLER_UPDATED);
+}
+
+#endif /* (POLLER_USE_CSV) */
+
+
+/*******************************************************************************
+* Function Name: Poller_SetSlot
+********************************************************************************
+* Summary:
+*  Copies a field value into its schedule slot, truncated to the slot size.
+*
+* Parameters:
+*  map - field mapping.
+*  value - value text, not terminated.
+*  len - value length.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Poller_SetSlot(const POLLER_FIELD *map, const char value[], uint32 len)
+{
+    char *slot = (POLLER_MEMBER_TIME == map->member) ?
+                 schedule.entry[map->entry].time : schedule.entry[map->entry].dosage;
+
+    if (len >= SCHED_VALUE_LEN)
+    {
+        len = SCHED_VALUE_LEN - 1u;
+    }
+
+    (void) memcpy(slot, value, len);
+    slot[len] = 0;
+
+    DBGLOG_INFO_DATA(slot, len);
+    DBGLOG_INFO("\n");
+}
+
+
+/*******************************************************************************
+* Function Name: Poller_Find
+********************************************************************************
+* Summary:
+*  Searches a block of text for a key.
+*
+* Parameters:
+*  data - text to search, not terminated.
+*  len - text length.
+*  key - zero-terminated key.
+*
+* Return:
+*  Position just after the first match, or len if the key is not found.
+*
+*******************************************************************************/
+static uint32 Poller_Find(const char data[], uint32 len, const char key[])
+{
+    uint32 keyLen = strlen(key);
+    uint32 i;
+
+    for (i = 0u; (i + keyLen) <= len; ++i)
+    {
+        if (0 == memcmp(&data[i], key, keyLen))
+        {
+            return (i + keyLen);
+        }
+    }
+
+    return (len);
+}
+
+
+/*******************************************************************************
+* Function Name: Poller_Number
+********************************************************************************
+* Summary:
+*  Reads the decimal number at the start of a text.
+*
+* Parameters:
+*  data - text, not terminated.
+*  len - text length.
+*
+* Return:
+*  Value of the leading digits, 0 if there are none.
+*
+*******************************************************************************/
+static uint32 Poller_Number(const char data[], uint32 len)
+{
+    uint32 value = 0u;
+    uint32 i;
+
+    for (i = 0u; (i < len) && (data[i] >= '0') && (data[i] <= '9'); ++i)
+    {
+        value = (value * 10u) + (uint32) (data[i] - '0');
+    }
+
+    return (value);
+}
+
+
+#if (POLLER_USE_CSV)
+
+/*******************************************************************************
+* Function Name: Poller_Column
+********************************************************************************
+* Summary:
+*  Steps over one CSV column. A quoted value ends at the closing quote.
+*
+* Parameters:
+*  data - CSV text, not terminated.
+*  len - text length.
+*  pos - position of the column; advanced to the next column, or past the
+*        line end after the last column of a row.
+*  start - pointer to store the position of the value, quotes excluded.
+*  valueLen - pointer to store the value length.
+*
+* Return:
+*  Non-zero if another column follows in the same row.
+*
+*******************************************************************************/
+static uint32 Poller_Column(const char data[], uint32 len, uint32 *pos, uint32 *start, uint32 *valueLen)
+{
+    uint32 i = *pos;
+    uint32 more;
+
+    if ((i < len) && ('"' == data[i]))
+    {
+        *start = ++i;
+        while ((i < len) && ('"' != data[i]))
+        {
+            ++i;
+        }
+        *valueLen = i - *start;
+        i = (i < len) ? (i + 1u) : i;
+    }
+    else
+    {
+        *start = i;
+        while ((i < len) && (',' != data[i]) && ('\r' != data[i]) && ('\n' != data[i]))
+        {
+            ++i;
+        }
+        *valueLen = i - *start;
+    }
+
+    more = ((i < len) && (',' == data[i])) ? 1u : 0u;
+
+    if (0u != more)
+    {
+        ++i;
+    }
+    else
+    {
+        while ((i < len) && ('\n' != data[i]))
+        {
+            ++i;
+        }
+        i = (i < len) ? (i + 1u) : i;
+    }
+
+    *pos = i;
+
+    return (more);
+}
+
+#else
+
+/*******************************************************************************
+* Function Name: Poller_Value
+********************************************************************************
+* Summary:
+*  Locates a JSON value: the text of a string without its quotes, or a
+*  number. null gives an empty value.
+*
+* Parameters:
+*  data - JSON text, not terminated.
+*  len - text length.
+*  pos - position of the value, len if the key was not found.
+*  valueLen - pointer to store the value length.
+*
+* Return:
+*  Position of the first character of the value.
+*
+*******************************************************************************/
+static uint32 Poller_Value(const char data[], uint32 len, uint32 pos, uint32 *valueLen)
+{
+    uint32 end;
+
+    if ((pos < len) && ('"' == data[pos]))
+    {
+        ++pos;
+        for (end = pos; (end < len) && ('"' != data[end]); ++end)
+        {
+        }
+    }
+    else if ((pos < len) && ('n' == data[pos]))
+    {
+        end = pos;
+    }
+    else
+    {
+        for (end = pos; (end < len) && (',' != data[end]) && ('}' != data[end]); ++end)
+        {
+        }
+    }
+
+    *valueLen = end - pos;
+
+    return (pos);
+}
+
+#endif /* (POLLER_USE_CSV) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/*******************************************************************************
+* File Name: poller.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes, constants and the channel
+*  descriptor type for the ThingSpeak channel poller.
+*
+*******************************************************************************/
+
+#if !defined(CY_POLLER_H)
+#define CY_POLLER_H
+
+#include <project.h>
+#include <schedule.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Response format: 1 fetches feeds.csv, 0 fetches feeds/last.json */
+#if !defined(POLLER_USE_CSV)
+    #define POLLER_USE_CSV      (1u)
+#endif /* !defined(POLLER_USE_CSV) */
+
+/* Used until the configuration store holds a host */
+#define POLLER_DEFAULT_HOST     "api.thingspeak.com"
+#define POLLER_PORT             (80u)
+#define POLLER_HOST_SIZE        (48u)
+
+/* ThingSpeak channels have up to eight fields */
+#define POLLER_MAX_FIELDS       (8u)
+
+/* Poll period of the channels, and retry delay after a failed poll */
+#define POLLER_PERIOD_MS        (60000u)
+#define POLLER_RETRY_MS         (15000u)
+
+/* Largest HTTP response kept for parsing, headers included */
+#define POLLER_RESPONSE_SIZE    (2048u)
+
+/* Poller_Fetch() results besides the link and parse errors */
+#define POLLER_UPDATED          (CYRET_SUCCESS)
+#define POLLER_UNCHANGED        (CYRET_FINISHED)
+
+/* Schedule slot member a field is written to */
+#define POLLER_MEMBER_TIME      (0u)
+#define POLLER_MEMBER_DOSAGE    (1u)
+
+/* Standard mapping: field1..field6 hold three time/dosage pairs that go to
+*  the schedule entries starting at "first".
+*/
+#define POLLER_PAIRS3(first)    6u, \
+    { \
+        { 1u, (uint8) ((first) + 0u), POLLER_MEMBER_TIME   }, \
+        { 2u, (uint8) ((first) + 0u), POLLER_MEMBER_DOSAGE }, \
+        { 3u, (uint8) ((first) + 1u), POLLER_MEMBER_TIME   }, \
+        { 4u, (uint8) ((first) + 1u), POLLER_MEMBER_DOSAGE }, \
+        { 5u, (uint8) ((first) + 2u), POLLER_MEMBER_TIME   }, \
+        { 6u, (uint8) ((first) + 2u), POLLER_MEMBER_DOSAGE }  \
+    }
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+/* One ThingSpeak field and the schedule slot it is written to */
+typedef struct
+{
+    uint8 field;        /* 1 .. POLLER_MAX_FIELDS */
+    uint8 entry;        /* Index into schedule.entry[] */
+    uint8 member;       /* POLLER_MEMBER_TIME or POLLER_MEMBER_DOSAGE */
+} POLLER_FIELD;
+
+/* Channel descriptor. The position in the table is the index into
+*  schedule.entryId[].
+*/
+typedef struct
+{
+    uint32 channelId;
+    const char *readKey;        /* NULL for a public channel */
+    uint32 periodMs;
+    uint8 fieldCount;
+    POLLER_FIELD field[POLLER_MAX_FIELDS];
+} POLLER_CHANNEL;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void     Poller_Start(void);
+uint32   Poller_Process(void);
+cystatus Poller_Fetch(uint32 channel);
+cystatus Poller_Apply(uint32 channel, const char body[], uint32 len);
+uint32   Poller_GetChannelCount(void);
+
+
+#endif /* (CY_POLLER_H) */
+
+
+/* [] END OF FILE */
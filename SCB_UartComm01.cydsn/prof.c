@@ -0,0 +1,206 @@
+/*******************************************************************************
+* File Name: prof.c
+*
+* Version: 1.00
+*
+* Description:
+*  Phase profiler for the refresh cycle. PROF_BEGIN() stamps the SysTick
+*  based cycle counter, PROF_END() adds the span to the per-stage minimum,
+*  maximum, sum and log2 histogram. The statistics stay in RAM and are
+*  printed on the debug UART by Prof_Dump().
+*
+*  A stage that has not been started is ignored by PROF_END(), so an end
+*  probe can sit in shared code (e.g. the first received byte) and only
+*  counts while its stage is armed.
+*
+*******************************************************************************/
+
+#include <prof.h>
+#include <fmt.h>
+#include <string.h>
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+/* Start stamps; bit 0 is forced set so that 0 means "not started" */
+uint32 profStart[PROF_STAGES];
+
+static PROF_STAGE_STATS profStats[PROF_STAGES];
+
+static const char * const profNames[PROF_STAGES] =
+{
+    "join",
+    "connect",
+    "send",
+    "first byte",
+    "last byte",
+    "parse",
+};
+
+
+/*******************************************************************************
+* Function Name: Prof_Reset
+********************************************************************************
+* Summary:
+*  Clears all statistics and disarms all stages.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Prof_Reset(void)
+{
+    uint32 i;
+
+    for (i = 0u; i < PROF_STAGES; ++i)
+    {
+        profStart[i] = 0u;
+        (void) memset(&profStats[i], 0, sizeof(profStats[i]));
+        profStats[i].min = 0xFFFFFFFFu;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Prof_End
+********************************************************************************
+* Summary:
+*  Ends a stage started with PROF_BEGIN() and records its duration. Use the
+*  PROF_END() macro so that the call compiles out with PROF_ENABLED.
+*
+* Parameters:
+*  stage - PROF_STAGE_x identifier.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Prof_End(uint32 stage)
+{
+    PROF_STAGE_STATS *stats;
+    uint32 cycles;
+    uint32 bucket = 0u;
+    uint32 shift;
+
+    if ((stage >= PROF_STAGES) || (0u == profStart[stage]))
+    {
+        return;
+    }
+
+    cycles = SysTime_GetCycles() - profStart[stage];
+    profStart[stage] = 0u;
+
+    stats = &profStats[stage];
+    if (0u == stats->count)
+    {
+        /* First sample since power up */
+        stats->min = 0xFFFFFFFFu;
+    }
+
+    ++stats->count;
+    stats->sum += cycles;
+    if (cycles < stats->min)
+    {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+
+    /* Index of the highest set bit; the M0 has no CLZ */
+    for (shift = 16u; 0u != shift; shift >>= 1u)
+    {
+        if (0u != (cycles >> (bucket + shift)))
+        {
+            bucket += shift;
+        }
+    }
+
+    if (stats->hist[bucket] < 0xFFFFu)
+    {
+        ++stats->hist[bucket];
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Prof_GetStats
+********************************************************************************
+* Summary:
+*  Returns the statistics of one stage.
+*
+* Parameters:
+*  stage - PROF_STAGE_x identifier.
+*
+* Return:
+*  Pointer to the statistics, or NULL for an invalid stage.
+*
+*******************************************************************************/
+const PROF_STAGE_STATS * Prof_GetStats(uint32 stage)
+{
+    return ((stage < PROF_STAGES) ? &profStats[stage] : NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: Prof_Dump
+********************************************************************************
+* Summary:
+*  Prints count, min, max and mean cycles and the non-empty histogram
+*  buckets of every stage on the debug UART. Blocks until queued.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Prof_Dump(void)
+{
+    const PROF_STAGE_STATS *stats;
+    uint32 i;
+    uint32 j;
+
+    UART_UartPutString("\r\nstage: n min max mean [cycles]\r\n");
+
+    for (i = 0u; i < PROF_STAGES; ++i)
+    {
+        stats = &profStats[i];
+
+        UART_UartPutString(profNames[i]);
+        UART_UartPutString(": ");
+        Fmt_PutDec(stats->count);
+
+        if (0u != stats->count)
+        {
+            UART_UartPutChar(' ');
+            Fmt_PutDec(stats->min);
+            UART_UartPutChar(' ');
+            Fmt_PutDec(stats->max);
+            UART_UartPutChar(' ');
+            Fmt_PutDec((uint32) (stats->sum / stats->count));
+
+            for (j = 0u; j < PROF_BUCKETS; ++j)
+            {
+                if (0u != stats->hist[j])
+                {
+                    UART_UartPutString("\r\n  2^");
+                    Fmt_PutDec(j);
+                    UART_UartPutString(": ");
+                    Fmt_PutDec(stats->hist[j]);
+                }
+            }
+        }
+        UART_UartPutString("\r\n");
+    }
+}
+
+
+/* [] END OF FILE */
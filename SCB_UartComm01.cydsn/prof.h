@@ -0,0 +1,84 @@
+/*******************************************************************************
+* File Name: prof.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides the probe macros, stage identifiers and function
+*  prototypes for the refresh cycle phase profiler.
+*
+*******************************************************************************/
+
+#if !defined(CY_PROF_H)
+#define CY_PROF_H
+
+#include <project.h>
+#include <systime.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Set to 0 to compile all probes out */
+#if !defined(PROF_ENABLED)
+    #define PROF_ENABLED        (1u)
+#endif /* !defined(PROF_ENABLED) */
+
+/* Profiled stages of the refresh cycle */
+#define PROF_STAGE_JOIN         (0u)    /* AT+CWJAP until OK */
+#define PROF_STAGE_CONNECT      (1u)    /* AT+CIPSTART until OK */
+#define PROF_STAGE_SEND         (2u)    /* AT+CIPSEND until SEND OK */
+#define PROF_STAGE_FIRST_BYTE   (3u)    /* SEND OK until first response byte */
+#define PROF_STAGE_LAST_BYTE    (4u)    /* SEND OK until connection closed */
+#define PROF_STAGE_PARSE        (5u)    /* Response parsing */
+#define PROF_STAGES             (6u)
+
+/* One histogram bucket per power of two of cycles */
+#define PROF_BUCKETS            (32u)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+typedef struct
+{
+    uint32 count;
+    uint32 min;
+    uint32 max;
+    uint64 sum;
+    uint16 hist[PROF_BUCKETS];  /* hist[n]: 2^n <= cycles < 2^(n+1) */
+} PROF_STAGE_STATS;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void Prof_Reset(void);
+void Prof_End(uint32 stage);
+const PROF_STAGE_STATS * Prof_GetStats(uint32 stage);
+void Prof_Dump(void);
+
+
+/***************************************
+*          Probe Macros
+****************************************/
+
+#if (PROF_ENABLED)
+    extern uint32 profStart[PROF_STAGES];
+
+    /* Stamp the start of a stage; PROF_END() records the span */
+    #define PROF_BEGIN(stage)   do { profStart[(stage)] = SysTime_GetCycles() | 1u; } while (0)
+    #define PROF_END(stage)     Prof_End(stage)
+#else
+    #define PROF_BEGIN(stage)   do { } while (0)
+    #define PROF_END(stage)     do { } while (0)
+#endif /* (PROF_ENABLED) */
+
+
+#endif /* (CY_PROF_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,241 @@
+/*******************************************************************************
+* File Name: schedule.c
+*
+* Version: 1.00
+*
+* Description:
+*  The active dose schedule and its flash copy. Two copies are kept in a
+*  reserved, row aligned region and written alternately, so a reset during
+*  a write always leaves the previous schedule intact. At boot the newest
+*  copy with a valid CRC becomes active before the network is touched.
+*
+*******************************************************************************/
+
+#include <schedule.h>
+#include <crc.h>
+#include <flashq.h>
+#include <string.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+#define SCHED_COPIES            (2u)
+#define SCHED_SEQ_ERASED        (0u)
+
+/* Flash rows taken by one copy of the schedule */
+#define SCHED_ROWS              ((sizeof(SCHEDULE_IMAGE) + CY_FLASH_SIZEOF_ROW - 1u) / CY_FLASH_SIZEOF_ROW)
+
+#define SCHED_COPY_ADDR(copy)   ((uint32) scheduleFlash + ((uint32) (copy) * SCHED_ROWS * CY_FLASH_SIZEOF_ROW))
+#define SCHED_COPY_PTR(copy)    ((const SCHEDULE_IMAGE *) SCHED_COPY_ADDR(copy))
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static uint32 Schedule_IsValid(const SCHEDULE_IMAGE *image);
+static void Schedule_RowWritten(uint32 rowNum, uint32 status);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+SCHEDULE schedule;
+
+/* Reserved flash region, accessed only through its address */
+static const uint8 CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+    scheduleFlash[SCHED_COPIES * SCHED_ROWS * CY_FLASH_SIZEOF_ROW] = {0u};
+
+/* Copy that holds the active schedule, or SCHED_COPIES if none */
+static uint32 scheduleCopy = SCHED_COPIES;
+
+/* Copy being written and the number of its rows still queued */
+static uint32 scheduleWriteCopy;
+static uint32 scheduleWriteRows = 0u;
+static uint32 scheduleWriteStatus;
+
+/* Row image for the flash write queue */
+static union
+{
+    SCHEDULE_IMAGE image;
+    uint8 rows[SCHED_ROWS * CY_FLASH_SIZEOF_ROW];
+} scheduleRow;
+
+
+/*******************************************************************************
+* Function Name: Schedule_Load
+********************************************************************************
+* Summary:
+*  Makes the newest valid flash copy the active schedule.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  CYRET_SUCCESS if a schedule was loaded, CYRET_EMPTY if flash holds none.
+*  In the latter case the active schedule is cleared.
+*
+*******************************************************************************/
+cystatus Schedule_Load(void)
+{
+    const SCHEDULE_IMAGE *image;
+    cystatus status = CYRET_EMPTY;
+    uint32 copy;
+    uint32 seq = SCHED_SEQ_ERASED;
+
+    scheduleCopy = SCHED_COPIES;
+
+    for (copy = 0u; copy < SCHED_COPIES; ++copy)
+    {
+        image = SCHED_COPY_PTR(copy);
+
+        if ((0u != Schedule_IsValid(image)) && (image->seq > seq))
+        {
+            seq = image->seq;
+            scheduleCopy = copy;
+        }
+    }
+
+    if (SCHED_COPIES != scheduleCopy)
+    {
+        (void) memcpy(&schedule, &SCHED_COPY_PTR(scheduleCopy)->schedule, sizeof(schedule));
+        status = CYRET_SUCCESS;
+    }
+    else
+    {
+        (void) memset(&schedule, 0, sizeof(schedule));
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Schedule_Save
+********************************************************************************
+* Summary:
+*  Queues the active schedule for writing to flash if it differs from the
+*  stored copy. The older copy is overwritten. The rows are committed in the
+*  background by FlashQ_Process(); the new copy becomes the reference for
+*  the next comparison once all its rows are written.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  CYRET_SUCCESS if the schedule is queued or already stored,
+*  CYRET_LOCKED if a previous save is still in progress or the flash queue
+*  is full. The caller should retry later.
+*
+*******************************************************************************/
+cystatus Schedule_Save(void)
+{
+    cystatus status = CYRET_SUCCESS;
+    uint32 seq = SCHED_SEQ_ERASED;
+    uint32 copy = 0u;
+    uint32 firstRow;
+    uint32 row;
+
+    if ((0u != scheduleWriteRows) || (FlashQ_GetFree() < SCHED_ROWS))
+    {
+        return (CYRET_LOCKED);
+    }
+
+    if (SCHED_COPIES != scheduleCopy)
+    {
+        seq  = SCHED_COPY_PTR(scheduleCopy)->seq;
+        copy = (scheduleCopy + 1u) % SCHED_COPIES;
+
+        if (0 == memcmp(&SCHED_COPY_PTR(scheduleCopy)->schedule, &schedule, sizeof(schedule)))
+        {
+            /* Content unchanged */
+            return (CYRET_SUCCESS);
+        }
+    }
+
+    (void) memset(&scheduleRow, 0, sizeof(scheduleRow));
+    scheduleRow.image.seq  = seq + 1u;
+    scheduleRow.image.size = (uint16) sizeof(SCHEDULE);
+    (void) memcpy(&scheduleRow.image.schedule, &schedule, sizeof(schedule));
+    scheduleRow.image.crc  = Crc16_Update(CRC16_INIT, (const uint8 *) &schedule, sizeof(schedule));
+
+    firstRow = SCHED_COPY_ADDR(copy) / CY_FLASH_SIZEOF_ROW;
+
+    scheduleWriteCopy   = copy;
+    scheduleWriteRows   = SCHED_ROWS;
+    scheduleWriteStatus = CY_SYS_FLASH_SUCCESS;
+
+    /* The row holding the sequence number goes last so a partial write
+    * leaves an invalid copy.
+    */
+    for (row = SCHED_ROWS; row > 0u; --row)
+    {
+        (void) FlashQ_Submit(firstRow + row - 1u, &scheduleRow.rows[(row - 1u) * CY_FLASH_SIZEOF_ROW],
+                             &Schedule_RowWritten);
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Schedule_RowWritten
+********************************************************************************
+* Summary:
+*  Flash queue callback. Makes the new copy current after its last row has
+*  been written.
+*
+* Parameters:
+*  rowNum - flash row number.
+*  status - CY_SYS_FLASH_x result of the write.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Schedule_RowWritten(uint32 rowNum, uint32 status)
+{
+    (void) rowNum;
+
+    if (CY_SYS_FLASH_SUCCESS != status)
+    {
+        scheduleWriteStatus = status;
+    }
+
+    --scheduleWriteRows;
+
+    /* On failure the previous copy stays current; the next save retries the
+    * same target copy.
+    */
+    if ((0u == scheduleWriteRows) && (CY_SYS_FLASH_SUCCESS == scheduleWriteStatus))
+    {
+        scheduleCopy = scheduleWriteCopy;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Schedule_IsValid
+********************************************************************************
+* Summary:
+*  Checks a flash copy of the schedule.
+*
+* Parameters:
+*  image - copy to check.
+*
+* Return:
+*  Non-zero if the copy is complete and matches its CRC.
+*
+*******************************************************************************/
+static uint32 Schedule_IsValid(const SCHEDULE_IMAGE *image)
+{
+    return ((SCHED_SEQ_ERASED != image->seq) &&
+            (sizeof(SCHEDULE) == image->size) &&
+            (image->crc == Crc16_Update(CRC16_INIT, (const uint8 *) &image->schedule, sizeof(SCHEDULE))));
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,76 @@
+/*******************************************************************************
+* File Name: schedule.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides the dose schedule table, function prototypes and
+*  constants for keeping the last good schedule in flash.
+*
+*******************************************************************************/
+
+#if !defined(CY_SCHEDULE_H)
+#define CY_SCHEDULE_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Four ThingSpeak channels with three time/dosage pairs each */
+#define SCHED_CHANNELS          (4u)
+#define SCHED_SLOTS_PER_CHANNEL (3u)
+#define SCHED_ENTRIES           (SCHED_CHANNELS * SCHED_SLOTS_PER_CHANNEL)
+
+/* Field text length including the terminator */
+#define SCHED_VALUE_LEN         (10u)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+typedef struct
+{
+    char time[SCHED_VALUE_LEN];
+    char dosage[SCHED_VALUE_LEN];
+} SCHEDULE_ENTRY;
+
+typedef struct
+{
+    uint32 entryId[SCHED_CHANNELS];     /* ThingSpeak entry_id per channel */
+    SCHEDULE_ENTRY entry[SCHED_ENTRIES];
+} SCHEDULE;
+
+/* Schedule as stored in flash */
+typedef struct
+{
+    uint32 seq;
+    uint16 crc;
+    uint16 size;
+    SCHEDULE schedule;
+} SCHEDULE_IMAGE;
+
+
+/***************************************
+*        External Variables
+****************************************/
+
+/* Active schedule */
+extern SCHEDULE schedule;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+cystatus Schedule_Load(void);
+cystatus Schedule_Save(void);
+
+
+#endif /* (CY_SCHEDULE_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,524 @@
+/*******************************************************************************
+* File Name: stackmon.c
+*
+* Version: 1.00
+*
+* Description:
+*  Stack and heap usage monitor. Before .data and .bss are initialized,
+*  CyBoot_Start_c_Callback() fills all SRAM above .bss, that is the heap, the
+*  unused gap and the reserved stack, with STACKMON_CANARY up to just below
+*  the current stack pointer. Everything the heap and the stack ever use
+*  overwrites the pattern, so the peaks are found by looking for the first
+*  word that is no longer painted. A pattern value written by the program
+*  itself can hide the last word, the peaks are exact to that.
+*
+*  A SysTick callback samples the stack pointer on every tick and checks the
+*  guard words at the bottom of the reserved stack every STACKMON_CHECK_MS.
+*  If the stack has gone past them, it raises a fault record that is kept
+*  over a reset and reported by StackMon_Process() on the debug log.
+*
+*  The region addresses are the symbols of cm0gcc.ld, and the start-up hook
+*  only exists in the GCC branch of Cm0Start.c.
+*
+*******************************************************************************/
+
+#include <stackmon.h>
+#include <systime.h>
+#include <crc.h>
+#include <fmt.h>
+#include <dbglog.h>
+#include <stddef.h>
+
+#if !(defined(__GNUC__) && !defined(__ARMCC_VERSION))
+    #error "stackmon.c needs the region symbols of cm0gcc.ld"
+#endif /* !(defined(__GNUC__) && !defined(__ARMCC_VERSION)) */
+
+
+/***************************************
+*        Linker Symbols
+****************************************/
+
+extern uint32 __cy_heap_start[];    /* End of .bss, start of the heap */
+extern uint32 __cy_heap_limit[];    /* End of the reserved heap */
+extern uint32 __cy_stack_limit[];   /* Bottom of the reserved stack */
+extern uint32 __cy_stack[];         /* Initial stack pointer, end of SRAM */
+
+
+/***************************************
+*        Start-up Definitions
+****************************************/
+
+/* Same as in Cm0Start.c: the regions to copy and zero before main() */
+typedef unsigned char __cy_byte_align8 __attribute ((aligned (8)));
+
+struct __cy_region
+{
+    __cy_byte_align8 *init;
+    __cy_byte_align8 *data;
+    size_t init_size;
+    size_t zero_size;
+};
+
+extern const struct __cy_region __cy_regions[];
+extern const char __cy_region_num __attribute__((weak));
+#define __cy_region_num ((size_t)&__cy_region_num)
+
+extern int main(void);
+extern void __libc_init_array(void);
+
+
+/***************************************
+*          Internal Constants
+****************************************/
+
+/* Milliseconds to SysTick ticks */
+#define STACKMON_TICKS(ms)      (((ms) * SYSTIME_TICK_HZ) / 1000u)
+
+/* Bytes covered by the fault record CRC */
+#define STACKMON_FAULT_CRC_LEN  (offsetof(STACKMON_FAULT, crc))
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void   StackMon_TickCallback(void);
+static void   StackMon_Raise(uint32 sp, uint32 depth);
+static uint32 StackMon_FaultCrc(const STACKMON_FAULT *fault);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static uint32 stackMonStarted = 0u;
+
+/* Deepest stack pointer seen by the callback, in bytes below __cy_stack */
+static volatile uint32 stackMonSampled = 0u;
+static uint32 stackMonTicks = 0u;
+
+/* Set by the callback when it raises the record, cleared once logged */
+static volatile uint32 stackMonRaised = 0u;
+static uint32 stackMonLogged = 1u;
+
+/* Not touched by the start-up code, so a record survives a reset */
+static STACKMON_FAULT stackMonFault CY_NOINIT;
+
+
+/*******************************************************************************
+* Function Name: CyBoot_Start_c_Callback
+********************************************************************************
+* Summary:
+*  Replaces the body of Start_c() in Cm0Start.c, see cyapicallbacks.h. Paints
+*  the free SRAM, then does what Start_c() does: initializes .data and .bss,
+*  runs the static constructors and calls main(). Nothing here may use a
+*  variable with static storage before the regions are initialized.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Does not return.
+*
+*******************************************************************************/
+void CyBoot_Start_c_Callback(void)
+{
+    uint32 *word = __cy_heap_start;
+    uint32 *stop = (uint32 *) ((__get_MSP() - STACKMON_PAINT_MARGIN) & ~(uint32) 3u);
+    const struct __cy_region *rptr = __cy_regions;
+    unsigned regions;
+    uint32 *src;
+    uint32 *dst;
+    unsigned count;
+
+    /* Heap, gap and stack up to the margin below this frame */
+    while (word < stop)
+    {
+        *word = STACKMON_CANARY;
+        word++;
+    }
+
+    /* Initialize memory */
+    for (regions = __cy_region_num; regions != 0u; regions--)
+    {
+        src = (uint32 *) rptr->init;
+        dst = (uint32 *) rptr->data;
+
+        for (count = 0u; count != rptr->init_size; count += sizeof (uint32))
+        {
+            *dst = *src;
+            dst++;
+            src++;
+        }
+        for (count = 0u; count != rptr->zero_size; count += sizeof (uint32))
+        {
+            *dst = 0u;
+            dst++;
+        }
+
+        rptr++;
+    }
+
+    /* Invoke static objects constructors */
+    __libc_init_array();
+    (void) main();
+
+    while (1)
+    {
+        /* If main returns, make sure we don't return. */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: StackMon_Start
+********************************************************************************
+* Summary:
+*  Registers the check in the first free SysTick callback slot. SysTime_Start()
+*  must have been called so that SysTick runs at SYSTIME_TICK_HZ. A valid
+*  fault record left by the previous run is kept and marked as such; any
+*  other .noinit content is discarded.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void StackMon_Start(void)
+{
+    uint32 i;
+
+    if (0u == stackMonStarted)
+    {
+        if ((STACKMON_FAULT_MAGIC == stackMonFault.magic) &&
+            (StackMon_FaultCrc(&stackMonFault) == stackMonFault.crc))
+        {
+            stackMonFault.boot = 1u;
+            stackMonFault.crc = StackMon_FaultCrc(&stackMonFault);
+            stackMonLogged = 0u;
+        }
+        else
+        {
+            stackMonFault.magic = 0u;
+        }
+
+        /* Find unused callback slot */
+        for (i = 0u; i < CY_SYS_SYST_NUM_OF_CALLBACKS; ++i)
+        {
+            if (CySysTickGetCallback(i) == NULL)
+            {
+                (void) CySysTickSetCallback(i, &StackMon_TickCallback);
+                break;
+            }
+        }
+
+        stackMonStarted = 1u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: StackMon_GetStackPeak
+********************************************************************************
+* Summary:
+*  Returns the deepest the stack has been since reset. The painted area is
+*  searched from the top of the heap upwards, so a stack that went past
+*  __cy_stack_limit shows its full depth. Takes up to a few thousand cycles.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Peak stack use in bytes; CYDEV_STACK_SIZE is reserved.
+*
+*******************************************************************************/
+uint32 StackMon_GetStackPeak(void)
+{
+    const uint32 *word = __cy_heap_limit;
+    uint32 peak;
+
+    while ((word < __cy_stack) && (STACKMON_CANARY == *word))
+    {
+        word++;
+    }
+
+    peak = (uint32) __cy_stack - (uint32) word;
+
+    return ((stackMonSampled > peak) ? stackMonSampled : peak);
+}
+
+
+/*******************************************************************************
+* Function Name: StackMon_GetHeapPeak
+********************************************************************************
+* Summary:
+*  Returns the highest heap address ever written, relative to the start of
+*  the heap. _sbrk() keeps malloc() within CYDEV_HEAP_SIZE.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Peak heap use in bytes; CYDEV_HEAP_SIZE is reserved.
+*
+*******************************************************************************/
+uint32 StackMon_GetHeapPeak(void)
+{
+    const uint32 *word = __cy_heap_limit;
+
+    while ((word > __cy_heap_start) && (STACKMON_CANARY == word[-1]))
+    {
+        word--;
+    }
+
+    return ((uint32) word - (uint32) __cy_heap_start);
+}
+
+
+/*******************************************************************************
+* Function Name: StackMon_GetFault
+********************************************************************************
+* Summary:
+*  Returns the fault record raised in this run or, until it is cleared, the
+*  one raised before the last reset.
+*
+* Parameters:
+*  fault - storage for a copy of the record, or NULL.
+*
+* Return:
+*  1 if there is a record, 0 otherwise.
+*
+*******************************************************************************/
+uint32 StackMon_GetFault(STACKMON_FAULT *fault)
+{
+    uint32 valid;
+    uint8 intState;
+
+    intState = CyEnterCriticalSection();
+
+    valid = (STACKMON_FAULT_MAGIC == stackMonFault.magic) ? 1u : 0u;
+
+    if ((0u != valid) && (NULL != fault))
+    {
+        *fault = stackMonFault;
+    }
+
+    CyExitCriticalSection(intState);
+
+    return (valid);
+}
+
+
+/*******************************************************************************
+* Function Name: StackMon_ClearFault
+********************************************************************************
+* Summary:
+*  Discards the fault record and re-arms the check.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void StackMon_ClearFault(void)
+{
+    uint8 intState;
+
+    intState = CyEnterCriticalSection();
+
+    stackMonFault.magic = 0u;
+    stackMonRaised = 0u;
+    stackMonLogged = 1u;
+
+    CyExitCriticalSection(intState);
+}
+
+
+/*******************************************************************************
+* Function Name: StackMon_Process
+********************************************************************************
+* Summary:
+*  Puts a fault record on the debug log once: the one left by the previous
+*  run after start-up, and a new one after the check has raised it. Call it
+*  from the idle loops.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void StackMon_Process(void)
+{
+    if ((0u == stackMonLogged) || (0u != stackMonRaised))
+    {
+        stackMonLogged = 1u;
+        stackMonRaised = 0u;
+
+        if (0u != stackMonFault.boot)
+        {
+            DBGLOG_ERROR("Stack overflow before reset\r\n");
+        }
+        else
+        {
+            DBGLOG_ERROR("Stack overflow\r\n");
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: StackMon_Dump
+********************************************************************************
+* Summary:
+*  Prints the peak and reserved sizes of the stack and heap and the fault
+*  record on the debug UART. Blocks until queued.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void StackMon_Dump(void)
+{
+    STACKMON_FAULT fault;
+    char digits[FMT_UINT32_SIZE];
+
+    UART_UartPutString("\r\nregion: peak size [bytes]\r\nstack: ");
+    Fmt_PutDec(StackMon_GetStackPeak());
+    UART_UartPutChar(' ');
+    Fmt_PutDec(CYDEV_STACK_SIZE);
+    UART_UartPutString("\r\nheap: ");
+    Fmt_PutDec(StackMon_GetHeapPeak());
+    UART_UartPutChar(' ');
+    Fmt_PutDec(CYDEV_HEAP_SIZE);
+    UART_UartPutString("\r\n");
+
+    if (0u != StackMon_GetFault(&fault))
+    {
+        UART_UartPutString("overflow: boot ms sp depth\r\n");
+        Fmt_PutDec(fault.boot);
+        UART_UartPutChar(' ');
+        Fmt_PutDec(fault.timeMs);
+        UART_UartPutChar(' ');
+        (void) Fmt_Hex(digits, fault.sp, 8u);
+        UART_UartPutString(digits);
+        UART_UartPutChar(' ');
+        Fmt_PutDec(fault.depth);
+        UART_UartPutString("\r\n");
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: StackMon_TickCallback
+********************************************************************************
+* Summary:
+*  SysTick callback: samples the stack pointer and checks the guard words.
+*  The sample is taken inside the interrupt, so it includes the exception
+*  frame of whatever was running.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void StackMon_TickCallback(void)
+{
+    uint32 sp = __get_MSP();
+    uint32 depth = (uint32) __cy_stack - sp;
+    uint32 overflow = (sp < (uint32) __cy_stack_limit) ? 1u : 0u;
+    uint32 i;
+
+    if (depth > stackMonSampled)
+    {
+        stackMonSampled = depth;
+    }
+
+    ++stackMonTicks;
+
+    if (stackMonTicks >= STACKMON_TICKS(STACKMON_CHECK_MS))
+    {
+        stackMonTicks = 0u;
+
+        for (i = 0u; i < STACKMON_GUARD_WORDS; ++i)
+        {
+            if (STACKMON_CANARY != __cy_stack_limit[i])
+            {
+                /* The stack has reached this word */
+                if ((CYDEV_STACK_SIZE - (i * sizeof(uint32))) > depth)
+                {
+                    depth = CYDEV_STACK_SIZE - (i * sizeof(uint32));
+                }
+                overflow = 1u;
+                break;
+            }
+        }
+    }
+
+    /* A record of the previous run is replaced, one of this run is kept */
+    if ((0u != overflow) &&
+        ((STACKMON_FAULT_MAGIC != stackMonFault.magic) || (0u != stackMonFault.boot)))
+    {
+        StackMon_Raise(sp, (stackMonSampled > depth) ? stackMonSampled : depth);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: StackMon_Raise
+********************************************************************************
+* Summary:
+*  Fills in the fault record. Only the first overflow of a run is recorded;
+*  the record has to be cleared to catch another one.
+*
+* Parameters:
+*  sp - stack pointer at the detection.
+*  depth - deepest stack seen in bytes.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void StackMon_Raise(uint32 sp, uint32 depth)
+{
+    stackMonFault.boot = 0u;
+    stackMonFault.timeMs = SysTime_GetMs();
+    stackMonFault.sp = sp;
+    stackMonFault.depth = depth;
+    stackMonFault.magic = STACKMON_FAULT_MAGIC;
+    stackMonFault.crc = StackMon_FaultCrc(&stackMonFault);
+
+    stackMonRaised = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: StackMon_FaultCrc
+********************************************************************************
+* Summary:
+*  Computes the CRC that tells a record from random .noinit content.
+*
+* Parameters:
+*  fault - record to check.
+*
+* Return:
+*  CRC-16 of the record fields before crc.
+*
+*******************************************************************************/
+static uint32 StackMon_FaultCrc(const STACKMON_FAULT *fault)
+{
+    return ((uint32) Crc16_Update(CRC16_INIT, (const uint8 *) fault, STACKMON_FAULT_CRC_LEN));
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,74 @@
+/*******************************************************************************
+* File Name: stackmon.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes, constants and the fault record
+*  of the stack and heap usage monitor.
+*
+*  Once StackMon_Dump() has shown the peaks over a full run, the Stack and
+*  Heap sizes in the System tab of the .cydwr can be lowered to the peak plus
+*  a margin and the SRAM given to the receive buffers.
+*
+*******************************************************************************/
+
+#if !defined(CY_STACKMON_H)
+#define CY_STACKMON_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* Pattern written over the free SRAM at start-up */
+#define STACKMON_CANARY         (0xDEADBEEFu)
+
+/* Bytes below the start-up stack pointer left unpainted */
+#define STACKMON_PAINT_MARGIN   (64u)
+
+/* Words at the bottom of the reserved stack checked by the timer */
+#define STACKMON_GUARD_WORDS    (8u)
+
+/* Period of the guard check */
+#define STACKMON_CHECK_MS       (10u)
+
+/* STACKMON_FAULT.magic of a valid record */
+#define STACKMON_FAULT_MAGIC    (0x53544B4Fu)
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+/* Overflow record, kept in .noinit so that it survives a reset */
+typedef struct
+{
+    uint32 magic;       /* STACKMON_FAULT_MAGIC */
+    uint32 boot;        /* 0 if raised in this run, 1 if before the last reset */
+    uint32 timeMs;      /* SysTime_GetMs() at the detection */
+    uint32 sp;          /* Stack pointer sampled by the check */
+    uint32 depth;       /* Deepest stack seen by the check in bytes */
+    uint32 crc;         /* CRC-16 of the fields above */
+} STACKMON_FAULT;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void   StackMon_Start(void);
+uint32 StackMon_GetStackPeak(void);
+uint32 StackMon_GetHeapPeak(void);
+uint32 StackMon_GetFault(STACKMON_FAULT *fault);
+void   StackMon_ClearFault(void);
+void   StackMon_Process(void);
+void   StackMon_Dump(void);
+
+
+#endif /* (CY_STACKMON_H) */
+
+
+/* [] END OF FILE */
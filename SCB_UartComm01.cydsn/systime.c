@@ -0,0 +1,197 @@
+/*******************************************************************************
+* File Name: systime.c
+*
+* Version: 1.00
+*
+* Description:
+*  Millisecond time base. The SysTick timer is reloaded to fire once per
+*  millisecond and a callback counts the ticks. All timeouts and periodic
+*  services in the project use SysTime_GetMs() as their clock.
+*
+*******************************************************************************/
+
+#include <systime.h>
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void SysTime_TickCallback(void);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static volatile uint32 sysTimeMs = 0u;
+static uint32 sysTimeStarted = 0u;
+
+/* Cycle count at the start of the current tick and cycles per tick */
+static volatile uint32 sysTimeCycles = 0u;
+static uint32 sysTimePeriod = 0u;
+
+
+/*******************************************************************************
+* Function Name: SysTime_Start
+********************************************************************************
+* Summary:
+*  Starts SysTick with a 1 ms period and registers the tick callback in the
+*  first free SysTick callback slot. Global interrupts must be enabled by the
+*  caller for the time base to advance.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void SysTime_Start(void)
+{
+    uint32 i;
+
+    if (0u == sysTimeStarted)
+    {
+        CySysTickStart();
+        /* SysTick counts reload..0, so the period is reload + 1 cycles */
+        CySysTickSetReload((cydelayFreqHz / SYSTIME_TICK_HZ) - 1u);
+        sysTimePeriod = cydelayFreqHz / SYSTIME_TICK_HZ;
+
+        /* Find unused callback slot */
+        for (i = 0u; i < CY_SYS_SYST_NUM_OF_CALLBACKS; ++i)
+        {
+            if (CySysTickGetCallback(i) == NULL)
+            {
+                (void) CySysTickSetCallback(i, &SysTime_TickCallback);
+                break;
+            }
+        }
+
+        sysTimeStarted = 1u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_GetMs
+********************************************************************************
+* Summary:
+*  Returns the number of milliseconds since SysTime_Start(). The counter wraps
+*  after about 49 days; use SysTime_Elapsed() to compare timestamps.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Millisecond counter.
+*
+*******************************************************************************/
+uint32 SysTime_GetMs(void)
+{
+    return (sysTimeMs);
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_Elapsed
+********************************************************************************
+* Summary:
+*  Returns the number of milliseconds passed since the sinceMs timestamp.
+*  Wrap-around safe.
+*
+* Parameters:
+*  sinceMs - timestamp previously returned by SysTime_GetMs().
+*
+* Return:
+*  Elapsed time in milliseconds.
+*
+*******************************************************************************/
+uint32 SysTime_Elapsed(uint32 sinceMs)
+{
+    return (sysTimeMs - sinceMs);
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_GetCycles
+********************************************************************************
+* Summary:
+*  Returns a free-running count of system clock cycles built from the tick
+*  counter and the current SysTick value. Wraps every 2^32 cycles. Cycles
+*  are counted at whatever clock is running, so a span that includes a
+*  SysTime_UpdateClock() mixes frequencies.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Cycle counter.
+*
+*******************************************************************************/
+uint32 SysTime_GetCycles(void)
+{
+    uint32 base;
+    uint32 value;
+
+    /* Retry if a tick came in between the two reads */
+    do
+    {
+        base = sysTimeCycles;
+        value = CySysTickGetValue();
+    }
+    while (base != sysTimeCycles);
+
+    return (base + (sysTimePeriod - 1u - value));
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_UpdateClock
+********************************************************************************
+* Summary:
+*  Recomputes the SysTick reload value after the system clock frequency has
+*  been changed at run time so that the tick period stays 1 ms.
+*
+* Parameters:
+*  sysclkHz - new system clock frequency in Hz.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void SysTime_UpdateClock(uint32 sysclkHz)
+{
+    if (0u != sysTimeStarted)
+    {
+        /* Keep the cycles of the interrupted tick */
+        sysTimeCycles += CySysTickGetReload() - CySysTickGetValue();
+
+        CySysTickSetReload((sysclkHz / SYSTIME_TICK_HZ) - 1u);
+        CySysTickClear();
+        sysTimePeriod = sysclkHz / SYSTIME_TICK_HZ;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_TickCallback
+********************************************************************************
+* Summary:
+*  SysTick callback: advances the millisecond and cycle counters.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void SysTime_TickCallback(void)
+{
+    ++sysTimeMs;
+    sysTimeCycles += sysTimePeriod;
+}
+
+
+/* [] END OF FILE */
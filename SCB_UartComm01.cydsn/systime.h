@@ -0,0 +1,40 @@
+/*******************************************************************************
+* File Name: systime.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the millisecond
+*  time base built on the SysTick timer.
+*
+*******************************************************************************/
+
+#if !defined(CY_SYSTIME_H)
+#define CY_SYSTIME_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* SysTick interrupt rate */
+#define SYSTIME_TICK_HZ         (1000u)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void   SysTime_Start(void);
+uint32 SysTime_GetMs(void);
+uint32 SysTime_Elapsed(uint32 sinceMs);
+uint32 SysTime_GetCycles(void);
+void   SysTime_UpdateClock(uint32 sysclkHz);
+
+
+#endif /* (CY_SYSTIME_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,208 @@
+/*******************************************************************************
+* File Name: button.c
+*
+* Version: 1.00
+*
+* Description:
+*  Debouncer for the SW2 switch. The switch is sampled from a SysTick
+*  callback once per millisecond and a change is accepted after it has been
+*  stable for BUTTON_DEBOUNCE_MS. The state machine (released, pressed,
+*  long pressed) posts press, long press and release events into a queue
+*  that the main loop reads with Button_GetEvent(), so no loop ever waits
+*  on the switch.
+*
+*******************************************************************************/
+
+#include <button.h>
+#include <systime.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+#define BUTTON_STATE_RELEASED   (0u)
+#define BUTTON_STATE_PRESSED    (1u)
+#define BUTTON_STATE_LONG       (2u)
+
+/* Milliseconds to SysTick ticks */
+#define BUTTON_TICKS(ms)        (((ms) * SYSTIME_TICK_HZ) / 1000u)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void Button_TickCallback(void);
+static void Button_Post(uint32 event);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static uint32 buttonStarted = 0u;
+
+/* State machine, updated from the SysTick callback only */
+static uint32 buttonState = BUTTON_STATE_RELEASED;
+static uint32 buttonChangeTicks = 0u;
+static uint32 buttonHeldTicks = 0u;
+
+/* Event queue: written by the callback, read by Button_GetEvent() */
+static volatile uint8 buttonQueue[BUTTON_QUEUE_SIZE];
+static volatile uint32 buttonQueueHead = 0u;
+static volatile uint32 buttonQueueTail = 0u;
+
+
+/*******************************************************************************
+* Function Name: Button_Start
+********************************************************************************
+* Summary:
+*  Registers the sampling callback in the first free SysTick callback slot.
+*  SysTime_Start() must have been called so that SysTick runs at
+*  SYSTIME_TICK_HZ. A switch held down at start-up posts a press once it
+*  is stable.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void Button_Start(void)
+{
+    uint32 i;
+
+    if (0u == buttonStarted)
+    {
+        /* Find unused callback slot */
+        for (i = 0u; i < CY_SYS_SYST_NUM_OF_CALLBACKS; ++i)
+        {
+            if (CySysTickGetCallback(i) == NULL)
+            {
+                (void) CySysTickSetCallback(i, &Button_TickCallback);
+                break;
+            }
+        }
+
+        buttonStarted = 1u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Button_GetEvent
+********************************************************************************
+* Summary:
+*  Takes the oldest event from the queue.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  BUTTON_EVENT_PRESS, BUTTON_EVENT_LONG_PRESS, BUTTON_EVENT_RELEASE, or
+*  BUTTON_EVENT_NONE if the queue is empty.
+*
+*******************************************************************************/
+uint32 Button_GetEvent(void)
+{
+    uint32 event = BUTTON_EVENT_NONE;
+    uint32 tail = buttonQueueTail;
+
+    if (tail != buttonQueueHead)
+    {
+        event = buttonQueue[tail];
+        buttonQueueTail = (tail + 1u) % BUTTON_QUEUE_SIZE;
+    }
+
+    return (event);
+}
+
+
+/*******************************************************************************
+* Function Name: Button_Post
+********************************************************************************
+* Summary:
+*  Adds an event to the queue, or drops it if the queue is full.
+*
+* Parameters:
+*  event - BUTTON_EVENT_* value.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Button_Post(uint32 event)
+{
+    uint32 head = buttonQueueHead;
+    uint32 next = (head + 1u) % BUTTON_QUEUE_SIZE;
+
+    if (next != buttonQueueTail)
+    {
+        buttonQueue[head] = (uint8) event;
+        buttonQueueHead = next;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Button_TickCallback
+********************************************************************************
+* Summary:
+*  SysTick callback: samples the switch and advances the state machine.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void Button_TickCallback(void)
+{
+    uint32 down = (BUTTON_IS_DOWN) ? 1u : 0u;
+    uint32 wasDown = (BUTTON_STATE_RELEASED != buttonState) ? 1u : 0u;
+
+    if (down != wasDown)
+    {
+        /* Accept the change once it has been stable for the debounce time */
+        ++buttonChangeTicks;
+
+        if (buttonChangeTicks >= BUTTON_TICKS(BUTTON_DEBOUNCE_MS))
+        {
+            buttonChangeTicks = 0u;
+            buttonHeldTicks = 0u;
+
+            if (0u != down)
+            {
+                buttonState = BUTTON_STATE_PRESSED;
+                Button_Post(BUTTON_EVENT_PRESS);
+            }
+            else
+            {
+                buttonState = BUTTON_STATE_RELEASED;
+                Button_Post(BUTTON_EVENT_RELEASE);
+            }
+        }
+    }
+    else
+    {
+        /* A bounce restarts the debounce time */
+        buttonChangeTicks = 0u;
+
+        if (BUTTON_STATE_PRESSED == buttonState)
+        {
+            ++buttonHeldTicks;
+
+            if (buttonHeldTicks >= BUTTON_TICKS(BUTTON_LONG_PRESS_MS))
+            {
+                buttonState = BUTTON_STATE_LONG;
+                Button_Post(BUTTON_EVENT_LONG_PRESS);
+            }
+        }
+    }
+}
+
+
+/* [] END OF FILE */
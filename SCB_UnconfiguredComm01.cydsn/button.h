@@ -0,0 +1,57 @@
+/*******************************************************************************
+* File Name: button.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the SW2 switch
+*  debouncer.
+*
+*******************************************************************************/
+
+#if !defined(CY_BUTTON_H)
+#define CY_BUTTON_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* The switch must be stable this long before a change is accepted */
+#define BUTTON_DEBOUNCE_MS      (20u)
+
+/* Held this long after the press, the switch posts a long press */
+#define BUTTON_LONG_PRESS_MS    (1000u)
+
+/* Events not yet taken by Button_GetEvent(); further events are dropped */
+#define BUTTON_QUEUE_SIZE       (4u)
+
+/* Events */
+#define BUTTON_EVENT_NONE       (0u)
+#define BUTTON_EVENT_PRESS      (1u)
+#define BUTTON_EVENT_RELEASE    (2u)
+#define BUTTON_EVENT_LONG_PRESS (3u)
+
+
+/***************************************
+*               Macros
+****************************************/
+
+/* The switch pulls SW2 low when pressed */
+#define BUTTON_IS_DOWN          (0u == SW2_Read())
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void   Button_Start(void);
+uint32 Button_GetEvent(void);
+
+
+#endif /* (CY_BUTTON_H) */
+
+
+/* [] END OF FILE */
@@ -23,15 +23,36 @@
 *******************************************************************************/
 
 #include <main.h>
+#include <scbswitch.h>
+#include <regmap.h>
+#include <systime.h>
+#include <button.h>
+#include <uartecho.h>
 
 /*******************************************************************************
 * Function Prototypes
 *******************************************************************************/
+static cystatus ConfigurationInit(uint32 opMode);
 static cystatus ConfigurationChange(uint32 opMode);
 static void RunI2CExample(void);
 static void RunUartExample(void);
-static uint32 ReadSwSwitch(void);
-static uint8 ExecuteCommand(uint32 cmd);
+static void NextUartBaudRate(void);
+static void ExecuteFrame(const uint8 frame[], uint32 size);
+static uint8 ExecuteCommand(const uint8 cmd[], uint32 avail, uint32 *cmdSize);
+static void SetStatus(uint32 result, uint32 done, uint32 failed, uint32 firstFail);
+static uint8 Crc8(const uint8 data[], uint32 len);
+static uint8 CmdSetOff(const uint8 args[]);
+static uint8 CmdSetRed(const uint8 args[]);
+static uint8 CmdSetGreen(const uint8 args[]);
+static uint8 CmdSetBlue(const uint8 args[]);
+static uint8 CmdSwitchUart(const uint8 args[]);
+static uint8 CmdSetRgb(const uint8 args[]);
+
+#if (SWITCH_BENCHMARK)
+    static void RunSwitchBenchmark(void);
+    static uint32 MeasureSwitch(cystatus (*change)(uint32 opMode));
+    static void PrintNumber(uint32 number);
+#endif /* (SWITCH_BENCHMARK) */
 
 
 /*******************************************************************************
@@ -43,7 +64,7 @@ static uint8 ExecuteCommand(uint32 cmd);
 #define NON_APPLICABLE  (DISABLED)
 
 /* Common RX and TX buffers for I2C and UART operation */
-#define COMMON_BUFFER_SIZE     (16u)
+#define COMMON_BUFFER_SIZE     (PACKET_MAX_SIZE)
 uint8 bufferTx[COMMON_BUFFER_SIZE];
 
 /* UART RX buffer requires one extra element for proper operation. One element
@@ -60,8 +81,8 @@ uint8 bufferRx[COMMON_BUFFER_SIZE + 1u];
 #define I2C_SLAVE_ADDRESS_MASK  (0xFEu)
 #define I2C_STANDARD_MODE_MAX   (100u)
 
-#define I2C_RX_BUFFER_SIZE      (PACKET_SIZE)
-#define I2C_TX_BUFFER_SIZE      (PACKET_SIZE)
+#define I2C_RX_BUFFER_SIZE      (PACKET_MAX_SIZE)
+#define I2C_TX_BUFFER_SIZE      (STATUS_SIZE)
 #define I2C_RX_BUFER_PTR        bufferRx
 #define I2C_TX_BUFER_PTR        bufferTx
 
@@ -145,6 +166,28 @@ const Comm_I2C_INIT_STRUCT configI2C =
     #define UART_CLK_DIVIDER        (0u)
 #endif /* (24u == CYDEV_BCLK__HFCLK__MHZ) */
 
+/* A break from the host selects the next baud rate of the list. The first
+* rate is the one set by UART_CLK_DIVIDER; it is restored on every change to
+* UART mode. With the oversampling of 13 every rate is within 0.2% of the
+* standard value at HFCLK = 24 or 12 MHz.
+*/
+#define UART_BAUD_DIVIDER(baud) \
+            ((((CYDEV_BCLK__HFCLK__HZ + ((UART_OVERSAMPLING * (baud)) / 2u)) / \
+               (UART_OVERSAMPLING * (baud)))) - 1u)
+
+#define UART_BAUD_RATES         (5u)
+
+static const uint16 uartBaudDivider[UART_BAUD_RATES] =
+{
+    UART_CLK_DIVIDER,               /* 115200 */
+    UART_BAUD_DIVIDER(230400u),
+    UART_BAUD_DIVIDER(460800u),
+    UART_BAUD_DIVIDER(921600u),
+    UART_BAUD_DIVIDER(57600u),
+};
+
+static uint32 uartBaudIndex = 0u;
+
 /* Comm_UART_INIT_STRUCT provides the fields which match the selections
 * available in the customizer. Refer to the I2C customizer for detailed
 * description of the settings.
@@ -189,14 +232,36 @@ const Comm_UART_INIT_STRUCT configUart =
 /* Global variables to manage current operation mode and initialization state */
 uint32 mode = OP_MODE_UART;
 
+/* Register images of both modes, indexed by the operation mode */
+static SCBSWITCH_IMAGE configImage[OP_MODES];
+
+/* Command table indexed by opcode */
+static const COMMAND_ENTRY commandTable[CMD_NUMBER] =
+{
+    { 0u, &CmdSetOff     },     /* CMD_SET_OFF */
+    { 0u, &CmdSetRed     },     /* CMD_SET_RED */
+    { 0u, &CmdSetGreen   },     /* CMD_SET_GREEN */
+    { 0u, &CmdSetBlue    },     /* CMD_SET_BLUE */
+    { 0u, &CmdSwitchUart },     /* CMD_SWITCH_UART */
+    { 1u, &CmdSetRgb     },     /* CMD_SET_RGB */
+};
+
+/* Frame counter reported in the status block */
+static uint8 statusSeq = 0u;
+
+/* Set by CMD_SWITCH_UART; the switch happens after the status is read */
+static uint32 switchRequest = 0u;
+
 
 /*******************************************************************************
 * Function Name: Main
 ********************************************************************************
 * Summary:
 *  The main function performs the following actions:
-*   1. Sets SCB configuration to UART or I2C.
-*   2. Executes UART or I2C example project.
+*   1. Initializes the SCB once in each mode to take the register images.
+*   2. Starts the time base and the switch debouncer.
+*   3. Sets SCB configuration to UART or I2C.
+*   4. Executes UART or I2C example project.
 *
 * Parameters:
 *  None
@@ -209,6 +274,20 @@ int main()
 {
     CyGlobalIntEnable;
 
+    RegMap_Init();
+
+    /* Full initialization of both modes, ending in UART mode */
+    (void) ConfigurationInit(OP_MODE_I2C);
+    (void) ConfigurationInit(OP_MODE_UART);
+
+#if (SWITCH_BENCHMARK)
+    RunSwitchBenchmark();
+#endif /* (SWITCH_BENCHMARK) */
+
+    /* After the benchmark, which uses SysTick on its own */
+    SysTime_Start();
+    Button_Start();
+
     for(;;)
     {
         /* Set SCB operation mode to UART or I2C. Default mode is UART */
@@ -229,11 +308,12 @@ int main()
 
 
 /*******************************************************************************
-* Function Name: ConfigurationChange
+* Function Name: ConfigurationInit
 ********************************************************************************
 * Summary:
 *  This function reconfigures the SCB component between the I2C and UART modes
-*  of operation.
+*  of operation from the configuration structures and records the resulting
+*  register image of the mode for ConfigurationChange().
 *
 * Parameters:
 *  opMode - mode of operation to which SCB component will be configured.
@@ -244,7 +324,7 @@ int main()
 *  The valid operation modes are: OP_MODE_I2C and OP_MODE_UART.
 *
 *******************************************************************************/
-static cystatus ConfigurationChange(uint32 opMode)
+static cystatus ConfigurationInit(uint32 opMode)
 {
     cystatus status = CYRET_SUCCESS;
 
@@ -266,14 +346,14 @@ static cystatus ConfigurationChange(uint32 opMode)
         * configuration structure.
         */
         Comm_I2CInit(&configI2C);
+        ScbSwitch_Capture(&configImage[OP_MODE_I2C], I2C_CLK_DIVIDER);
 
         /* Set read and write buffers for the I2C slave */
         Comm_I2CSlaveInitWriteBuf(I2C_RX_BUFER_PTR, I2C_RX_BUFFER_SIZE);
         Comm_I2CSlaveInitReadBuf (I2C_TX_BUFER_PTR, I2C_TX_BUFFER_SIZE);
 
-        /* Put start and end of the packet into the TX buffer */
-        bufferTx[PACKET_SOP_POS] = PACKET_SOP;
-        bufferTx[PACKET_EOP_POS] = PACKET_EOP;
+        /* Put an empty status block into the TX buffer */
+        SetStatus(FRAME_OK, 0u, 0u, STATUS_NO_FAIL);
 
         /* Start component after re-configuration is complete */
         Comm_Start();
@@ -296,6 +376,7 @@ static cystatus ConfigurationChange(uint32 opMode)
         * configuration structure.
         */
         Comm_UartInit(&configUart);
+        ScbSwitch_Capture(&configImage[OP_MODE_UART], UART_CLK_DIVIDER);
 
         /* Start component after re-configuration is complete */
         Comm_Start();
@@ -309,12 +390,70 @@ static cystatus ConfigurationChange(uint32 opMode)
 }
 
 
+/*******************************************************************************
+* Function Name: ConfigurationChange
+********************************************************************************
+* Summary:
+*  This function switches the SCB component between the I2C and UART modes
+*  of operation by applying the register image recorded by
+*  ConfigurationInit(), then resets the buffers of the new mode.
+*
+* Parameters:
+*  opMode - mode of operation to which SCB component will be configured.
+*
+* Return:
+*  Returns CYRET_SUCCESS if no problem was encountered while operation mode
+*  change or CYRET_BAD_PARAM if unknown operation mode is selected.
+*  The valid operation modes are: OP_MODE_I2C and OP_MODE_UART.
+*
+*******************************************************************************/
+static cystatus ConfigurationChange(uint32 opMode)
+{
+    cystatus status = CYRET_SUCCESS;
+
+    if (OP_MODE_I2C == opMode)
+    {
+        ScbSwitch_Apply(&configImage[OP_MODE_I2C]);
+
+        /* Start with empty slave buffers and no pending events */
+        Comm_I2CSlaveClearWriteBuf();
+        Comm_I2CSlaveClearReadBuf();
+        (void) Comm_I2CSlaveClearWriteStatus();
+        (void) Comm_I2CSlaveClearReadStatus();
+
+        /* The UART used the TX buffer: put the status block back and read
+        * it until the master sets a register map sub-address.
+        */
+        SetStatus(FRAME_OK, 0u, 0u, STATUS_NO_FAIL);
+        Comm_I2CSlaveInitReadBuf(I2C_TX_BUFER_PTR, I2C_TX_BUFFER_SIZE);
+    }
+    else if (OP_MODE_UART == opMode)
+    {
+        ScbSwitch_Apply(&configImage[OP_MODE_UART]);
+
+        /* Start with empty software buffers at the default baud rate */
+        Comm_SpiUartClearRxBuffer();
+        Comm_SpiUartClearTxBuffer();
+        uartBaudIndex = 0u;
+    }
+    else
+    {
+        status = CYRET_BAD_PARAM; /* Unknown operation mode - no action */
+    }
+
+    return (status);
+}
+
+
 /*******************************************************************************
 * Function Name: RunUartExample
 ********************************************************************************
 * Summary:
 *  Executes UART example project (SCB_UartComm) until configuration change
 *  occurs. The UART example project simply echoes any received character.
+*  With UART_BLOCK_ECHO the data is moved between the software buffers in
+*  spans by UartEcho_Process(). A break received from the host selects the
+*  next baud rate for throughput measurements.
 *
 * Parameters:
 *  None
@@ -325,7 +464,10 @@ static cystatus ConfigurationChange(uint32 opMode)
 *******************************************************************************/
 static void RunUartExample(void)
 {
+#if (!UART_BLOCK_ECHO)
     char8 ch;
+#endif /* (!UART_BLOCK_ECHO) */
+    uint32 errors;
 
     RGB_LED_OFF;
 
@@ -342,6 +484,10 @@ static void RunUartExample(void)
         * Loopback (echo) incoming UART characters
         ***********************************************************************/
 
+#if (UART_BLOCK_ECHO)
+        /* Move everything received that fits into the TX buffer */
+        (void) UartEcho_Process();
+#else
         /* Get received character or zero if nothing has been received yet */
         ch = Comm_UartGetChar();
 
@@ -352,11 +498,34 @@ static void RunUartExample(void)
             */
             Comm_UartPutChar(ch);
         }
+#endif /* (UART_BLOCK_ECHO) */
+
+        /* Keep receive errors, including dropped bytes, for the register map */
+        errors = Comm_GetRxInterruptSource() & Comm_INTR_RX_ERR;
+
+        if (0u != errors)
+        {
+            Comm_ClearRxInterruptSource(errors);
+        }
+
+        errors |= UartEcho_TakeOverflow();
+
+        if (0u != errors)
+        {
+            RegMap_AddUartErrors(errors);
+        }
+
+        /* The host sends a break to step to the next baud rate */
+        if (0u != (Comm_GetRxInterruptSource() & Comm_INTR_RX_BREAK_DETECT))
+        {
+            Comm_ClearRxInterruptSource(Comm_INTR_RX_BREAK_DETECT);
+            NextUartBaudRate();
+        }
 
         /***********************************************************************
         * Change configuration on the switch press event
         ***********************************************************************/
-        if (0u != ReadSwSwitch())
+        if (BUTTON_EVENT_PRESS == Button_GetEvent())
         {
             /* Print end of the example project header in the terminal */
             Comm_UartPutString("\r\n********************************************************************************\r\n");
@@ -376,14 +545,41 @@ static void RunUartExample(void)
 }
 
 
+/*******************************************************************************
+* Function Name: NextUartBaudRate
+********************************************************************************
+* Summary:
+*  Changes the UART to the next baud rate of uartBaudDivider[]. Data pending
+*  at the old rate, including the byte received with the break, is dropped.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void NextUartBaudRate(void)
+{
+    uartBaudIndex = (uartBaudIndex + 1u) % UART_BAUD_RATES;
+
+    Comm_SpiUartClearTxBuffer();
+    CommCLK_SetFractionalDividerRegister(uartBaudDivider[uartBaudIndex], 0u);
+    Comm_SpiUartClearRxBuffer();
+}
+
+
 /*******************************************************************************
 * Function Name: RunI2CExample
 ********************************************************************************
 * Summary:
 *  Executes I2C example project (SCB_I2cCommSlave) until configuration change
-*  occurs. The I2C example project receives a single command byte from an
-*  I2C master to control the state of the RGB LED using the ExecuteCommand()
-*  function.
+*  occurs. The I2C example project receives command frames from an I2C
+*  master to control the state of the RGB LED using the ExecuteFrame()
+*  function, and returns the status block of the last frame on reads.
+*  A write that starts with a register map sub-address is handled by the
+*  register map instead, and the following reads return the registers.
+*  A write without data (an address probe) changes nothing.
 *
 * Parameters:
 *  None
@@ -394,7 +590,10 @@ static void RunUartExample(void)
 *******************************************************************************/
 static void RunI2CExample(void)
 {
-    uint8 status;
+    uint32 size;
+    uint8 *readBuf;
+
+    switchRequest = 0u;
 
     /* Loop until switch is pressed to change configuration */
     for(;;)
@@ -404,25 +603,29 @@ static void RunI2CExample(void)
         ***********************************************************************/
         if (0u != (Comm_I2CSlaveStatus() & Comm_I2C_SSTAT_WR_CMPLT))
         {
-            status = STS_CMD_FAIL;
+            size = Comm_I2CSlaveGetWriteBufSize();
 
-            /* Check packet length */
-            if (PACKET_SIZE == Comm_I2CSlaveGetWriteBufSize())
+            if (0u == size)
             {
-                /* Check start and end of the packet markers */
-                if ((bufferRx[PACKET_SOP_POS] == PACKET_SOP) &&
-                    (bufferRx[PACKET_EOP_POS] == PACKET_EOP))
-                {
-                    status = ExecuteCommand(bufferRx[PACKET_CMD_POS]);
-                }
+                /* Address probe without data: keep the current read buffer */
+            }
+            else if (0u != (bufferRx[0u] & REGMAP_SUBADDR_FLAG))
+            {
+                /* Register map access: reads continue from the sub-address */
+                RegMap_Write(bufferRx, size);
+                readBuf = RegMap_GetReadBuf(&size);
+                Comm_I2CSlaveInitReadBuf(readBuf, size);
+            }
+            else
+            {
+                /* Execute the frame and read back its status block */
+                ExecuteFrame(bufferRx, size);
+                Comm_I2CSlaveInitReadBuf(I2C_TX_BUFER_PTR, I2C_TX_BUFFER_SIZE);
             }
 
             /* Clear slave write buffer and status */
             Comm_I2CSlaveClearWriteBuf();
-            (void) Comm_I2CSlaveClearWriteStatus();
-
-            /* Update read buffer */
-            bufferTx[PACKET_STS_POS] = status;
+            RegMap_AddI2cErrors(Comm_I2CSlaveClearWriteStatus());
         }
 
         /***********************************************************************
@@ -432,13 +635,20 @@ static void RunI2CExample(void)
         {
             /* Clear slave read buffer and status */
             Comm_I2CSlaveClearReadBuf();
-            (void) Comm_I2CSlaveClearReadStatus();
+            RegMap_AddI2cErrors(Comm_I2CSlaveClearReadStatus());
+
+            /* The master has the status of CMD_SWITCH_UART: change now */
+            if (0u != switchRequest)
+            {
+                mode = OP_MODE_UART;
+                break;
+            }
         }
 
         /***********************************************************************
         * Change configuration on the switch press event
         ***********************************************************************/
-        if (0u != ReadSwSwitch())
+        if (BUTTON_EVENT_PRESS == Button_GetEvent())
         {
             /* Change configuration to UART */
             mode = OP_MODE_UART;
@@ -449,96 +659,450 @@ static void RunI2CExample(void)
 
 
 /*******************************************************************************
-* Function Name: ReadSwSwitch
+* Function Name: ExecuteFrame
 ********************************************************************************
 * Summary:
-*  Reads and returns the current status of the switch.
+*  Checks a command frame received from the master and executes its
+*  commands in order. Execution stops at an unknown opcode or a truncated
+*  command because the position of the next command is then unknown. The
+*  result is put into the status block.
 *
 * Parameters:
+*  frame: received bytes.
+*  size: number of received bytes.
+*
+* Return:
 *  None
 *
+*******************************************************************************/
+static void ExecuteFrame(const uint8 frame[], uint32 size)
+{
+    uint32 result = FRAME_OK;
+    uint32 done = 0u;
+    uint32 failed = 0u;
+    uint32 firstFail = STATUS_NO_FAIL;
+    uint32 cmdSize;
+    uint32 len;
+    uint32 pos;
+
+    len = (size > PACKET_LEN_POS) ? frame[PACKET_LEN_POS] : 0u;
+
+    /* Check frame length against the LEN byte */
+    if ((size < PACKET_OVERHEAD) || (size != (len + PACKET_OVERHEAD)))
+    {
+        result = FRAME_ERR_LENGTH;
+    }
+    /* Check start and end of the packet markers */
+    else if ((PACKET_SOP != frame[PACKET_SOP_POS]) ||
+             (PACKET_EOP != frame[size - 1u]))
+    {
+        result = FRAME_ERR_MARKER;
+    }
+    /* CRC covers LEN and the commands */
+    else if (Crc8(&frame[PACKET_LEN_POS], len + 1u) != frame[size - 2u])
+    {
+        result = FRAME_ERR_CRC;
+    }
+    else
+    {
+        for (pos = PACKET_CMD_POS; pos < (PACKET_CMD_POS + len); pos += cmdSize)
+        {
+            if (STS_CMD_DONE == ExecuteCommand(&frame[pos], (PACKET_CMD_POS + len) - pos, &cmdSize))
+            {
+                ++done;
+            }
+            else
+            {
+                if (0u == failed)
+                {
+                    firstFail = done;
+                }
+                ++failed;
+                result = FRAME_ERR_COMMAND;
+
+                if (0u == cmdSize)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    SetStatus(result, done, failed, firstFail);
+}
+
+
+/*******************************************************************************
+* Function Name: ExecuteCommand
+********************************************************************************
+* Summary:
+*  Executes one command of a frame through the command table. If the opcode
+*  is unknown or the frame ends before its arguments, nothing is executed.
+*
+* Parameters:
+*  cmd: opcode followed by the argument bytes. Available commands:
+*   - CMD_SET_RED:     set red color of the LED.
+*   - CMD_SET_GREEN:   set green color of the LED.
+*   - CMD_SET_BLUE:    set blue color of the LED.
+*   - CMD_SET_OFF:     turn off the LED.
+*   - CMD_SET_RGB:     set the LED colors from a bit mask.
+*   - CMD_SWITCH_UART: change to UART mode after the status is read.
+*  avail: bytes left in the frame, opcode included.
+*  cmdSize: returns the size of the command, or 0 if it could not be
+*  decoded.
+*
 * Return:
-*  Returns non-zero value if switch is pressed and zero otherwise.
+*  Returns status of command execution. There are two statuses
+*  - STS_CMD_DONE: command is executed successfully.
+*  - STS_CMD_FAIL: unknown or truncated command, or the command failed.
 *
 *******************************************************************************/
-static uint32 ReadSwSwitch(void)
+static uint8 ExecuteCommand(const uint8 cmd[], uint32 avail, uint32 *cmdSize)
 {
-    uint32 heldDown;
-    uint32 swStatus;
+    const COMMAND_ENTRY *entry;
+    uint8 status = STS_CMD_FAIL;
 
-    swStatus = 0u;  /* Switch is not active */
-    heldDown = 0u;  /* Reset debounce counter */
+    *cmdSize = 0u;
 
-    /* Wait for debounce period before determining that the switch is pressed */
-    while (SWITCH_ON)
+    if (cmd[0u] < CMD_NUMBER)
     {
-        /* Count debounce period */
-        CyDelay(SWITCH_DEBOUNCE_UNIT);
-        ++heldDown;
+        entry = &commandTable[cmd[0u]];
 
-        if (heldDown > SWITCH_PUSH)
+        if ((1u + (uint32) entry->argSize) <= avail)
         {
-            swStatus = 1u; /* Switch is pressed */
-            break;
+            *cmdSize = 1u + (uint32) entry->argSize;
+            status = entry->func(&cmd[1u]);
         }
     }
 
-    return (swStatus);
+    return (status);
 }
 
 
 /*******************************************************************************
-* Function Name: ExecuteCommand
+* Function Name: SetStatus
 ********************************************************************************
 * Summary:
-*  Executes received command to control the LED color and returns status.
-*  If the command is unknown, the LED color is not changed.
+*  Fills the status block in the I2C read buffer. The master can detect a
+*  block read while it was updated by its CRC.
 *
 * Parameters:
-*  cmd: command to execute. Available commands:
-*   - CMD_SET_RED:   set red color of the LED.
-*   - CMD_SET_GREEN: set green color of the LED.
-*   - CMD_SET_BLUE:  set blue color of the LED.
-*   - CMD_SET_OFF:   turn off the LED.
+*  result: FRAME_* result of the frame.
+*  done: number of commands executed successfully.
+*  failed: number of commands that failed.
+*  firstFail: index of the first failed command, or STATUS_NO_FAIL.
 *
 * Return:
-*  Returns status of command execution. There are two statuses
-*  - STS_CMD_DONE: command is executed successfully.
-*  - STS_CMD_FAIL: Unknown command
+*  None
 *
 *******************************************************************************/
-static uint8 ExecuteCommand(uint32 cmd)
+static void SetStatus(uint32 result, uint32 done, uint32 failed, uint32 firstFail)
 {
-    uint8 status;
+    bufferTx[STATUS_SOP_POS]    = PACKET_SOP;
+    bufferTx[STATUS_RESULT_POS] = (uint8) result;
+    bufferTx[STATUS_DONE_POS]   = (uint8) done;
+    bufferTx[STATUS_FAIL_POS]   = (uint8) failed;
+    bufferTx[STATUS_FIRST_POS]  = (uint8) firstFail;
+    bufferTx[STATUS_SEQ_POS]    = statusSeq;
+    bufferTx[STATUS_CRC_POS]    = Crc8(&bufferTx[STATUS_RESULT_POS], STATUS_CRC_POS - STATUS_RESULT_POS);
+    bufferTx[STATUS_EOP_POS]    = PACKET_EOP;
+
+    ++statusSeq;
+}
 
-    status = STS_CMD_DONE;
 
-    /* Execute received command */
-    switch (cmd)
+/*******************************************************************************
+* Function Name: Crc8
+********************************************************************************
+* Summary:
+*  Calculates the CRC-8 used by the frames and the status block.
+*
+* Parameters:
+*  data: bytes to check.
+*  len: number of bytes.
+*
+* Return:
+*  CRC-8 with polynomial CRC8_POLYNOMIAL and initial value 0.
+*
+*******************************************************************************/
+static uint8 Crc8(const uint8 data[], uint32 len)
+{
+    uint32 crc = 0u;
+    uint32 i;
+    uint32 bit;
+
+    for (i = 0u; i < len; ++i)
     {
-        case CMD_SET_RED:
-            RGB_LED_ON_RED;
-            break;
+        crc ^= data[i];
 
-        case CMD_SET_GREEN:
-            RGB_LED_ON_GREEN;
-            break;
+        for (bit = 0u; bit < 8u; ++bit)
+        {
+            crc = (0u != (crc & 0x80u)) ? ((crc << 1u) ^ CRC8_POLYNOMIAL) : (crc << 1u);
+        }
+    }
 
-        case CMD_SET_BLUE:
-            RGB_LED_ON_BLUE;
-            break;
+    return ((uint8) crc);
+}
 
-        case CMD_SET_OFF:
-            RGB_LED_OFF;
-            break;
 
-        default:
-            status = STS_CMD_FAIL;
-            break;
+/*******************************************************************************
+* Function Name: CmdSetOff
+********************************************************************************
+* Summary:
+*  CMD_SET_OFF: turns off the LED.
+*
+* Parameters:
+*  args: not used.
+*
+* Return:
+*  STS_CMD_DONE
+*
+*******************************************************************************/
+static uint8 CmdSetOff(const uint8 args[])
+{
+    (void) args;
+    RGB_LED_OFF;
+
+    return (STS_CMD_DONE);
+}
+
+
+/*******************************************************************************
+* Function Name: CmdSetRed
+********************************************************************************
+* Summary:
+*  CMD_SET_RED: sets red color of the LED.
+*
+* Parameters:
+*  args: not used.
+*
+* Return:
+*  STS_CMD_DONE
+*
+*******************************************************************************/
+static uint8 CmdSetRed(const uint8 args[])
+{
+    (void) args;
+    RGB_LED_ON_RED;
+
+    return (STS_CMD_DONE);
+}
+
+
+/*******************************************************************************
+* Function Name: CmdSetGreen
+********************************************************************************
+* Summary:
+*  CMD_SET_GREEN: sets green color of the LED.
+*
+* Parameters:
+*  args: not used.
+*
+* Return:
+*  STS_CMD_DONE
+*
+*******************************************************************************/
+static uint8 CmdSetGreen(const uint8 args[])
+{
+    (void) args;
+    RGB_LED_ON_GREEN;
+
+    return (STS_CMD_DONE);
+}
+
+
+/*******************************************************************************
+* Function Name: CmdSetBlue
+********************************************************************************
+* Summary:
+*  CMD_SET_BLUE: sets blue color of the LED.
+*
+* Parameters:
+*  args: not used.
+*
+* Return:
+*  STS_CMD_DONE
+*
+*******************************************************************************/
+static uint8 CmdSetBlue(const uint8 args[])
+{
+    (void) args;
+    RGB_LED_ON_BLUE;
+
+    return (STS_CMD_DONE);
+}
+
+
+/*******************************************************************************
+* Function Name: CmdSwitchUart
+********************************************************************************
+* Summary:
+*  CMD_SWITCH_UART: requests the change to UART mode. It takes place after
+*  the master has read the status block of the frame.
+*
+* Parameters:
+*  args: not used.
+*
+* Return:
+*  STS_CMD_DONE
+*
+*******************************************************************************/
+static uint8 CmdSwitchUart(const uint8 args[])
+{
+    (void) args;
+    switchRequest = 1u;
+
+    return (STS_CMD_DONE);
+}
+
+
+/*******************************************************************************
+* Function Name: CmdSetRgb
+********************************************************************************
+* Summary:
+*  CMD_SET_RGB: sets each LED color on or off. Colors can be mixed.
+*
+* Parameters:
+*  args: args[0] bit 0 red, bit 1 green, bit 2 blue; other bits must be 0.
+*
+* Return:
+*  STS_CMD_DONE, or STS_CMD_FAIL if reserved bits are set.
+*
+*******************************************************************************/
+static uint8 CmdSetRgb(const uint8 args[])
+{
+    uint8 status = STS_CMD_FAIL;
+
+    if (0u == (args[0u] & 0xF8u))
+    {
+        /* LEDs are active low */
+        LED_RED_Write  ((0u != (args[0u] & 0x01u)) ? 0u : 1u);
+        LED_GREEN_Write((0u != (args[0u] & 0x02u)) ? 0u : 1u);
+        LED_BLUE_Write ((0u != (args[0u] & 0x04u)) ? 0u : 1u);
+        status = STS_CMD_DONE;
     }
 
     return (status);
 }
 
 
+#if (SWITCH_BENCHMARK)
+/*******************************************************************************
+* Function Name: RunSwitchBenchmark
+********************************************************************************
+* Summary:
+*  Measures the mode switch latency of the full initialization and of the
+*  cached register images, and prints both in the terminal. Leaves the SCB
+*  in UART mode once the report has been sent.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void RunSwitchBenchmark(void)
+{
+    uint32 fullCycles;
+    uint32 fastCycles;
+
+    fullCycles = MeasureSwitch(&ConfigurationInit);
+    fastCycles = MeasureSwitch(&ConfigurationChange);
+
+    Comm_UartPutString("\r\nMode switch latency, cycles (us) per switch:\r\n");
+    Comm_UartPutString("Full initialization: ");
+    PrintNumber(fullCycles);
+    Comm_UartPutString(" (");
+    PrintNumber(fullCycles / CYDEV_BCLK__HFCLK__MHZ);
+    Comm_UartPutString(")\r\nRegister image:      ");
+    PrintNumber(fastCycles);
+    Comm_UartPutString(" (");
+    PrintNumber(fastCycles / CYDEV_BCLK__HFCLK__MHZ);
+    Comm_UartPutString(")\r\n");
+
+    /* The next mode switch clears the TX buffer: let the report drain first */
+    while (0u != Comm_SpiUartGetTxBufferSize())
+    {
+    }
+    CyDelay(WAIT_FOR_END_UART_OUTPUT);
+}
+
+
+/*******************************************************************************
+* Function Name: MeasureSwitch
+********************************************************************************
+* Summary:
+*  Switches between I2C and UART SWITCH_BENCHMARK_ROUNDS times and returns
+*  the average duration of one switch in HFCLK cycles, timed with SysTick.
+*
+* Parameters:
+*  change - configuration function to measure.
+*
+* Return:
+*  Average cycles per switch.
+*
+*******************************************************************************/
+static uint32 MeasureSwitch(cystatus (*change)(uint32 opMode))
+{
+    uint32 total = 0u;
+    uint32 start;
+    uint32 i;
+
+    CySysTickInit();
+    CySysTickSetReload(CY_SYS_SYST_RVR_CNT_MASK);
+    CySysTickClear();
+    CySysTickEnable();
+
+    for (i = 0u; i < SWITCH_BENCHMARK_ROUNDS; ++i)
+    {
+        /* SysTick counts down; one switch is far below its 24-bit range */
+        start = CySysTickGetValue();
+        (void) change(OP_MODE_I2C);
+        total += (start - CySysTickGetValue()) & CY_SYS_SYST_RVR_CNT_MASK;
+
+        start = CySysTickGetValue();
+        (void) change(OP_MODE_UART);
+        total += (start - CySysTickGetValue()) & CY_SYS_SYST_RVR_CNT_MASK;
+    }
+
+    CySysTickStop();
+
+    return (total / (2u * SWITCH_BENCHMARK_ROUNDS));
+}
+
+
+/*******************************************************************************
+* Function Name: PrintNumber
+********************************************************************************
+* Summary:
+*  Prints a decimal number in the terminal.
+*
+* Parameters:
+*  number - value to print.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void PrintNumber(uint32 number)
+{
+    char8 digits[11u];
+    uint32 pos = sizeof(digits) - 1u;
+
+    digits[pos] = 0;
+
+    do
+    {
+        --pos;
+        digits[pos] = (char8) ('0' + (number % 10u));
+        number /= 10u;
+    }
+    while (0u != number);
+
+    Comm_UartPutString(&digits[pos]);
+}
+#endif /* (SWITCH_BENCHMARK) */
+
+
 /* [] END OF FILE */
@@ -31,50 +31,101 @@
 /* Operation mode: I2C slave or UART */
 #define OP_MODE_UART    (0u)
 #define OP_MODE_I2C     (1u)
-
-/* Packet size for I2C */
-#define PACKET_SIZE     (3u)
-
-/* Byte position within the packet */
-#define PACKET_SOP_POS  (0u)
-#define PACKET_CMD_POS  (1u)
-
-/* Command and status share the same offset */
-#define PACKET_STS_POS  (PACKET_CMD_POS)
-#define PACKET_EOP_POS  (2u)
+#define OP_MODES        (2u)
+
+/* Set to 1 to print the mode switch latency at start-up */
+#if !defined(SWITCH_BENCHMARK)
+    #define SWITCH_BENCHMARK        (0u)
+#endif /* !defined(SWITCH_BENCHMARK) */
+
+/* I2C to UART round trips timed by the benchmark */
+#define SWITCH_BENCHMARK_ROUNDS     (100u)
+
+/* Set to 0 to echo byte by byte with Comm_UartGetChar()/Comm_UartPutChar()
+*  instead of moving whole spans between the software buffers.
+*/
+#if !defined(UART_BLOCK_ECHO)
+    #define UART_BLOCK_ECHO         (1u)
+#endif /* !defined(UART_BLOCK_ECHO) */
+
+/* I2C command frame written by the master:
+*  SOP, LEN, LEN bytes of commands, CRC-8 over LEN and the commands, EOP.
+*  Each command is an opcode followed by its argument bytes.
+*/
+#define PACKET_MAX_SIZE     (32u)
+#define PACKET_OVERHEAD     (4u)
+#define PACKET_MAX_CMD_SIZE (PACKET_MAX_SIZE - PACKET_OVERHEAD)
+
+/* Byte position within the frame; CRC and EOP follow the commands */
+#define PACKET_SOP_POS      (0u)
+#define PACKET_LEN_POS      (1u)
+#define PACKET_CMD_POS      (2u)
 
 /* Start and end of the packet markers */
-#define PACKET_SOP      (0x01u)
-#define PACKET_EOP      (0x17u)
+#define PACKET_SOP          (0x01u)
+#define PACKET_EOP          (0x17u)
+
+/* CRC-8 polynomial x^8 + x^2 + x + 1 (SMBus PEC), initial value 0 */
+#define CRC8_POLYNOMIAL     (0x07u)
+
+/* Status block read by the master once per frame */
+#define STATUS_SOP_POS      (0u)
+#define STATUS_RESULT_POS   (1u)    /* FRAME_* result of the last frame */
+#define STATUS_DONE_POS     (2u)    /* Commands executed successfully */
+#define STATUS_FAIL_POS     (3u)    /* Commands that failed */
+#define STATUS_FIRST_POS    (4u)    /* Index of the first failed command */
+#define STATUS_SEQ_POS      (5u)    /* Incremented for every frame */
+#define STATUS_CRC_POS      (6u)    /* CRC-8 over RESULT .. SEQ */
+#define STATUS_EOP_POS      (7u)
+#define STATUS_SIZE         (8u)
+
+/* No command failed */
+#define STATUS_NO_FAIL      (0xFFu)
+
+/* Frame results */
+#define FRAME_OK            (0x00u)
+#define FRAME_ERR_LENGTH    (0x01u)
+#define FRAME_ERR_MARKER    (0x02u)
+#define FRAME_ERR_CRC       (0x03u)
+#define FRAME_ERR_COMMAND   (0x04u)
 
 /* Command execution status */
 #define STS_CMD_DONE    (0x00u)
 #define STS_CMD_FAIL    (0xFFu)
 
-/* Commands */
+/* Commands: opcode and number of argument bytes */
 #define CMD_SET_OFF     (0u)
 #define CMD_SET_RED     (1u)
 #define CMD_SET_GREEN   (2u)
 #define CMD_SET_BLUE    (3u)
 #define CMD_SWITCH_UART (4u)
+#define CMD_SET_RGB     (5u)    /* 1 byte: bit 0 red, bit 1 green, bit 2 blue */
+#define CMD_NUMBER      (6u)
 
 /* Delay to unsure UART complete transmitting in milliseconds */
 #define WAIT_FOR_END_UART_OUTPUT    (10u)
 
-/* Number of debounce units to count before consider that switch is pressed */
-#define SWITCH_PUSH     (80u)
 
-/* Switch debounce delay in milliseconds */
-#define SWITCH_DEBOUNCE_UNIT   (1u)
+/***************************************
+*        Type Definitions
+****************************************/
+
+/* Command handler: gets the argument bytes, returns STS_CMD_DONE or
+*  STS_CMD_FAIL.
+*/
+typedef uint8 (*COMMAND_FUNC)(const uint8 args[]);
+
+typedef struct
+{
+    uint8 argSize;
+    COMMAND_FUNC func;
+} COMMAND_ENTRY;
 
 
 /***************************************
 *               Macros
 ****************************************/
 
-/* Return true if switch is pressed */
-#define SWITCH_ON       (0u == SW2_Read())
-
 /* Set LED RED color */
 #define RGB_LED_ON_RED  \
                 do{     \
@@ -0,0 +1,432 @@
+/*******************************************************************************
+* File Name: regmap.c
+*
+* Version: 1.00
+*
+* Description:
+*  Register map of the I2C slave, accessed in the style of the EZI2C
+*  component. The master writes a sub-address byte, optionally followed by
+*  register data, and every following read returns the registers from that
+*  sub-address on. Reads past the end of the map return the component's
+*  overflow byte.
+*
+*  The map holds the schedule entries, the time of day and the sticky SCB
+*  error flags, so the master gets all of them in one burst read. The I2C
+*  read buffer points into the map; the time, uptime and error registers
+*  are copied in when the sub-address is written. The master must end the
+*  sub-address write with a stop condition, because the read buffer is only
+*  switched to the map after the write has completed.
+*
+*******************************************************************************/
+
+#include <regmap.h>
+#include <systime.h>
+#include <string.h>
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void   RegMap_Refresh(void);
+static void   RegMap_Put16(uint32 addr, uint32 value);
+static void   RegMap_Put32(uint32 addr, uint32 value);
+static uint32 RegMap_Get16(uint32 addr);
+static uint32 RegMap_Get32(uint32 addr);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static uint8 regMap[REGMAP_SIZE];
+
+/* Sub-address of the following reads */
+static uint32 regMapSubAddr = 0u;
+
+/* Sticky error flags and the number of error events */
+static uint32 regMapI2cErrors = 0u;
+static uint32 regMapUartErrors = 0u;
+static uint32 regMapErrorCount = 0u;
+
+
+/*******************************************************************************
+* Function Name: RegMap_Init
+********************************************************************************
+* Summary:
+*  Fills the identification registers, marks all schedule entries empty and
+*  sets the sub-address to 0.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void RegMap_Init(void)
+{
+    uint32 i;
+
+    (void) memset(regMap, 0, sizeof(regMap));
+
+    regMap[REGMAP_ID_ADDR]      = REGMAP_ID;
+    regMap[REGMAP_VERSION_ADDR] = REGMAP_VERSION;
+    regMap[REGMAP_ENTRIES_ADDR] = REGMAP_ENTRIES;
+
+    for (i = 0u; i < REGMAP_ENTRIES; ++i)
+    {
+        (void) RegMap_SetEntry(i, REGMAP_TIME_NONE, 0u);
+    }
+
+    regMapSubAddr = 0u;
+    RegMap_Refresh();
+}
+
+
+/*******************************************************************************
+* Function Name: RegMap_Write
+********************************************************************************
+* Summary:
+*  Handles a register map write from the master: sets the sub-address from
+*  the first byte and stores the following bytes from the sub-address on.
+*  Bytes for read-only registers and past the end of the map are ignored.
+*  Writing a 1 to an error flag clears it. A write to the time register
+*  sets the time of day if the new value is valid.
+*
+* Parameters:
+*  data - received bytes; data[0] is REGMAP_SUBADDR_FLAG | sub-address.
+*  size - number of received bytes.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void RegMap_Write(const uint8 data[], uint32 size)
+{
+    uint32 timeWritten = 0u;
+    uint32 addr;
+    uint32 i;
+
+    if (0u != size)
+    {
+        regMapSubAddr = (uint32) data[0u] & REGMAP_SUBADDR_MASK;
+
+        for (i = 1u; i < size; ++i)
+        {
+            addr = regMapSubAddr + (i - 1u);
+
+            if (addr >= REGMAP_SIZE)
+            {
+                break;
+            }
+
+            if ((addr >= REGMAP_TIME_ADDR) && (addr < (REGMAP_TIME_ADDR + 4u)))
+            {
+                regMap[addr] = data[i];
+                timeWritten = 1u;
+            }
+            else if (REGMAP_I2C_ERR_ADDR == addr)
+            {
+                regMapI2cErrors &= ~(uint32) data[i];
+            }
+            else if (REGMAP_UART_ERR_ADDR == addr)
+            {
+                regMapUartErrors &= ~(uint32) data[i];
+            }
+            else if (addr >= REGMAP_SCHED_ADDR)
+            {
+                regMap[addr] = data[i];
+            }
+            else
+            {
+                /* Read-only register */
+            }
+        }
+
+        if (0u != timeWritten)
+        {
+            /* An invalid time is dropped by the refresh below */
+            (void) SysTime_SetTime(RegMap_Get32(REGMAP_TIME_ADDR));
+        }
+    }
+
+    RegMap_Refresh();
+}
+
+
+/*******************************************************************************
+* Function Name: RegMap_GetReadBuf
+********************************************************************************
+* Summary:
+*  Returns the read buffer for the current sub-address, to be passed to
+*  Comm_I2CSlaveInitReadBuf().
+*
+* Parameters:
+*  size - returns the number of bytes from the sub-address to the end of
+*  the map.
+*
+* Return:
+*  Pointer to the register at the sub-address.
+*
+*******************************************************************************/
+uint8 * RegMap_GetReadBuf(uint32 *size)
+{
+    uint32 addr = (regMapSubAddr < REGMAP_SIZE) ? regMapSubAddr : 0u;
+
+    *size = (regMapSubAddr < REGMAP_SIZE) ? (REGMAP_SIZE - regMapSubAddr) : 0u;
+
+    return (&regMap[addr]);
+}
+
+
+/*******************************************************************************
+* Function Name: RegMap_AddI2cErrors
+********************************************************************************
+* Summary:
+*  Records the error bits of an I2C slave status.
+*
+* Parameters:
+*  slaveStatus - value returned by Comm_I2CSlaveStatus() or one of the
+*  Comm_I2CSlaveClear*Status() functions.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void RegMap_AddI2cErrors(uint32 slaveStatus)
+{
+    uint32 errors = 0u;
+
+    if (0u != (slaveStatus & (Comm_I2C_SSTAT_RD_ERR | Comm_I2C_SSTAT_WR_ERR)))
+    {
+        errors |= REGMAP_I2C_ERR_BUS;
+    }
+
+    if (0u != (slaveStatus & Comm_I2C_SSTAT_WR_OVFL))
+    {
+        errors |= REGMAP_I2C_ERR_WR_OVFL;
+    }
+
+    if (0u != errors)
+    {
+        regMapI2cErrors |= errors;
+        ++regMapErrorCount;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: RegMap_AddUartErrors
+********************************************************************************
+* Summary:
+*  Records the error bits of the UART RX interrupt sources.
+*
+* Parameters:
+*  rxSource - value returned by Comm_GetRxInterruptSource().
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void RegMap_AddUartErrors(uint32 rxSource)
+{
+    uint32 errors = 0u;
+
+    if (0u != (rxSource & Comm_INTR_RX_OVERFLOW))
+    {
+        errors |= REGMAP_UART_ERR_OVERFLOW;
+    }
+
+    if (0u != (rxSource & Comm_INTR_RX_FRAME_ERROR))
+    {
+        errors |= REGMAP_UART_ERR_FRAME;
+    }
+
+    if (0u != (rxSource & Comm_INTR_RX_PARITY_ERROR))
+    {
+        errors |= REGMAP_UART_ERR_PARITY;
+    }
+
+    if (0u != errors)
+    {
+        regMapUartErrors |= errors;
+        ++regMapErrorCount;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: RegMap_SetEntry
+********************************************************************************
+* Summary:
+*  Stores a schedule entry.
+*
+* Parameters:
+*  entry - entry index, below REGMAP_ENTRIES.
+*  time - dose time in minutes of the day, or REGMAP_TIME_NONE.
+*  dosage - dosage.
+*
+* Return:
+*  CYRET_SUCCESS, or CYRET_BAD_PARAM for an invalid entry, time or dosage.
+*
+*******************************************************************************/
+cystatus RegMap_SetEntry(uint32 entry, uint32 time, uint32 dosage)
+{
+    cystatus status = CYRET_BAD_PARAM;
+    uint32 addr;
+
+    if ((entry < REGMAP_ENTRIES) && (dosage <= 0xFFFFu) &&
+        ((time < REGMAP_MINUTES_PER_DAY) || (REGMAP_TIME_NONE == time)))
+    {
+        addr = REGMAP_SCHED_ADDR + (entry * REGMAP_ENTRY_SIZE);
+        RegMap_Put16(addr + REGMAP_ENTRY_TIME_POS, time);
+        RegMap_Put16(addr + REGMAP_ENTRY_DOSAGE_POS, dosage);
+
+        status = CYRET_SUCCESS;
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: RegMap_GetEntry
+********************************************************************************
+* Summary:
+*  Reads a schedule entry as last written by the master or
+*  RegMap_SetEntry().
+*
+* Parameters:
+*  entry - entry index, below REGMAP_ENTRIES.
+*  time - returns the dose time in minutes of the day.
+*  dosage - returns the dosage.
+*
+* Return:
+*  CYRET_SUCCESS, CYRET_EMPTY for an empty or invalid entry, or
+*  CYRET_BAD_PARAM for an invalid index.
+*
+*******************************************************************************/
+cystatus RegMap_GetEntry(uint32 entry, uint32 *time, uint32 *dosage)
+{
+    cystatus status = CYRET_BAD_PARAM;
+    uint32 addr;
+
+    if (entry < REGMAP_ENTRIES)
+    {
+        addr = REGMAP_SCHED_ADDR + (entry * REGMAP_ENTRY_SIZE);
+        *time = RegMap_Get16(addr + REGMAP_ENTRY_TIME_POS);
+        *dosage = RegMap_Get16(addr + REGMAP_ENTRY_DOSAGE_POS);
+
+        status = (*time < REGMAP_MINUTES_PER_DAY) ? CYRET_SUCCESS : CYRET_EMPTY;
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: RegMap_Refresh
+********************************************************************************
+* Summary:
+*  Copies the time of day, the uptime and the error registers into the map.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void RegMap_Refresh(void)
+{
+    RegMap_Put32(REGMAP_TIME_ADDR, SysTime_GetTime());
+    RegMap_Put32(REGMAP_UPTIME_ADDR, SysTime_GetMs() / 1000u);
+
+    regMap[REGMAP_I2C_ERR_ADDR]  = (uint8) regMapI2cErrors;
+    regMap[REGMAP_UART_ERR_ADDR] = (uint8) regMapUartErrors;
+    RegMap_Put16(REGMAP_ERR_COUNT_ADDR, (regMapErrorCount > 0xFFFFu) ? 0xFFFFu : regMapErrorCount);
+}
+
+
+/*******************************************************************************
+* Function Name: RegMap_Put16
+********************************************************************************
+* Summary:
+*  Stores a 16-bit register, little-endian.
+*
+* Parameters:
+*  addr - register address.
+*  value - value to store.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void RegMap_Put16(uint32 addr, uint32 value)
+{
+    regMap[addr]      = (uint8) value;
+    regMap[addr + 1u] = (uint8) (value >> 8u);
+}
+
+
+/*******************************************************************************
+* Function Name: RegMap_Put32
+********************************************************************************
+* Summary:
+*  Stores a 32-bit register, little-endian.
+*
+* Parameters:
+*  addr - register address.
+*  value - value to store.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void RegMap_Put32(uint32 addr, uint32 value)
+{
+    RegMap_Put16(addr, value);
+    RegMap_Put16(addr + 2u, value >> 16u);
+}
+
+
+/*******************************************************************************
+* Function Name: RegMap_Get16
+********************************************************************************
+* Summary:
+*  Reads a 16-bit register, little-endian.
+*
+* Parameters:
+*  addr - register address.
+*
+* Return:
+*  Register value.
+*
+*******************************************************************************/
+static uint32 RegMap_Get16(uint32 addr)
+{
+    return ((uint32) regMap[addr] | ((uint32) regMap[addr + 1u] << 8u));
+}
+
+
+/*******************************************************************************
+* Function Name: RegMap_Get32
+********************************************************************************
+* Summary:
+*  Reads a 32-bit register, little-endian.
+*
+* Parameters:
+*  addr - register address.
+*
+* Return:
+*  Register value.
+*
+*******************************************************************************/
+static uint32 RegMap_Get32(uint32 addr)
+{
+    return (RegMap_Get16(addr) | (RegMap_Get16(addr + 2u) << 16u));
+}
+
+
+/* [] END OF FILE */
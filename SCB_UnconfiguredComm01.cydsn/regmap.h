@@ -0,0 +1,80 @@
+/*******************************************************************************
+* File Name: regmap.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides the register addresses, function prototypes and
+*  constants of the register map served by the I2C slave.
+*
+*******************************************************************************/
+
+#if !defined(CY_REGMAP_H)
+#define CY_REGMAP_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* A write whose first byte has this bit set is a register map access and
+*  the low seven bits are the sub-address. Command frames start with
+*  PACKET_SOP, which does not have it set.
+*/
+#define REGMAP_SUBADDR_FLAG     (0x80u)
+#define REGMAP_SUBADDR_MASK     (0x7Fu)
+
+/* Register addresses. Multi-byte registers are little-endian. */
+#define REGMAP_ID_ADDR          (0x00u) /* R:   REGMAP_ID */
+#define REGMAP_VERSION_ADDR     (0x01u) /* R:   REGMAP_VERSION */
+#define REGMAP_ENTRIES_ADDR     (0x02u) /* R:   REGMAP_ENTRIES */
+#define REGMAP_TIME_ADDR        (0x04u) /* RW:  time of day, 0x00HHMMSS BCD */
+#define REGMAP_I2C_ERR_ADDR     (0x08u) /* RW1C: REGMAP_I2C_ERR_* */
+#define REGMAP_UART_ERR_ADDR    (0x09u) /* RW1C: REGMAP_UART_ERR_* */
+#define REGMAP_ERR_COUNT_ADDR   (0x0Au) /* R:   16-bit count of error events */
+#define REGMAP_UPTIME_ADDR      (0x0Cu) /* R:   32-bit seconds since start-up */
+#define REGMAP_SCHED_ADDR       (0x10u) /* RW:  schedule entries */
+
+/* Schedule entry: dose time in minutes of the day, then the dosage. Both
+*  are 16 bits; REGMAP_TIME_NONE marks an empty entry.
+*/
+#define REGMAP_ENTRY_TIME_POS   (0u)
+#define REGMAP_ENTRY_DOSAGE_POS (2u)
+#define REGMAP_ENTRY_SIZE       (4u)
+#define REGMAP_ENTRIES          (12u)
+#define REGMAP_TIME_NONE        (0xFFFFu)
+#define REGMAP_MINUTES_PER_DAY  (1440u)
+
+#define REGMAP_SIZE             (REGMAP_SCHED_ADDR + (REGMAP_ENTRIES * REGMAP_ENTRY_SIZE))
+
+#define REGMAP_ID               (0x5Cu)
+#define REGMAP_VERSION          (1u)
+
+/* Sticky SCB error flags */
+#define REGMAP_I2C_ERR_BUS      (0x01u) /* Bus error during a read or write */
+#define REGMAP_I2C_ERR_WR_OVFL  (0x02u) /* Master wrote more than the buffer */
+
+#define REGMAP_UART_ERR_OVERFLOW (0x01u) /* RX FIFO overflow */
+#define REGMAP_UART_ERR_FRAME   (0x02u) /* Framing error */
+#define REGMAP_UART_ERR_PARITY  (0x04u) /* Parity error */
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void     RegMap_Init(void);
+void     RegMap_Write(const uint8 data[], uint32 size);
+uint8 *  RegMap_GetReadBuf(uint32 *size);
+void     RegMap_AddI2cErrors(uint32 slaveStatus);
+void     RegMap_AddUartErrors(uint32 rxSource);
+cystatus RegMap_SetEntry(uint32 entry, uint32 time, uint32 dosage);
+cystatus RegMap_GetEntry(uint32 entry, uint32 *time, uint32 *dosage);
+
+
+#endif /* (CY_REGMAP_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,195 @@
+/*******************************************************************************
+* File Name: scbswitch.c
+*
+* Version: 1.00
+*
+* Description:
+*  Fast operation mode switching for the Comm SCB in Unconfigured mode.
+*
+*  Comm_I2CInit() and Comm_UartInit() derive every control register from the
+*  init structure, reprogram the pins field by field and install the
+*  interrupt vector. The result is the same on every call, so it is taken
+*  once per mode with ScbSwitch_Capture() right after the full
+*  initialization. ScbSwitch_Apply() then switches modes by storing the
+*  image: the configuration registers, the fields of the two pins (routing,
+*  drive mode, input buffer), the vector and the component state that
+*  Comm_Stop() and Comm_Enable() depend on.
+*
+*  The input buffer bit matters: the UART mode disables the buffer of its
+*  TX pin, which is SCL in the I2C mode.
+*
+*  Buffers given to the component (UART software buffers, I2C slave
+*  buffers) are kept in separate variables per mode and stay valid between
+*  switches; their indexes must be cleared by the caller.
+*
+*******************************************************************************/
+
+#include <scbswitch.h>
+#include <Comm_PVT.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+/* Drive mode field of a pin in the port configuration register */
+#define SCBSWITCH_DM_BITS       (3u)
+#define SCBSWITCH_DM_MASK(pin)  ((uint32) 0x07u << ((pin) * SCBSWITCH_DM_BITS))
+
+#if (Comm_RX_SDA_MOSI_PIN)
+    #define SCBSWITCH_RX_DM_MASK    SCBSWITCH_DM_MASK(Comm_uart_rx_i2c_sda_spi_mosi_SHIFT)
+#endif /* (Comm_RX_SDA_MOSI_PIN) */
+
+#if (Comm_TX_SCL_MISO_PIN)
+    #define SCBSWITCH_TX_DM_MASK    SCBSWITCH_DM_MASK(Comm_uart_tx_i2c_scl_spi_miso_SHIFT)
+#endif /* (Comm_TX_SCL_MISO_PIN) */
+
+/* Replaces a field of a register in one store */
+#define SCBSWITCH_SET_FIELD(reg, mask, value)   ((reg) = (((reg) & (uint32) ~(mask)) | (value)))
+
+
+/*******************************************************************************
+* Function Name: ScbSwitch_Capture
+********************************************************************************
+* Summary:
+*  Records the current configuration of the Comm SCB. Call after the full
+*  initialization of a mode (Comm_I2CInit() or Comm_UartInit()), before or
+*  after Comm_Start().
+*
+* Parameters:
+*  image - image to fill.
+*  divider - CommCLK divider value for the mode.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ScbSwitch_Capture(SCBSWITCH_IMAGE *image, uint32 divider)
+{
+    image->ctrl         = Comm_CTRL_REG & (uint32) ~Comm_CTRL_ENABLED;
+#if (!Comm_CY_SCBIP_V1)
+    image->uartCtrl     = Comm_UART_CTRL_REG;
+    image->uartRxCtrl   = Comm_UART_RX_CTRL_REG;
+    image->uartTxCtrl   = Comm_UART_TX_CTRL_REG;
+#endif /* (!Comm_CY_SCBIP_V1) */
+#if !(Comm_CY_SCBIP_V0 || Comm_CY_SCBIP_V1)
+    image->uartFlowCtrl = Comm_UART_FLOW_CTRL_REG;
+#endif /* !(Comm_CY_SCBIP_V0 || Comm_CY_SCBIP_V1) */
+    image->i2cCtrl      = Comm_I2C_CTRL_REG;
+    image->i2cCfg       = Comm_I2C_CFG_REG;
+    image->rxCtrl       = Comm_RX_CTRL_REG;
+    image->txCtrl       = Comm_TX_CTRL_REG;
+    image->rxFifoCtrl   = Comm_RX_FIFO_CTRL_REG;
+    image->txFifoCtrl   = Comm_TX_FIFO_CTRL_REG;
+    image->rxMatch      = Comm_RX_MATCH_REG;
+
+    image->intrRxMask     = Comm_INTR_RX_MASK_REG;
+    image->intrSlaveMask  = Comm_INTR_SLAVE_MASK_REG;
+    image->intrMasterMask = Comm_INTR_MASTER_MASK_REG;
+    image->intrI2cEcMask  = Comm_INTR_I2C_EC_MASK_REG;
+#if (!Comm_CY_SCBIP_V1)
+    image->intrSpiEcMask  = Comm_INTR_SPI_EC_MASK_REG;
+#endif /* (!Comm_CY_SCBIP_V1) */
+
+#if (Comm_RX_SDA_MOSI_PIN)
+    image->rxHsiom     = Comm_RX_SDA_MOSI_HSIOM_REG & Comm_RX_SDA_MOSI_HSIOM_MASK;
+    image->rxDriveMode = Comm_uart_rx_i2c_sda_spi_mosi_PC & SCBSWITCH_RX_DM_MASK;
+    #if (!Comm_CY_SCBIP_V1)
+        image->rxInpDis = Comm_uart_rx_i2c_sda_spi_mosi_INP_DIS & Comm_uart_rx_i2c_sda_spi_mosi_MASK;
+    #endif /* (!Comm_CY_SCBIP_V1) */
+#endif /* (Comm_RX_SDA_MOSI_PIN) */
+
+#if (Comm_TX_SCL_MISO_PIN)
+    image->txHsiom     = Comm_TX_SCL_MISO_HSIOM_REG & Comm_TX_SCL_MISO_HSIOM_MASK;
+    image->txDriveMode = Comm_uart_tx_i2c_scl_spi_miso_PC & SCBSWITCH_TX_DM_MASK;
+    #if (!Comm_CY_SCBIP_V1)
+        image->txInpDis = Comm_uart_tx_i2c_scl_spi_miso_INP_DIS & Comm_uart_tx_i2c_scl_spi_miso_MASK;
+    #endif /* (!Comm_CY_SCBIP_V1) */
+#endif /* (Comm_TX_SCL_MISO_PIN) */
+
+    image->divider    = divider;
+    image->isr        = CyIntGetVector(Comm_ISR_NUMBER);
+    image->intrTxMask = Comm_IntrTxMask;
+    image->scbMode    = Comm_scbMode;
+    image->enableWake = Comm_scbEnableWake;
+    image->enableIntr = Comm_scbEnableIntr;
+}
+
+
+/*******************************************************************************
+* Function Name: ScbSwitch_Apply
+********************************************************************************
+* Summary:
+*  Stops the Comm SCB in its current mode, loads a captured image and
+*  enables it again.
+*
+* Parameters:
+*  image - image taken with ScbSwitch_Capture().
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ScbSwitch_Apply(const SCBSWITCH_IMAGE *image)
+{
+    /* Runs the stop handling of the mode being left */
+    Comm_Stop();
+
+    CommCLK_SetFractionalDividerRegister(image->divider, 0u);
+
+    Comm_CTRL_REG           = image->ctrl;
+#if (!Comm_CY_SCBIP_V1)
+    Comm_UART_CTRL_REG      = image->uartCtrl;
+    Comm_UART_RX_CTRL_REG   = image->uartRxCtrl;
+    Comm_UART_TX_CTRL_REG   = image->uartTxCtrl;
+#endif /* (!Comm_CY_SCBIP_V1) */
+#if !(Comm_CY_SCBIP_V0 || Comm_CY_SCBIP_V1)
+    Comm_UART_FLOW_CTRL_REG = image->uartFlowCtrl;
+#endif /* !(Comm_CY_SCBIP_V0 || Comm_CY_SCBIP_V1) */
+    Comm_I2C_CTRL_REG       = image->i2cCtrl;
+    Comm_I2C_CFG_REG        = image->i2cCfg;
+    Comm_RX_CTRL_REG        = image->rxCtrl;
+    Comm_TX_CTRL_REG        = image->txCtrl;
+    Comm_RX_FIFO_CTRL_REG   = image->rxFifoCtrl;
+    Comm_TX_FIFO_CTRL_REG   = image->txFifoCtrl;
+    Comm_RX_MATCH_REG       = image->rxMatch;
+
+    Comm_INTR_RX_MASK_REG     = image->intrRxMask;
+    Comm_INTR_SLAVE_MASK_REG  = image->intrSlaveMask;
+    Comm_INTR_MASTER_MASK_REG = image->intrMasterMask;
+    Comm_INTR_I2C_EC_MASK_REG = image->intrI2cEcMask;
+#if (!Comm_CY_SCBIP_V1)
+    Comm_INTR_SPI_EC_MASK_REG = image->intrSpiEcMask;
+#endif /* (!Comm_CY_SCBIP_V1) */
+
+#if (Comm_RX_SDA_MOSI_PIN)
+    SCBSWITCH_SET_FIELD(Comm_uart_rx_i2c_sda_spi_mosi_PC, SCBSWITCH_RX_DM_MASK, image->rxDriveMode);
+    SCBSWITCH_SET_FIELD(Comm_RX_SDA_MOSI_HSIOM_REG, Comm_RX_SDA_MOSI_HSIOM_MASK, image->rxHsiom);
+    #if (!Comm_CY_SCBIP_V1)
+        SCBSWITCH_SET_FIELD(Comm_uart_rx_i2c_sda_spi_mosi_INP_DIS, Comm_uart_rx_i2c_sda_spi_mosi_MASK,
+                            image->rxInpDis);
+    #endif /* (!Comm_CY_SCBIP_V1) */
+#endif /* (Comm_RX_SDA_MOSI_PIN) */
+
+#if (Comm_TX_SCL_MISO_PIN)
+    SCBSWITCH_SET_FIELD(Comm_uart_tx_i2c_scl_spi_miso_PC, SCBSWITCH_TX_DM_MASK, image->txDriveMode);
+    SCBSWITCH_SET_FIELD(Comm_TX_SCL_MISO_HSIOM_REG, Comm_TX_SCL_MISO_HSIOM_MASK, image->txHsiom);
+    #if (!Comm_CY_SCBIP_V1)
+        SCBSWITCH_SET_FIELD(Comm_uart_tx_i2c_scl_spi_miso_INP_DIS, Comm_uart_tx_i2c_scl_spi_miso_MASK,
+                            image->txInpDis);
+    #endif /* (!Comm_CY_SCBIP_V1) */
+#endif /* (Comm_TX_SCL_MISO_PIN) */
+
+    (void) CyIntSetVector(Comm_ISR_NUMBER, image->isr);
+
+    Comm_IntrTxMask    = image->intrTxMask;
+    Comm_scbMode       = image->scbMode;
+    Comm_scbEnableWake = image->enableWake;
+    Comm_scbEnableIntr = image->enableIntr;
+
+    /* Runs the post-enable handling of the new mode */
+    Comm_Enable();
+}
+
+
+/* [] END OF FILE */
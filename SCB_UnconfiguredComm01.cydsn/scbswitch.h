@@ -0,0 +1,77 @@
+/*******************************************************************************
+* File Name: scbswitch.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides the register image type and function prototypes for
+*  switching the Comm SCB between operation modes from cached images.
+*
+*******************************************************************************/
+
+#if !defined(CY_SCBSWITCH_H)
+#define CY_SCBSWITCH_H
+
+#include <project.h>
+
+
+/***************************************
+*        Type Definitions
+****************************************/
+
+/* Everything that differs between two configured modes of the Comm SCB */
+typedef struct
+{
+    /* SCB configuration registers, CTRL without the enable bit */
+    uint32 ctrl;
+    uint32 uartCtrl;
+    uint32 uartRxCtrl;
+    uint32 uartTxCtrl;
+    uint32 uartFlowCtrl;
+    uint32 i2cCtrl;
+    uint32 i2cCfg;
+    uint32 rxCtrl;
+    uint32 txCtrl;
+    uint32 rxFifoCtrl;
+    uint32 txFifoCtrl;
+    uint32 rxMatch;
+
+    /* Interrupt sources; TX sources are restored by Comm_Enable() */
+    uint32 intrRxMask;
+    uint32 intrSlaveMask;
+    uint32 intrMasterMask;
+    uint32 intrI2cEcMask;
+    uint32 intrSpiEcMask;
+
+    /* Pin routing, drive modes and input buffer disable, only the fields
+    *  of the two SCB pins
+    */
+    uint32 rxHsiom;
+    uint32 txHsiom;
+    uint32 rxDriveMode;
+    uint32 txDriveMode;
+    uint32 rxInpDis;
+    uint32 txInpDis;
+
+    /* Clock divider and component state */
+    uint32 divider;
+    cyisraddress isr;
+    uint16 intrTxMask;
+    uint8 scbMode;
+    uint8 enableWake;
+    uint8 enableIntr;
+} SCBSWITCH_IMAGE;
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void ScbSwitch_Capture(SCBSWITCH_IMAGE *image, uint32 divider);
+void ScbSwitch_Apply(const SCBSWITCH_IMAGE *image);
+
+
+#endif /* (CY_SCBSWITCH_H) */
+
+
+/* [] END OF FILE */
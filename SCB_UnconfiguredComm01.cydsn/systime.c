@@ -0,0 +1,252 @@
+/*******************************************************************************
+* File Name: systime.c
+*
+* Version: 1.00
+*
+* Description:
+*  Millisecond time base and time of day. The SysTick timer is reloaded to
+*  fire once per millisecond and a callback counts the ticks and the
+*  seconds of the day. The time of day is set by the I2C master through the
+*  register map; it starts at 00:00:00.
+*
+*******************************************************************************/
+
+#include <systime.h>
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+static void SysTime_TickCallback(void);
+static uint32 SysTime_FromBcd(uint32 value);
+static uint32 SysTime_ToBcd(uint32 value);
+
+
+/***************************************
+*          Internal Variables
+****************************************/
+
+static volatile uint32 sysTimeMs = 0u;
+static uint32 sysTimeStarted = 0u;
+
+/* Seconds since midnight and milliseconds into the current second */
+static volatile uint32 sysTimeSecond = 0u;
+static volatile uint32 sysTimeSubMs = 0u;
+
+
+/*******************************************************************************
+* Function Name: SysTime_Start
+********************************************************************************
+* Summary:
+*  Starts SysTick with a 1 ms period and registers the tick callback in the
+*  first free SysTick callback slot. Global interrupts must be enabled by the
+*  caller for the time base to advance.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void SysTime_Start(void)
+{
+    uint32 i;
+
+    if (0u == sysTimeStarted)
+    {
+        CySysTickStart();
+        /* SysTick counts reload..0, so the period is reload + 1 cycles */
+        CySysTickSetReload((cydelayFreqHz / SYSTIME_TICK_HZ) - 1u);
+        CySysTickClear();
+
+        /* Find unused callback slot */
+        for (i = 0u; i < CY_SYS_SYST_NUM_OF_CALLBACKS; ++i)
+        {
+            if (CySysTickGetCallback(i) == NULL)
+            {
+                (void) CySysTickSetCallback(i, &SysTime_TickCallback);
+                break;
+            }
+        }
+
+        sysTimeStarted = 1u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_GetMs
+********************************************************************************
+* Summary:
+*  Returns the number of milliseconds since SysTime_Start(). The counter wraps
+*  after about 49 days; use SysTime_Elapsed() to compare timestamps.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Millisecond counter.
+*
+*******************************************************************************/
+uint32 SysTime_GetMs(void)
+{
+    return (sysTimeMs);
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_Elapsed
+********************************************************************************
+* Summary:
+*  Returns the number of milliseconds passed since the sinceMs timestamp.
+*  Wrap-around safe.
+*
+* Parameters:
+*  sinceMs - timestamp previously returned by SysTime_GetMs().
+*
+* Return:
+*  Elapsed time in milliseconds.
+*
+*******************************************************************************/
+uint32 SysTime_Elapsed(uint32 sinceMs)
+{
+    return (sysTimeMs - sinceMs);
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_GetTime
+********************************************************************************
+* Summary:
+*  Returns the time of day.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Time as 0x00HHMMSS in BCD, the layout of RTC_GetTime().
+*
+*******************************************************************************/
+uint32 SysTime_GetTime(void)
+{
+    uint32 second = sysTimeSecond;
+
+    return ((SysTime_ToBcd(second / 3600u) << SYSTIME_HOURS_OFFSET) |
+            (SysTime_ToBcd((second / 60u) % 60u) << SYSTIME_MINUTES_OFFSET) |
+            (SysTime_ToBcd(second % 60u) << SYSTIME_SECONDS_OFFSET));
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_SetTime
+********************************************************************************
+* Summary:
+*  Sets the time of day. The current second restarts.
+*
+* Parameters:
+*  time - time as 0x00HHMMSS in BCD, the layout of RTC_SetTime().
+*
+* Return:
+*  CYRET_SUCCESS, or CYRET_BAD_PARAM if a field is not valid BCD or out of
+*  range; the time is then not changed.
+*
+*******************************************************************************/
+cystatus SysTime_SetTime(uint32 time)
+{
+    uint32 hours   = SysTime_FromBcd((time >> SYSTIME_HOURS_OFFSET)   & SYSTIME_FIELD_MASK);
+    uint32 minutes = SysTime_FromBcd((time >> SYSTIME_MINUTES_OFFSET) & SYSTIME_FIELD_MASK);
+    uint32 seconds = SysTime_FromBcd((time >> SYSTIME_SECONDS_OFFSET) & SYSTIME_FIELD_MASK);
+    cystatus status = CYRET_BAD_PARAM;
+    uint8 intState;
+
+    if ((0u == (time >> 24u)) && (hours < 24u) && (minutes < 60u) && (seconds < 60u))
+    {
+        intState = CyEnterCriticalSection();
+        sysTimeSecond = (hours * 3600u) + (minutes * 60u) + seconds;
+        sysTimeSubMs = 0u;
+        CyExitCriticalSection(intState);
+
+        status = CYRET_SUCCESS;
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_FromBcd
+********************************************************************************
+* Summary:
+*  Converts a two-digit BCD value to binary.
+*
+* Parameters:
+*  value - BCD value.
+*
+* Return:
+*  Binary value, or 0xFF if a digit is not decimal.
+*
+*******************************************************************************/
+static uint32 SysTime_FromBcd(uint32 value)
+{
+    uint32 result = 0xFFu;
+
+    if (((value & 0x0Fu) < 10u) && ((value >> 4u) < 10u))
+    {
+        result = ((value >> 4u) * 10u) + (value & 0x0Fu);
+    }
+
+    return (result);
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_ToBcd
+********************************************************************************
+* Summary:
+*  Converts a binary value below 100 to two BCD digits.
+*
+* Parameters:
+*  value - binary value.
+*
+* Return:
+*  BCD value.
+*
+*******************************************************************************/
+static uint32 SysTime_ToBcd(uint32 value)
+{
+    return (((value / 10u) << 4u) | (value % 10u));
+}
+
+
+/*******************************************************************************
+* Function Name: SysTime_TickCallback
+********************************************************************************
+* Summary:
+*  SysTick callback: advances the millisecond counter and the time of day.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void SysTime_TickCallback(void)
+{
+    ++sysTimeMs;
+
+    if (++sysTimeSubMs >= SYSTIME_TICK_HZ)
+    {
+        sysTimeSubMs = 0u;
+
+        if (++sysTimeSecond >= SYSTIME_SECONDS_PER_DAY)
+        {
+            sysTimeSecond = 0u;
+        }
+    }
+}
+
+
+/* [] END OF FILE */
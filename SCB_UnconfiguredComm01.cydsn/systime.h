@@ -0,0 +1,48 @@
+/*******************************************************************************
+* File Name: systime.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes and constants for the millisecond
+*  time base and the time of day kept on the SysTick timer.
+*
+*******************************************************************************/
+
+#if !defined(CY_SYSTIME_H)
+#define CY_SYSTIME_H
+
+#include <project.h>
+
+
+/***************************************
+*            Constants
+****************************************/
+
+/* SysTick interrupt rate */
+#define SYSTIME_TICK_HZ         (1000u)
+
+/* Time of day in the RTC_P4 layout: 0x00HHMMSS, BCD */
+#define SYSTIME_HOURS_OFFSET    (16u)
+#define SYSTIME_MINUTES_OFFSET  (8u)
+#define SYSTIME_SECONDS_OFFSET  (0u)
+#define SYSTIME_FIELD_MASK      (0xFFu)
+
+#define SYSTIME_SECONDS_PER_DAY (86400u)
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+void     SysTime_Start(void);
+uint32   SysTime_GetMs(void);
+uint32   SysTime_Elapsed(uint32 sinceMs);
+uint32   SysTime_GetTime(void);
+cystatus SysTime_SetTime(uint32 time);
+
+
+#endif /* (CY_SYSTIME_H) */
+
+
+/* [] END OF FILE */
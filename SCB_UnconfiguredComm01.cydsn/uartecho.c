@@ -0,0 +1,143 @@
+/*******************************************************************************
+* File Name: uartecho.c
+*
+* Version: 1.00
+*
+* Description:
+*  Block-mode echo for the Comm SCB in UART mode. Instead of taking one byte
+*  with Comm_UartGetChar() and putting it back with Comm_UartPutChar(),
+*  UartEcho_Process() copies every contiguous span of received data from the
+*  RX software buffer straight into the TX software buffer and moves both
+*  indexes once per span. It never waits: when the TX buffer is full, the
+*  rest stays in the RX buffer for the next call.
+*
+*  The software buffers are the ones passed in configUart and are indexed
+*  the way the component's interrupt handler fills and drains them: the
+*  data of a buffer are the elements after its tail index up to and
+*  including its head index. Only 8-bit data is supported.
+*
+*******************************************************************************/
+
+#include <uartecho.h>
+#include <Comm_PVT.h>
+#include <Comm_SPI_UART_PVT.h>
+#include <string.h>
+
+
+/***************************************
+*        Internal Constants
+****************************************/
+
+/* Number of elements of each ring, one of them always stays empty */
+#define UARTECHO_RX_SIZE        (Comm_INTERNAL_RX_BUFFER_SIZE)
+#define UARTECHO_TX_SIZE        (Comm_TX_BUFFER_SIZE)
+
+/* Index after idx in a ring of the given size */
+#define UARTECHO_NEXT(idx, size)    ((((idx) + 1u) == (size)) ? 0u : ((idx) + 1u))
+
+
+/*******************************************************************************
+* Function Name: UartEcho_Process
+********************************************************************************
+* Summary:
+*  Moves all received data that fits into the TX software buffer, one
+*  contiguous span at a time, and enables the TX interrupt source that
+*  drains the TX software buffer into the FIFO.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Number of bytes moved.
+*
+*******************************************************************************/
+uint32 UartEcho_Process(void)
+{
+    uint32 rxHead = Comm_rxBufferHead;
+    uint32 rxTail = Comm_rxBufferTail;
+    uint32 txHead = Comm_txBufferHead;
+    uint32 txTail;
+    uint32 src;
+    uint32 dst;
+    uint32 count;
+    uint32 room;
+    uint32 moved = 0u;
+    uint8 intState;
+
+    while (rxTail != rxHead)
+    {
+        /* Received data up to the head or the end of the RX ring */
+        src = UARTECHO_NEXT(rxTail, UARTECHO_RX_SIZE);
+        count = (rxHead >= src) ? ((rxHead - src) + 1u) : (UARTECHO_RX_SIZE - src);
+
+        /* Free elements up to the tail or the end of the TX ring */
+        dst = UARTECHO_NEXT(txHead, UARTECHO_TX_SIZE);
+        txTail = Comm_txBufferTail;
+
+        if (dst == txTail)
+        {
+            break;  /* TX software buffer is full */
+        }
+
+        room = (txTail > dst) ? (txTail - dst) : (UARTECHO_TX_SIZE - dst);
+
+        if (count > room)
+        {
+            count = room;
+        }
+
+        (void) memcpy((void *) &Comm_txBuffer[dst], (const void *) &Comm_rxBuffer[src], count);
+
+        /* Publish the data before the interrupt handler can see the index */
+        txHead = dst + (count - 1u);
+        rxTail = src + (count - 1u);
+        Comm_txBufferHead = txHead;
+        Comm_rxBufferTail = rxTail;
+
+        moved += count;
+    }
+
+    if (0u != moved)
+    {
+        /* Same as Comm_SpiUartWriteTxData(), but interrupt safe: the handler
+        * disables the source when the TX software buffer runs empty.
+        */
+        intState = CyEnterCriticalSection();
+        Comm_ClearTxInterruptSource(Comm_INTR_TX_NOT_FULL);
+        Comm_INTR_TX_MASK_REG |= (uint32) Comm_INTR_TX_NOT_FULL;
+        CyExitCriticalSection(intState);
+    }
+
+    return (moved);
+}
+
+
+/*******************************************************************************
+* Function Name: UartEcho_TakeOverflow
+********************************************************************************
+* Summary:
+*  Reports and clears an overflow of the RX software buffer. The interrupt
+*  handler drops received bytes while the buffer is full.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Comm_INTR_RX_OVERFLOW if bytes were dropped since the last call, 0
+*  otherwise.
+*
+*******************************************************************************/
+uint32 UartEcho_TakeOverflow(void)
+{
+    uint32 overflow = Comm_rxBufferOverflow;
+
+    if (0u != overflow)
+    {
+        Comm_rxBufferOverflow = 0u;
+    }
+
+    return ((0u != overflow) ? Comm_INTR_RX_OVERFLOW : 0u);
+}
+
+
+/* [] END OF FILE */
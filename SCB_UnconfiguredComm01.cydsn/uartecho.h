@@ -0,0 +1,28 @@
+/*******************************************************************************
+* File Name: uartecho.h
+*
+* Version: 1.00
+*
+* Description:
+*  This file provides function prototypes for the block-mode UART echo.
+*
+*******************************************************************************/
+
+#if !defined(CY_UARTECHO_H)
+#define CY_UARTECHO_H
+
+#include <project.h>
+
+
+/***************************************
+*        Function Prototypes
+****************************************/
+
+uint32 UartEcho_Process(void);
+uint32 UartEcho_TakeOverflow(void);
+
+
+#endif /* (CY_UARTECHO_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Decode AT trace dumps (AtTrace_Dump() in attrace.c) from a debug UART log.
+
+Every "ATTRACE <n>" ... "ATTRACE END" block in the log is printed as a
+timeline with absolute and delta milliseconds.
+"""
+
+import argparse
+import struct
+import sys
+
+# Keep in sync with attrace.h / attrace.c
+EVENTS = {
+    1: "cmd",
+    2: "data",
+    3: "line",
+    4: "wait",
+    5: "done",
+    6: "timeout",
+}
+
+COMMANDS = [
+    "AT+CWJAP",
+    "AT+CIPMUX",
+    "AT+CIPSTART",
+    "AT+CIPSEND",
+    "AT+CIPCLOSE",
+    "AT+CIPRECVMODE",
+    "AT+CIPRECVDATA",
+    "AT+RST",
+]
+
+TOKENS = [
+    "OK",
+    "ERROR",
+    "FAIL",
+    "SEND OK",
+    "SEND FAIL",
+    ">",
+    "CLOSED",
+    "CONNECT",
+    "ALREADY CONNECTED",
+    "busy",
+    "WIFI CONNECTED",
+    "WIFI GOT IP",
+    "WIFI DISCONNECT",
+    "+IPD",
+    "+CIPRECVDATA",
+    "HTTP/",
+    "ready",
+]
+
+RECORD = struct.Struct("<IBBH")
+OTHER = 0xFF
+
+
+def name(table, code):
+    if code == OTHER:
+        return "?"
+    return table[code] if code < len(table) else "#%d" % code
+
+
+def describe(event, code, count):
+    kind = EVENTS.get(event, "ev%d" % event)
+    if event == 1:
+        return "%-8s %-16s %d bytes" % (kind, name(COMMANDS, code), count)
+    if event in (3, 4):
+        return "%-8s %-16s %d bytes" % (kind, name(TOKENS, code), count)
+    return "%-8s %-16s %d bytes" % (kind, "", count)
+
+
+def blocks(lines):
+    records = None
+    for line in lines:
+        line = line.strip()
+        if line.startswith("ATTRACE END"):
+            if records is not None:
+                yield records
+            records = None
+        elif line.startswith("ATTRACE "):
+            records = []
+        elif records is not None and len(line) == 2 * RECORD.size:
+            try:
+                records.append(RECORD.unpack(bytes.fromhex(line)))
+            except ValueError:
+                pass
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", nargs="?", help="captured UART log (default: stdin)")
+    args = parser.parse_args()
+
+    stream = open(args.log, errors="replace") if args.log else sys.stdin
+
+    for number, records in enumerate(blocks(stream)):
+        print("trace %d: %d records" % (number, len(records)))
+        previous = records[0][0] if records else 0
+        for time, event, code, count in records:
+            print("%10d ms %+8d  %s" % (time, time - previous, describe(event, code, count)))
+            previous = time
+        print()
+
+
+if __name__ == "__main__":
+    main()
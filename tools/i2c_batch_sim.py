@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+"""Host-side master simulator for the batched I2C command protocol.
+
+The protocol is implemented by SCB_UnconfiguredComm01/main.c. The master
+writes a frame and then reads an 8-byte status block:
+
+    frame:  SOP, LEN, <LEN bytes of commands>, CRC-8(LEN + commands), EOP
+    status: SOP, result, done, failed, first failed, seq, CRC-8, EOP
+
+Each command is an opcode followed by its argument bytes. The simulator
+runs random command batches through a model of the slave and checks every
+status block. It computes commands per second from the bus time at the
+given I2C clock and compares the result with the old protocol, which
+needed one 3-byte write and one 3-byte read per command.
+
+    python3 i2c_batch_sim.py --rate 100000
+    python3 i2c_batch_sim.py --bcp > BCP_Master_I2cCmd.iic
+
+A write whose first byte has bit 7 set addresses the register map
+instead; the script also shows register writes and a burst read.
+"""
+
+import argparse
+import random
+
+# Keep in sync with main.h
+SOP = 0x01
+EOP = 0x17
+CRC8_POLYNOMIAL = 0x07
+PACKET_MAX_SIZE = 32
+PACKET_OVERHEAD = 4
+STATUS_SIZE = 8
+STATUS_NO_FAIL = 0xFF
+
+FRAME_OK = 0x00
+FRAME_ERR_LENGTH = 0x01
+FRAME_ERR_MARKER = 0x02
+FRAME_ERR_CRC = 0x03
+FRAME_ERR_COMMAND = 0x04
+
+# opcode: (name, argument bytes)
+COMMANDS = {
+    0: ("CMD_SET_OFF", 0),
+    1: ("CMD_SET_RED", 0),
+    2: ("CMD_SET_GREEN", 0),
+    3: ("CMD_SET_BLUE", 0),
+    4: ("CMD_SWITCH_UART", 0),
+    5: ("CMD_SET_RGB", 1),
+}
+
+SLAVE_ADDRESS = 0x08
+
+# Register map (regmap.h): a write starting with REGMAP_SUBADDR_FLAG | addr
+REGMAP_SUBADDR_FLAG = 0x80
+REGMAP_TIME_ADDR = 0x04
+REGMAP_SCHED_ADDR = 0x10
+REGMAP_SIZE = 0x40
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ CRC8_POLYNOMIAL) if (crc & 0x80) else (crc << 1)
+            crc &= 0xFF
+    return crc
+
+
+def encode_frame(commands):
+    """commands: list of (opcode, args bytes)."""
+    body = bytearray()
+    for opcode, args in commands:
+        body.append(opcode)
+        body += args
+    if len(body) > PACKET_MAX_SIZE - PACKET_OVERHEAD:
+        raise ValueError("frame too long")
+    framed = bytes([len(body)]) + bytes(body)
+    return bytes([SOP]) + framed + bytes([crc8(framed), EOP])
+
+
+class SlaveModel:
+    """Mirrors ExecuteFrame() in main.c."""
+
+    def __init__(self):
+        self.seq = 0
+        self.led = None
+        self.status = self._status(FRAME_OK, 0, 0, STATUS_NO_FAIL)
+
+    def _status(self, result, done, failed, first):
+        body = bytes([result, done, failed, first, self.seq])
+        self.seq = (self.seq + 1) & 0xFF
+        return bytes([SOP]) + body + bytes([crc8(body), EOP])
+
+    def write(self, frame):
+        frame = frame[:PACKET_MAX_SIZE]
+        length = frame[1] if len(frame) > 1 else 0
+        done = failed = 0
+        first = STATUS_NO_FAIL
+        if len(frame) < PACKET_OVERHEAD or len(frame) != length + PACKET_OVERHEAD:
+            result = FRAME_ERR_LENGTH
+        elif frame[0] != SOP or frame[-1] != EOP:
+            result = FRAME_ERR_MARKER
+        elif crc8(frame[1:2 + length]) != frame[-2]:
+            result = FRAME_ERR_CRC
+        else:
+            result = FRAME_OK
+            pos, end = 2, 2 + length
+            while pos < end:
+                entry = COMMANDS.get(frame[pos])
+                ok = entry is not None and pos + 1 + entry[1] <= end
+                if ok and entry[0] == "CMD_SET_RGB":
+                    ok = (frame[pos + 1] & 0xF8) == 0
+                if ok:
+                    done += 1
+                    self.led = frame[pos]
+                else:
+                    if failed == 0:
+                        first = done
+                    failed += 1
+                    result = FRAME_ERR_COMMAND
+                    if entry is None or pos + 1 + entry[1] > end:
+                        break
+                pos += 1 + (entry[1] if entry else 0)
+        self.status = self._status(result, done, failed, first)
+
+    def read(self):
+        return self.status
+
+
+def decode_status(block):
+    if len(block) != STATUS_SIZE or block[0] != SOP or block[7] != EOP:
+        raise ValueError("bad status block markers")
+    if crc8(block[1:6]) != block[6]:
+        raise ValueError("bad status block CRC")
+    return {"result": block[1], "done": block[2], "failed": block[3],
+            "first": block[4], "seq": block[5]}
+
+
+def transaction_bits(data_bytes):
+    """START, address byte, data bytes with ACK, STOP."""
+    return 1 + 9 * (1 + data_bytes) + 1
+
+
+def random_batch(rng, max_bytes):
+    commands, size = [], 0
+    while True:
+        opcode = rng.choice([0, 1, 2, 3, 5])
+        args = bytes([rng.randrange(8)]) if opcode == 5 else b""
+        if size + 1 + len(args) > max_bytes:
+            return commands
+        commands.append((opcode, args))
+        size += 1 + len(args)
+
+
+def simulate(rate, gap_us, rounds, seed):
+    rng = random.Random(seed)
+    slave = SlaveModel()
+    bit_s = 1.0 / rate
+    gap_s = gap_us * 1e-6
+
+    # Old protocol: write SOP, cmd, EOP and read SOP, status, EOP per command
+    old_s = (transaction_bits(3) + transaction_bits(3)) * bit_s + 2 * gap_s
+    print("I2C clock %d Hz, %d us between transactions" % (rate, gap_us))
+    print("old 3-byte protocol: %8.0f commands/s" % (1.0 / old_s))
+    print("batch  frame  commands/s  speed-up")
+
+    for max_bytes in (1, 2, 4, 8, 16, PACKET_MAX_SIZE - PACKET_OVERHEAD):
+        commands = total_s = 0.0
+        for _ in range(rounds):
+            batch = random_batch(rng, max_bytes)
+            frame = encode_frame(batch)
+            slave.write(frame)
+            status = decode_status(slave.read())
+            if status["result"] != FRAME_OK or status["done"] != len(batch):
+                raise AssertionError("slave rejected %s: %s" % (frame.hex(), status))
+            commands += len(batch)
+            total_s += (transaction_bits(len(frame)) + transaction_bits(STATUS_SIZE)) * bit_s + 2 * gap_s
+        rate_cmd = commands / total_s
+        print("%5d  %5d  %10.0f  %7.1fx" % (max_bytes, max_bytes + PACKET_OVERHEAD,
+                                             rate_cmd, rate_cmd * old_s))
+
+    # Error paths of the slave model
+    bad = bytearray(encode_frame([(1, b"")]))
+    bad[-2] ^= 0xFF
+    slave.write(bytes(bad))
+    assert decode_status(slave.read())["result"] == FRAME_ERR_CRC
+    slave.write(encode_frame([(2, b""), (9, b""), (3, b"")]))
+    status = decode_status(slave.read())
+    assert status["result"] == FRAME_ERR_COMMAND and status["done"] == 1 and status["first"] == 1
+
+
+def bcp_script():
+    """Bridge Control Panel script: single commands, then one batch."""
+    lines = []
+
+    def emit(comment, commands):
+        frame = encode_frame(commands)
+        lines.append("; " + comment)
+        lines.append("w %02X %s p" % (SLAVE_ADDRESS, " ".join("%02X" % b for b in frame)))
+        lines.append("r %02X %s p" % (SLAVE_ADDRESS, " ".join(["x"] * STATUS_SIZE)))
+        lines.append("[DELAY=500]")
+
+    emit("Send CMD_SET_RED and read back status", [(1, b"")])
+    emit("Send CMD_SET_GREEN and read back status", [(2, b"")])
+    emit("Send CMD_SET_BLUE and read back status", [(3, b"")])
+    emit("Send CMD_SET_OFF and read back status", [(0, b"")])
+    emit("Send a batch: CMD_SET_RGB red+blue, CMD_SET_GREEN, CMD_SET_OFF",
+         [(5, b"\x05"), (2, b""), (0, b"")])
+
+    def reg_write(comment, addr, data):
+        lines.append("; " + comment)
+        lines.append("w %02X %s p" % (SLAVE_ADDRESS, " ".join(
+            "%02X" % b for b in bytes([REGMAP_SUBADDR_FLAG | addr]) + data)))
+
+    reg_write("Set the time of day to 12:00:00 (BCD, little-endian)",
+              REGMAP_TIME_ADDR, b"\x00\x00\x12\x00")
+    reg_write("Schedule entry 0: 08:30 (510 minutes), dosage 5",
+              REGMAP_SCHED_ADDR, b"\xFE\x01\x05\x00")
+    reg_write("Read the whole register map in one burst", 0x00, b"")
+    lines.append("r %02X %s p" % (SLAVE_ADDRESS, " ".join(["x"] * REGMAP_SIZE)))
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--rate", type=int, default=100000, help="I2C clock in Hz")
+    parser.add_argument("--gap-us", type=int, default=50,
+                        help="master turnaround between transactions")
+    parser.add_argument("--rounds", type=int, default=1000)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--bcp", action="store_true",
+                        help="print a Bridge Control Panel script instead")
+    args = parser.parse_args()
+
+    if args.bcp:
+        print(bcp_script())
+    else:
+        simulate(args.rate, args.gap_us, args.rounds, args.seed)
+
+
+if __name__ == "__main__":
+    main()
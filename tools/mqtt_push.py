@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Push a schedule to the dispenser over MQTT (mqtt.c) for bench tests.
+
+Publishes one QoS 0 message to "dispenser/schedule/<channel>" with a raw
+MQTT 3.1.1 client, so nothing beyond the standard library is needed. The
+payload is a feed body in the format the firmware polls (feeds.csv by
+default), for example:
+
+    mosquitto -v -p 1883
+    python3 mqtt_push.py --channel 0 --csv "2024-01-01 08:00:00 UTC,42,0800,150,1200,150,1800,150"
+
+Set the broker on the dispenser with the configuration key 8
+(CFG_KEY_MQTT_BROKER) as "host[:port]". Use mosquitto_sub -t "dispenser/#" -v
+to watch the "online" status message the dispenser publishes on connect.
+"""
+
+import argparse
+import socket
+import struct
+import sys
+
+# Keep in sync with main.c
+TOPIC_SCHEDULE = "dispenser/schedule/%d"
+CSV_HEADER = "created_at,entry_id,field1,field2,field3,field4,field5,field6"
+
+
+def remaining_length(length):
+    out = bytearray()
+    while True:
+        byte = length & 0x7F
+        length >>= 7
+        out.append(byte | (0x80 if length else 0))
+        if not length:
+            return bytes(out)
+
+
+def string(text):
+    data = text.encode()
+    return struct.pack(">H", len(data)) + data
+
+
+def packet(kind, body):
+    return bytes([kind]) + remaining_length(len(body)) + body
+
+
+def read_packet(sock):
+    kind = sock.recv(1)
+    if not kind:
+        raise ConnectionError("broker closed the connection")
+    length, shift = 0, 0
+    while True:
+        byte = sock.recv(1)[0]
+        length |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    body = b""
+    while len(body) < length:
+        body += sock.recv(length - len(body))
+    return kind[0], body
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", default="localhost")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--channel", type=int, default=0,
+                        help="index into the poller channel table")
+    parser.add_argument("--csv", help="one CSV row; the feeds.csv header is added")
+    parser.add_argument("--body", help="raw payload, e.g. a last.json object")
+    args = parser.parse_args()
+
+    if args.body is not None:
+        payload = args.body.encode()
+    elif args.csv is not None:
+        payload = (CSV_HEADER + "\n" + args.csv + "\n").encode()
+    else:
+        parser.error("one of --csv or --body is required")
+
+    sock = socket.create_connection((args.host, args.port), timeout=5)
+
+    connect = string("MQTT") + bytes([4, 0x02]) + struct.pack(">H", 60) + string("mqtt_push")
+    sock.sendall(packet(0x10, connect))
+    kind, body = read_packet(sock)
+    if kind != 0x20 or body[1] != 0:
+        sys.exit("CONNECT refused: %r" % body)
+
+    topic = TOPIC_SCHEDULE % args.channel
+    sock.sendall(packet(0x30, string(topic) + payload))
+    sock.sendall(packet(0xE0, b""))
+    sock.close()
+
+    print("published %d bytes to %s" % (len(payload), topic))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""Wrap a firmware binary in the OTA image header used by ota.c.
+
+Header (little endian, 16 bytes):
+    uint32 magic    "OTA1"
+    uint32 length   payload length
+    uint16 crc      CRC-16/CCITT-FALSE of the payload
+    uint16 version
+    uint32 reserved
+
+Serve the result with e.g. "python3 -m http.server 8000" and store
+"<host>:8000/<file>" under CFG_KEY_OTA_URL to start a download.
+"""
+
+import argparse
+import struct
+import sys
+
+OTA_MAGIC = 0x3141544F
+OTA_SLOT_SIZE = 0x8000
+HEADER = struct.Struct("<IIHHI")
+
+
+def crc16(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("binary", help="raw firmware image")
+    parser.add_argument("output", help="OTA image to write")
+    parser.add_argument("--version", type=int, default=0, help="image version (0-65535)")
+    args = parser.parse_args()
+
+    with open(args.binary, "rb") as f:
+        payload = f.read()
+
+    if len(payload) > OTA_SLOT_SIZE - HEADER.size:
+        sys.exit("image too large: %d bytes, slot holds %d"
+                 % (len(payload), OTA_SLOT_SIZE - HEADER.size))
+
+    header = HEADER.pack(OTA_MAGIC, len(payload), crc16(payload), args.version & 0xFFFF, 0)
+
+    with open(args.output, "wb") as f:
+        f.write(header + payload)
+
+    print("%s: %d bytes, crc 0x%04X" % (args.output, len(payload), crc16(payload)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,180 @@
+/*******************************************************************************
+* File Name: button_test.c
+*
+* Description:
+*  Host test of the SW2 debouncer. A stand-in pin is driven through
+*  bounces, short and long presses and the SysTick callback is called once
+*  per simulated millisecond. Build and run:
+*
+*    cc -I tools/test/stub -I SCB_UnconfiguredComm01.cydsn \
+*       tools/test/button_test.c -o button_test && ./button_test
+*
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <project.h>
+
+
+/***************************************
+*        Firmware Stand-ins
+****************************************/
+
+#define CY_SYS_SYST_NUM_OF_CALLBACKS    (5u)
+
+typedef void (*cySysTickCallback)(void);
+
+static cySysTickCallback testCallbacks[CY_SYS_SYST_NUM_OF_CALLBACKS];
+
+/* SW2 pin level: 1 released, 0 pressed */
+static uint8 testPin = 1u;
+
+static uint8 SW2_Read(void)
+{
+    return (testPin);
+}
+
+static cySysTickCallback CySysTickGetCallback(uint32 number)
+{
+    return (testCallbacks[number]);
+}
+
+static cySysTickCallback CySysTickSetCallback(uint32 number, cySysTickCallback function)
+{
+    cySysTickCallback old = testCallbacks[number];
+
+    testCallbacks[number] = function;
+    return (old);
+}
+
+#include "button.c"
+
+
+/***************************************
+*        Test Helpers
+****************************************/
+
+static uint32 testFailures;
+
+static void Test_Check(int ok, const char what[])
+{
+    printf("%s: %s\n", ok ? "pass" : "FAIL", what);
+
+    if (!ok)
+    {
+        ++testFailures;
+    }
+}
+
+/* Holds the pin at the given level for the given number of milliseconds */
+static void Test_Hold(uint8 level, uint32 ms)
+{
+    testPin = level;
+
+    while (0u != ms--)
+    {
+        testCallbacks[0u]();
+    }
+}
+
+/* Returns the number of milliseconds until the next event, up to limit */
+static uint32 Test_WaitEvent(uint8 level, uint32 limit, uint32 *event)
+{
+    uint32 ms = 0u;
+
+    testPin = level;
+    *event = Button_GetEvent();
+
+    while ((BUTTON_EVENT_NONE == *event) && (ms < limit))
+    {
+        testCallbacks[0u]();
+        ++ms;
+        *event = Button_GetEvent();
+    }
+
+    return (ms);
+}
+
+/* Takes all queued events; returns their count */
+static uint32 Test_Drain(void)
+{
+    uint32 count = 0u;
+
+    while (BUTTON_EVENT_NONE != Button_GetEvent())
+    {
+        ++count;
+    }
+
+    return (count);
+}
+
+
+/***************************************
+*        Tests
+****************************************/
+
+int main(void)
+{
+    uint32 event;
+    uint32 ms;
+    uint32 i;
+
+    Button_Start();
+    Test_Check(NULL != testCallbacks[0u], "callback registered");
+
+    Test_Hold(1u, 100u);
+    Test_Check(BUTTON_EVENT_NONE == Button_GetEvent(), "no event while released");
+
+    /* Contact bounce shorter than the debounce time is rejected */
+    for (i = 0u; i < 10u; ++i)
+    {
+        Test_Hold(0u, BUTTON_DEBOUNCE_MS - 1u);
+        Test_Hold(1u, 3u);
+    }
+    Test_Check(BUTTON_EVENT_NONE == Button_GetEvent(), "bounce rejected");
+
+    /* Short press */
+    ms = Test_WaitEvent(0u, 100u, &event);
+    Test_Check((BUTTON_EVENT_PRESS == event) && (BUTTON_DEBOUNCE_MS == ms), "press after the debounce time");
+    Test_Hold(0u, 200u);
+    Test_Check(BUTTON_EVENT_NONE == Button_GetEvent(), "no long press after 200 ms");
+
+    /* A bounce while released restarts the debounce time */
+    Test_Hold(1u, BUTTON_DEBOUNCE_MS - 1u);
+    ms = Test_WaitEvent(0u, 100u, &event);
+    Test_Check((BUTTON_EVENT_NONE == event) && (100u == ms), "release bounce rejected");
+    ms = Test_WaitEvent(1u, 100u, &event);
+    Test_Check((BUTTON_EVENT_RELEASE == event) && (BUTTON_DEBOUNCE_MS == ms), "release after the debounce time");
+
+    /* Long press: press, long press after BUTTON_LONG_PRESS_MS, release */
+    ms = Test_WaitEvent(0u, 100u, &event);
+    Test_Check(BUTTON_EVENT_PRESS == event, "long press starts with a press");
+    ms = Test_WaitEvent(0u, 2000u, &event);
+    Test_Check((BUTTON_EVENT_LONG_PRESS == event) && (BUTTON_LONG_PRESS_MS == ms), "long press timing");
+    Test_Hold(0u, 3000u);
+    Test_Check(BUTTON_EVENT_NONE == Button_GetEvent(), "long press posted once");
+    ms = Test_WaitEvent(1u, 100u, &event);
+    Test_Check(BUTTON_EVENT_RELEASE == event, "release after a long press");
+
+    /* Events beyond the queue are dropped, the queued ones kept in order */
+    for (i = 0u; i < 4u; ++i)
+    {
+        Test_Hold(0u, 50u);
+        Test_Hold(1u, 50u);
+    }
+    Test_Check((BUTTON_EVENT_PRESS == Button_GetEvent()) &&
+               (BUTTON_EVENT_RELEASE == Button_GetEvent()) &&
+               (BUTTON_EVENT_PRESS == Button_GetEvent()), "oldest events kept");
+    Test_Check(0u == Test_Drain(), "events beyond the queue dropped");
+
+    Test_Hold(0u, 50u);
+    Test_Check(BUTTON_EVENT_PRESS == Button_GetEvent(), "queue works after an overflow");
+
+    printf("%s\n", (0u == testFailures) ? "all passed" : "FAILED");
+
+    return ((0u == testFailures) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,146 @@
+/*******************************************************************************
+* File Name: dispense_test.c
+*
+* Description:
+*  Host test of the schedule runner. A stand-in clock is stepped over the
+*  schedule and the doses passed to DoseLog_Add() are counted. Build and run:
+*
+*    cc -I tools/test/stub -I SCB_UartComm01.cydsn tools/test/dispense_test.c \
+*       -o dispense_test && ./dispense_test
+*
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dispense.c"
+
+
+/***************************************
+*        Firmware Stand-ins
+****************************************/
+
+/* Sun, 18 Oct 2026 00:00:00 GMT */
+#define TEST_MIDNIGHT   (1792281600u)
+
+SCHEDULE schedule;
+
+static uint32 testTime;
+static uint32 testDoses;
+static uint32 testSlot;
+static uint32 testAmount;
+static uint32 testFailures;
+
+uint32 DoseLog_GetTime(void)
+{
+    return (testTime);
+}
+
+cystatus DoseLog_Add(uint32 slot, uint32 amount)
+{
+    ++testDoses;
+    testSlot = slot;
+    testAmount = amount;
+    return (CYRET_SUCCESS);
+}
+
+cystatus DbgLog_Write(const uint8 data[], uint32 len)
+{
+    (void) data;
+    (void) len;
+    return (CYRET_SUCCESS);
+}
+
+cystatus DbgLog_PutString(const char string[])
+{
+    (void) string;
+    return (CYRET_SUCCESS);
+}
+
+
+/***************************************
+*        Test Helpers
+****************************************/
+
+static void Test_Check(int ok, const char what[])
+{
+    printf("%s: %s\n", ok ? "pass" : "FAIL", what);
+
+    if (!ok)
+    {
+        ++testFailures;
+    }
+}
+
+/* Runs the schedule at the given time of day */
+static void Test_At(uint32 hours, uint32 minutes, uint32 seconds)
+{
+    testTime = TEST_MIDNIGHT + (((hours * 60u) + minutes) * 60u) + seconds;
+    Dispense_Process();
+}
+
+
+/***************************************
+*        Tests
+****************************************/
+
+int main(void)
+{
+    Test_Check(480u == Dispense_ParseTime("08:00"), "HH:MM");
+    Test_Check(570u == Dispense_ParseTime("9:30"), "H:MM");
+    Test_Check(DISPENSE_MIN_PER_DAY == Dispense_ParseTime(""), "empty time");
+    Test_Check(DISPENSE_MIN_PER_DAY == Dispense_ParseTime("24:00"), "hour out of range");
+    Test_Check(DISPENSE_MIN_PER_DAY == Dispense_ParseTime("08:0"), "short minutes");
+    Test_Check(DISPENSE_MIN_PER_DAY == Dispense_ParseTime("08:000"), "trailing digit");
+
+    Test_Check(200u == Dispense_ParseAmount("2"), "whole dose");
+    Test_Check(125u == Dispense_ParseAmount("1.25"), "fractional dose");
+    Test_Check(50u == Dispense_ParseAmount(".5"), "leading point");
+    Test_Check(0u == Dispense_ParseAmount(""), "empty dose");
+    Test_Check(0u == Dispense_ParseAmount("2x"), "bad dose");
+
+    (void) strcpy(schedule.entry[4].time, "08:00");
+    (void) strcpy(schedule.entry[4].dosage, "1.5");
+    (void) strcpy(schedule.entry[7].time, "08:03");
+    (void) strcpy(schedule.entry[7].dosage, "0");
+
+    /* Clock not set yet */
+    testTime = 1000u;
+    Dispense_Process();
+    Test_Check(0u == testDoses, "nothing before the clock is set");
+
+    Test_At(7u, 59u, 10u);
+    Test_At(8u, 0u, 0u);
+    Test_Check((1u == testDoses) && (4u == testSlot) && (150u == testAmount), "due entry dispensed");
+
+    Test_At(8u, 0u, 30u);
+    Test_At(8u, 0u, 59u);
+    Test_Check(1u == testDoses, "once per minute");
+
+    Test_At(8u, 5u, 0u);
+    Test_Check(1u == testDoses, "zero dosage skipped");
+
+    /* A late call still gives the dose of the skipped minute */
+    (void) strcpy(schedule.entry[7].dosage, "3");
+    Test_At(8u, 10u, 0u);
+    Test_At(8u, 15u, 0u);
+    Test_At(8u, 0u, 0u);
+    Test_Check(1u == testDoses, "clock step back not caught up");
+    Test_At(8u, 2u, 0u);
+    Test_At(8u, 5u, 0u);
+    Test_Check((2u == testDoses) && (7u == testSlot), "skipped minute caught up");
+
+    /* Wrap over midnight */
+    (void) strcpy(schedule.entry[0].time, "00:00");
+    (void) strcpy(schedule.entry[0].dosage, "1");
+    Test_At(23u, 59u, 0u);
+    Test_At(0u, 1u, 0u);
+    Test_Check((3u == testDoses) && (0u == testSlot), "midnight caught up");
+
+    printf("%s\n", (0u == testFailures) ? "all passed" : "FAILED");
+
+    return ((0u == testFailures) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,112 @@
+/*******************************************************************************
+* File Name: fmt_test.c
+*
+* Description:
+*  Host test of the integer formatting routines. Decimal and hex output is
+*  compared with the C library printf for edge values. Build and run:
+*
+*    cc -I tools/test/stub -I SCB_UartComm01.cydsn tools/test/fmt_test.c \
+*       -o fmt_test && ./fmt_test
+*
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fmt.c"
+
+
+/***************************************
+*        Test Values
+****************************************/
+
+static const uint32 testValues[] =
+{
+    0u, 1u, 9u, 10u, 99u, 100u, 999u, 1000u, 12345u, 65535u, 65536u,
+    999999999u, 1000000000u, 2147483647u, 2147483648u, 4294967295u,
+};
+
+#define TEST_VALUES     (sizeof(testValues) / sizeof(testValues[0]))
+
+static uint32 testFailures;
+
+
+/***************************************
+*        Test Helpers
+****************************************/
+
+/* Compares a result and its returned length with the expected text */
+static void Test_Expect(const char got[], uint32 len, const char expected[], const char what[])
+{
+    if ((0 != strcmp(got, expected)) || (len != strlen(expected)))
+    {
+        printf("FAIL: %s: \"%s\" (%u), expected \"%s\"\n", what, got, (unsigned) len, expected);
+        ++testFailures;
+    }
+}
+
+
+/***************************************
+*        Tests
+****************************************/
+
+int main(void)
+{
+    char got[FMT_FIXED_SIZE + 8u];
+    char expected[32];
+    uint32 len;
+    uint32 i;
+
+    for (i = 0u; i < TEST_VALUES; ++i)
+    {
+        len = Fmt_Dec(got, testValues[i]);
+        (void) sprintf(expected, "%lu", (unsigned long) testValues[i]);
+        Test_Expect(got, len, expected, "Fmt_Dec");
+
+        len = Fmt_DecPad(got, testValues[i], 4u);
+        (void) sprintf(expected, "%04lu", (unsigned long) testValues[i]);
+        Test_Expect(got, len, expected, "Fmt_DecPad 4");
+
+        len = Fmt_DecPad(got, testValues[i], 12u);
+        (void) sprintf(expected, "%012lu", (unsigned long) testValues[i]);
+        Test_Expect(got, len, expected, "Fmt_DecPad 12");
+
+        len = Fmt_Hex(got, testValues[i], 0u);
+        (void) sprintf(expected, "%lX", (unsigned long) testValues[i]);
+        Test_Expect(got, len, expected, "Fmt_Hex");
+
+        len = Fmt_Hex(got, testValues[i], 8u);
+        (void) sprintf(expected, "%08lX", (unsigned long) testValues[i]);
+        Test_Expect(got, len, expected, "Fmt_Hex 8");
+    }
+
+    len = Fmt_Fixed(got, 0, 2u);
+    Test_Expect(got, len, "0.00", "Fmt_Fixed zero");
+    len = Fmt_Fixed(got, 5, 2u);
+    Test_Expect(got, len, "0.05", "Fmt_Fixed below one");
+    len = Fmt_Fixed(got, -5, 2u);
+    Test_Expect(got, len, "-0.05", "Fmt_Fixed negative below one");
+    len = Fmt_Fixed(got, 1250, 2u);
+    Test_Expect(got, len, "12.50", "Fmt_Fixed dose");
+    len = Fmt_Fixed(got, -1250, 2u);
+    Test_Expect(got, len, "-12.50", "Fmt_Fixed negative");
+    len = Fmt_Fixed(got, 42, 0u);
+    Test_Expect(got, len, "42", "Fmt_Fixed no decimals");
+    len = Fmt_Fixed(got, -2147483647 - 1, 2u);
+    Test_Expect(got, len, "-21474836.48", "Fmt_Fixed minimum");
+
+    len = Fmt_Bcd(got, 0x2014u, 4u);
+    Test_Expect(got, len, "2014", "Fmt_Bcd year");
+    len = Fmt_Bcd(got, 0x59u, 2u);
+    Test_Expect(got, len, "59", "Fmt_Bcd minutes");
+    len = Fmt_Bcd(got, 0x07u, 2u);
+    Test_Expect(got, len, "07", "Fmt_Bcd leading zero");
+
+    printf("%s\n", (0u == testFailures) ? "all passed" : "FAILED");
+
+    return ((0u == testFailures) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/* [] END OF FILE */
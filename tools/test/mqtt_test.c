@@ -0,0 +1,188 @@
+/*******************************************************************************
+* File Name: mqtt_test.c
+*
+* Description:
+*  Host test of the MQTT receive path. A stand-in AT link replays what the
+*  ESP8266 sends while Esp_Send() waits for "SEND OK" through the registered
+*  data sink, the way Esp_ReadUntil() does, and the rest through
+*  Esp_ReadByte(). Build and run:
+*
+*    cc -I tools/test/stub -I SCB_UartComm01.cydsn tools/test/mqtt_test.c \
+*       -o mqtt_test && ./mqtt_test
+*
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mqtt.c"
+
+
+/***************************************
+*        Firmware Stand-ins
+****************************************/
+
+static espDataSink testSink;
+static const uint8 *testDuringSend;
+static uint32 testDuringSendLen;
+static const uint8 *testAfter;
+static uint32 testAfterLen;
+static uint32 testSends;
+static uint32 testLastType;
+static uint32 testCloses;
+static uint32 testMessages;
+static uint32 testFailures;
+
+void Esp_SetDataSink(espDataSink sink)
+{
+    testSink = sink;
+}
+
+cystatus Esp_Connect(const char host[], uint32 port)
+{
+    (void) host;
+    (void) port;
+    return (ESP_TOKEN_SUCCESS);
+}
+
+/* Bytes that arrive before "SEND OK" go to the sink only */
+cystatus Esp_Send(const uint8 data[], uint32 len)
+{
+    uint32 i;
+
+    (void) len;
+    ++testSends;
+    testLastType = data[0];
+
+    for (i = 0u; (i < testDuringSendLen) && (NULL != testSink); ++i)
+    {
+        (void) testSink(testDuringSend[i]);
+    }
+    testDuringSendLen = 0u;
+
+    return (ESP_TOKEN_SUCCESS);
+}
+
+cystatus Esp_Command(const char command[], const char success[], const char fail[], uint32 timeoutMs)
+{
+    (void) success;
+    (void) fail;
+    (void) timeoutMs;
+
+    if (0 == strcmp(command, "AT+CIPCLOSE"))
+    {
+        ++testCloses;
+    }
+    return (ESP_TOKEN_SUCCESS);
+}
+
+cystatus Esp_ReadByte(uint8 *byte, uint32 timeoutMs)
+{
+    (void) timeoutMs;
+
+    if (0u == testAfterLen)
+    {
+        return (CYRET_TIMEOUT);
+    }
+
+    *byte = *testAfter++;
+    --testAfterLen;
+    return (CYRET_SUCCESS);
+}
+
+uint32 SysTime_GetMs(void)
+{
+    return (0u);
+}
+
+/* Every wait times out after one poll */
+uint32 SysTime_Elapsed(uint32 sinceMs)
+{
+    (void) sinceMs;
+    return ((0u == testAfterLen) ? MQTT_TIMEOUT_MS : 0u);
+}
+
+cystatus DbgLog_Write(const uint8 data[], uint32 len)
+{
+    (void) data;
+    (void) len;
+    return (CYRET_SUCCESS);
+}
+
+cystatus DbgLog_PutString(const char string[])
+{
+    (void) string;
+    return (CYRET_SUCCESS);
+}
+
+
+/***************************************
+*        Test Helpers
+****************************************/
+
+static void Test_Check(int ok, const char what[])
+{
+    printf("%s: %s\n", ok ? "pass" : "FAIL", what);
+
+    if (!ok)
+    {
+        ++testFailures;
+    }
+}
+
+static void Test_Message(const char topic[], uint32 topicLen, const uint8 payload[], uint32 len)
+{
+    (void) topic;
+    (void) topicLen;
+    (void) payload;
+    (void) len;
+    ++testMessages;
+}
+
+
+/***************************************
+*        Tests
+****************************************/
+
+int main(void)
+{
+    static const uint8 connack[] = "\r\n+IPD,4:\x20\x02\x00\x00";
+    static const uint8 suback[] = "\r\n+IPD,5:\x90\x03\x00\x01\x00";
+    static const uint8 publish[] = "\r\n+IPD,9:\x30\x07\x00\x03" "a/1" "xy";
+    static const uint8 badLength[] = "\r\n+IPD,6:\x30\xFF\xFF\xFF\xFF\x01";
+
+    Mqtt_Start("broker:1884", "test", Test_Message);
+    Test_Check(1884u == mqttPort, "port parsed");
+
+    /* CONNACK ahead of SEND OK */
+    testDuringSend = connack;
+    testDuringSendLen = sizeof(connack) - 1u;
+    Test_Check(CYRET_SUCCESS == Mqtt_Connect(), "CONNACK during CIPSEND accepted");
+    Test_Check(NULL != testSink, "sink registered for the session");
+
+    /* SUBACK and a pushed PUBLISH in the same wait */
+    testDuringSend = suback;
+    testDuringSendLen = sizeof(suback) - 1u;
+    Test_Check(CYRET_SUCCESS == Mqtt_Subscribe("a/+"), "SUBACK during CIPSEND accepted");
+
+    testAfter = publish;
+    testAfterLen = sizeof(publish) - 1u;
+    Mqtt_Process();
+    Test_Check(1u == testMessages, "PUBLISH delivered");
+
+    /* Five length bytes */
+    testSends = 0u;
+    testAfter = badLength;
+    testAfterLen = sizeof(badLength) - 1u;
+    Mqtt_Process();
+    Test_Check((0u == Mqtt_IsConnected()) && (1u == testSends) && (MQTT_DISCONNECT == testLastType) &&
+               (1u == testCloses), "overlong remaining length disconnects");
+    Test_Check(NULL == testSink, "sink released");
+
+    printf("%s\n", (0u == testFailures) ? "all passed" : "FAILED");
+
+    return ((0u == testFailures) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/* [] END OF FILE */
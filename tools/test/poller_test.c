@@ -0,0 +1,237 @@
+/*******************************************************************************
+* File Name: poller_test.c
+*
+* Description:
+*  Host test of the poller response path. Captured ESP8266 output for a poll
+*  ("+IPD,<n>:" frames around the HTTP response, then "CLOSED") is returned by
+*  a stand-in Esp_Receive() and run through Poller_Fetch(), which has to
+*  find the body and update the schedule. Build and run once per format:
+*
+*    cc -I tools/test/stub -I SCB_UartComm01.cydsn tools/test/poller_test.c \
+*       -o poller_test && ./poller_test
+*    cc -DPOLLER_USE_CSV=0 -I tools/test/stub -I SCB_UartComm01.cydsn \
+*       tools/test/poller_test.c -o poller_test && ./poller_test
+*
+*******************************************************************************/
+
+#define PROF_ENABLED    (0u)
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "poller.c"
+#include "fmt.c"
+
+
+/***************************************
+*        Captured Responses
+****************************************/
+
+#define TEST_HEADERS    "HTTP/1.1 200 OK\r\n" \
+                        "Date: Sun, 18 Oct 2026 10:00:00 GMT\r\n" \
+                        "Content-Type: text/plain; charset=utf-8\r\n" \
+                        "Connection: close\r\n" \
+                        "Status: 200 OK\r\n"
+
+/* The ESP8266 passes the TCP segments on as they arrive; here the blank
+* line that ends the headers is split over two frames.
+*/
+#if (POLLER_USE_CSV)
+static const char * const testFrames[] =
+{
+    TEST_HEADERS "\r",
+    "\ncreated_at,entry_id,field1,field2,field3,field4,field5,field6\n"
+    "2026-10-18 09:58:12 UTC,57,08:00,2,12:30,1,20:15,3\n",
+    NULL,
+};
+#else
+static const char * const testFrames[] =
+{
+    TEST_HEADERS "\r",
+    "\n{\"created_at\":\"2026-10-18T09:58:12Z\",\"entry_id\":57,"
+    "\"field1\":\"08:00\",\"field2\":\"2\",\"field3\":\"12:30\","
+    "\"field4\":\"1\",\"field5\":\"20:15\",\"field6\":\"3\"}",
+    NULL,
+};
+#endif /* (POLLER_USE_CSV) */
+
+
+/***************************************
+*        Firmware Stand-ins
+****************************************/
+
+SCHEDULE schedule;
+
+static char testCapture[POLLER_RESPONSE_SIZE];
+static uint32 testCaptureLen;
+static char testRequest[POLLER_REQUEST_SIZE + 1u];
+static char testDate[64];
+static uint32 testFailures;
+
+cystatus Esp_Connect(const char host[], uint32 port)
+{
+    (void) host;
+    (void) port;
+    return (ESP_TOKEN_SUCCESS);
+}
+
+cystatus Esp_Send(const uint8 data[], uint32 len)
+{
+    (void) memcpy(testRequest, data, len);
+    testRequest[len] = 0;
+    return (ESP_TOKEN_SUCCESS);
+}
+
+cystatus Esp_Receive(uint8 buffer[], uint32 size, uint32 *len, const char token[], uint32 timeoutMs)
+{
+    (void) token;
+    (void) timeoutMs;
+    *len = (testCaptureLen < size) ? testCaptureLen : size;
+    (void) memcpy(buffer, testCapture, *len);
+    return (ESP_TOKEN_SUCCESS);
+}
+
+cystatus Esp_Command(const char command[], const char success[], const char fail[], uint32 timeoutMs)
+{
+    (void) command;
+    (void) success;
+    (void) fail;
+    (void) timeoutMs;
+    return (ESP_TOKEN_SUCCESS);
+}
+
+uint32 CfgStore_Read(uint32 key, uint8 buffer[], uint32 size)
+{
+    (void) key;
+    (void) size;
+    buffer[0] = 0u;
+    return (0u);
+}
+
+uint32 ClkGov_SetLevel(uint32 level)
+{
+    return (level);
+}
+
+uint32 SysTime_GetMs(void)
+{
+    return (0u);
+}
+
+uint32 SysTime_Elapsed(uint32 sinceMs)
+{
+    (void) sinceMs;
+    return (0u);
+}
+
+cystatus DbgLog_Write(const uint8 data[], uint32 len)
+{
+    (void) data;
+    (void) len;
+    return (CYRET_SUCCESS);
+}
+
+cystatus DbgLog_PutString(const char string[])
+{
+    (void) string;
+    return (CYRET_SUCCESS);
+}
+
+void DoseLog_SetTimeHttp(const char date[], uint32 len)
+{
+    uint32 i;
+
+    for (i = 0u; (i < len) && (i < (sizeof(testDate) - 1u)) && ('\r' != date[i]); ++i)
+    {
+        testDate[i] = date[i];
+    }
+    testDate[i] = 0;
+}
+
+
+/***************************************
+*        Test Helpers
+****************************************/
+
+/* Builds what the ESP8266 sends after SEND OK for the given frames */
+static void Test_Capture(const char * const frames[])
+{
+    uint32 i;
+
+    testCaptureLen = 0u;
+
+    for (i = 0u; NULL != frames[i]; ++i)
+    {
+        testCaptureLen += (uint32) sprintf(&testCapture[testCaptureLen], "\r\n+IPD,%u:%s",
+                                           (unsigned) strlen(frames[i]), frames[i]);
+    }
+
+    testCaptureLen += (uint32) sprintf(&testCapture[testCaptureLen], "CLOSED");
+}
+
+static void Test_Check(int ok, const char what[])
+{
+    printf("%s: %s\n", ok ? "pass" : "FAIL", what);
+
+    if (!ok)
+    {
+        ++testFailures;
+    }
+}
+
+static int Test_Slot(uint32 entry, const char time[], const char dosage[])
+{
+    return ((0 == strcmp(schedule.entry[entry].time, time)) &&
+            (0 == strcmp(schedule.entry[entry].dosage, dosage)));
+}
+
+
+/***************************************
+*        Tests
+****************************************/
+
+int main(void)
+{
+    const char * const oneFrame[] = { TEST_HEADERS "\r\n" "0,", NULL };
+    char joined[POLLER_RESPONSE_SIZE];
+    uint32 i;
+
+    Poller_Start();
+
+    Test_Capture(testFrames);
+    Test_Check(POLLER_UPDATED == Poller_Fetch(1u), "captured response updates the schedule");
+    Test_Check(NULL != strstr(testRequest, " HTTP/1.0\r\n"), "request is HTTP/1.0");
+    Test_Check(57u == schedule.entryId[1], "entry_id taken");
+    Test_Check(Test_Slot(3u, "08:00", "2") && Test_Slot(4u, "12:30", "1") &&
+               Test_Slot(5u, "20:15", "3"), "fields mapped to the channel's slots");
+    Test_Check(0 == strcmp(testDate, "Sun, 18 Oct 2026 10:00:00 GMT"), "Date header found");
+
+    Test_Check(POLLER_UNCHANGED == Poller_Fetch(1u), "same entry again is unchanged");
+
+    /* A response without a body must not be applied */
+    Test_Capture(oneFrame);
+    Test_Check(CYRET_BAD_DATA == Poller_Fetch(2u), "headers only is bad data");
+
+    /* Unframing joins the payloads and drops everything else */
+    Test_Capture(testFrames);
+    (void) memcpy(joined, testCapture, testCaptureLen);
+    i = Poller_Unframe(joined, testCaptureLen);
+    Test_Check((i == (strlen(testFrames[0]) + strlen(testFrames[1]))) &&
+               (0 == memcmp(joined, testFrames[0], strlen(testFrames[0]))) &&
+               (0 == memcmp(&joined[strlen(testFrames[0])], testFrames[1], strlen(testFrames[1]))),
+               "frames joined");
+
+    /* A capture cut short by the buffer keeps what was stored */
+    i = Poller_Unframe(joined, 0u);
+    Test_Check(0u == i, "empty capture");
+    (void) memcpy(joined, testCapture, 40u);
+    i = Poller_Unframe(joined, 40u);
+    Test_Check(i == (40u - (uint32) ((strchr(testCapture, ':') + 1) - testCapture)), "truncated frame");
+
+    printf("%s\n", (0u == testFailures) ? "all passed" : "FAILED");
+
+    return ((0u == testFailures) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/* [] END OF FILE */
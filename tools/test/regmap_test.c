@@ -0,0 +1,227 @@
+/*******************************************************************************
+* File Name: regmap_test.c
+*
+* Description:
+*  Host test of the I2C register map and the time base behind it. Master
+*  writes are passed to RegMap_Write() as the I2C slave would receive them
+*  and the read buffer is checked; the SysTick callback is called directly
+*  to advance the clock. Build and run:
+*
+*    cc -I tools/test/stub -I SCB_UnconfiguredComm01.cydsn \
+*       tools/test/regmap_test.c -o regmap_test && ./regmap_test
+*
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <project.h>
+
+
+/***************************************
+*        Firmware Stand-ins
+****************************************/
+
+#define CY_SYS_SYST_NUM_OF_CALLBACKS    (5u)
+
+#define Comm_I2C_SSTAT_RD_ERR           (0x08u)
+#define Comm_I2C_SSTAT_WR_ERR           (0x80u)
+#define Comm_I2C_SSTAT_WR_OVFL          (0x40u)
+#define Comm_INTR_RX_OVERFLOW           (0x20u)
+#define Comm_INTR_RX_FRAME_ERROR        (0x100u)
+#define Comm_INTR_RX_PARITY_ERROR       (0x200u)
+
+typedef void (*cySysTickCallback)(void);
+
+static uint32 cydelayFreqHz = 24000000u;
+
+static cySysTickCallback testCallbacks[CY_SYS_SYST_NUM_OF_CALLBACKS];
+static uint32 testReload;
+
+static void CySysTickStart(void)
+{
+}
+
+static void CySysTickClear(void)
+{
+}
+
+static void CySysTickSetReload(uint32 value)
+{
+    testReload = value;
+}
+
+static cySysTickCallback CySysTickGetCallback(uint32 number)
+{
+    return (testCallbacks[number]);
+}
+
+static cySysTickCallback CySysTickSetCallback(uint32 number, cySysTickCallback function)
+{
+    cySysTickCallback old = testCallbacks[number];
+
+    testCallbacks[number] = function;
+    return (old);
+}
+
+static uint8 CyEnterCriticalSection(void)
+{
+    return (0u);
+}
+
+static void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+    (void) savedIntrStatus;
+}
+
+#include "systime.c"
+#include "regmap.c"
+
+
+/***************************************
+*        Test Helpers
+****************************************/
+
+static uint32 testFailures;
+
+static void Test_Check(int ok, const char what[])
+{
+    printf("%s: %s\n", ok ? "pass" : "FAIL", what);
+
+    if (!ok)
+    {
+        ++testFailures;
+    }
+}
+
+/* Advances the time base by the given number of milliseconds */
+static void Test_Run(uint32 ms)
+{
+    while (0u != ms--)
+    {
+        testCallbacks[0u]();
+    }
+}
+
+/* Master write of a sub-address followed by up to four data bytes */
+static void Test_Write(uint32 addr, const uint8 data[], uint32 size)
+{
+    uint8 frame[5u];
+
+    frame[0u] = (uint8) (REGMAP_SUBADDR_FLAG | addr);
+    if (0u != size)
+    {
+        (void) memcpy(&frame[1u], data, size);
+    }
+
+    RegMap_Write(frame, size + 1u);
+}
+
+/* Master read of one byte at the given sub-address */
+static uint32 Test_Read8(uint32 addr)
+{
+    uint32 size;
+    const uint8 *buf;
+
+    Test_Write(addr, NULL, 0u);
+    buf = RegMap_GetReadBuf(&size);
+
+    return ((0u != size) ? buf[0u] : 0xFFFFu);
+}
+
+/* Master read of a little-endian 32-bit register at the given sub-address */
+static uint32 Test_Read32(uint32 addr)
+{
+    uint32 size;
+    const uint8 *buf;
+
+    Test_Write(addr, NULL, 0u);
+    buf = RegMap_GetReadBuf(&size);
+
+    return ((uint32) buf[0u] | ((uint32) buf[1u] << 8u) |
+            ((uint32) buf[2u] << 16u) | ((uint32) buf[3u] << 24u));
+}
+
+
+/***************************************
+*        Tests
+****************************************/
+
+int main(void)
+{
+    static const uint8 entry[4u] = { 0xE0u, 0x01u, 0x34u, 0x12u };
+    static const uint8 badTime[4u] = { 0x60u, 0x00u, 0x12u, 0x00u };
+    static const uint8 newTime[4u] = { 0x58u, 0x59u, 0x23u, 0x00u };
+    static const uint8 clearBus[1u] = { REGMAP_I2C_ERR_BUS };
+    static const uint8 idWrite[1u] = { 0x00u };
+    uint32 time;
+    uint32 dosage;
+    uint32 size;
+    uint32 i;
+
+    SysTime_Start();
+    RegMap_Init();
+
+    Test_Check(testReload == ((cydelayFreqHz / 1000u) - 1u), "SysTick reload for 1 ms");
+    Test_Check(Test_Read8(REGMAP_ID_ADDR) == REGMAP_ID, "identification register");
+    Test_Check(Test_Read8(REGMAP_VERSION_ADDR) == REGMAP_VERSION, "version register");
+    Test_Check(Test_Read8(REGMAP_ENTRIES_ADDR) == REGMAP_ENTRIES, "entry count register");
+
+    (void) RegMap_GetReadBuf(&size);
+    Test_Check(size == (REGMAP_SIZE - REGMAP_ENTRIES_ADDR), "read buffer runs to the end of the map");
+
+    for (i = 0u; i < REGMAP_ENTRIES; ++i)
+    {
+        if (CYRET_EMPTY != RegMap_GetEntry(i, &time, &dosage))
+        {
+            break;
+        }
+    }
+    Test_Check(i == REGMAP_ENTRIES, "all entries empty after init");
+
+    /* Schedule entry 2: 08:00, dosage 0x1234 */
+    Test_Write(REGMAP_SCHED_ADDR + (2u * REGMAP_ENTRY_SIZE), entry, sizeof(entry));
+    Test_Check((CYRET_SUCCESS == RegMap_GetEntry(2u, &time, &dosage)) &&
+               (480u == time) && (0x1234u == dosage), "entry written by the master");
+    Test_Check(CYRET_BAD_PARAM == RegMap_GetEntry(REGMAP_ENTRIES, &time, &dosage), "entry index checked");
+    Test_Check(CYRET_BAD_PARAM == RegMap_SetEntry(0u, REGMAP_MINUTES_PER_DAY, 1u), "entry time checked");
+
+    Test_Write(REGMAP_ID_ADDR, idWrite, sizeof(idWrite));
+    Test_Check(Test_Read8(REGMAP_ID_ADDR) == REGMAP_ID, "identification register is read-only");
+
+    /* Time of day and uptime */
+    Test_Run(1500u);
+    Test_Check(Test_Read32(REGMAP_TIME_ADDR) == 0x000001u, "time advances");
+    Test_Check(Test_Read32(REGMAP_UPTIME_ADDR) == 1u, "uptime in seconds");
+
+    Test_Write(REGMAP_TIME_ADDR, newTime, sizeof(newTime));
+    Test_Check(Test_Read32(REGMAP_TIME_ADDR) == 0x235958u, "time set by the master");
+    Test_Write(REGMAP_TIME_ADDR, badTime, sizeof(badTime));
+    Test_Check(Test_Read32(REGMAP_TIME_ADDR) == 0x235958u, "invalid BCD time ignored");
+
+    Test_Run(2000u);
+    Test_Check(Test_Read32(REGMAP_TIME_ADDR) == 0x000000u, "time wraps at midnight");
+
+    /* Sticky error flags, write 1 to clear */
+    RegMap_AddI2cErrors(Comm_I2C_SSTAT_WR_ERR | Comm_I2C_SSTAT_WR_OVFL);
+    RegMap_AddUartErrors(Comm_INTR_RX_FRAME_ERROR);
+    RegMap_AddI2cErrors(0u);
+    Test_Check(Test_Read8(REGMAP_I2C_ERR_ADDR) == (REGMAP_I2C_ERR_BUS | REGMAP_I2C_ERR_WR_OVFL), "I2C error flags");
+    Test_Check(Test_Read8(REGMAP_UART_ERR_ADDR) == REGMAP_UART_ERR_FRAME, "UART error flags");
+    Test_Check(Test_Read8(REGMAP_ERR_COUNT_ADDR) == 2u, "error events counted");
+
+    Test_Write(REGMAP_I2C_ERR_ADDR, clearBus, sizeof(clearBus));
+    Test_Check(Test_Read8(REGMAP_I2C_ERR_ADDR) == REGMAP_I2C_ERR_WR_OVFL, "write 1 clears an error flag");
+    Test_Check(Test_Read8(REGMAP_ERR_COUNT_ADDR) == 2u, "error count kept on clear");
+
+    /* Writes past the end of the map are dropped */
+    Test_Write(REGMAP_SIZE - 1u, entry, sizeof(entry));
+    Test_Check(Test_Read8(REGMAP_SIZE - 1u) == entry[0u], "last register written");
+
+    printf("%s\n", (0u == testFailures) ? "all passed" : "FAILED");
+
+    return ((0u == testFailures) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,33 @@
+/*******************************************************************************
+* File Name: Comm_PVT.h
+*
+* Description:
+*  Host build stand-in for the private header of the Comm SCB in
+*  Unconfigured mode: the software buffers passed in the configuration
+*  structure and the interrupt source registers. The test defines them.
+*
+*******************************************************************************/
+
+#if !defined(CY_SCB_PVT_Comm_H)
+#define CY_SCB_PVT_Comm_H
+
+#include <project.h>
+
+#define Comm_INTR_RX_OVERFLOW   (0x20u)
+#define Comm_INTR_TX_NOT_FULL   (0x02u)
+
+extern volatile uint8 * Comm_rxBuffer;
+extern uint32  Comm_rxBufferSize;
+extern volatile uint8 * Comm_txBuffer;
+extern uint32  Comm_txBufferSize;
+
+extern volatile uint32 Comm_INTR_TX_MASK_REG;
+
+void  Comm_ClearTxInterruptSource(uint32 interruptSource);
+uint8 CyEnterCriticalSection(void);
+void  CyExitCriticalSection(uint8 savedIntrStatus);
+
+#endif /* (CY_SCB_PVT_Comm_H) */
+
+
+/* [] END OF FILE */
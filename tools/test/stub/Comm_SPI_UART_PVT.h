@@ -0,0 +1,29 @@
+/*******************************************************************************
+* File Name: Comm_SPI_UART_PVT.h
+*
+* Description:
+*  Host build stand-in for the private SPI/UART header of the Comm SCB in
+*  Unconfigured mode: the ring sizes and indexes of the software buffers.
+*  The test defines them.
+*
+*******************************************************************************/
+
+#if !defined(CY_SCB_SPI_UART_PVT_Comm_H)
+#define CY_SCB_SPI_UART_PVT_Comm_H
+
+#include <Comm_PVT.h>
+
+#define Comm_INTERNAL_RX_BUFFER_SIZE    (Comm_rxBufferSize + 1u)
+#define Comm_TX_BUFFER_SIZE             (Comm_txBufferSize)
+
+extern volatile uint32  Comm_rxBufferHead;
+extern volatile uint32  Comm_rxBufferTail;
+extern volatile uint8   Comm_rxBufferOverflow;
+
+extern volatile uint32  Comm_txBufferHead;
+extern volatile uint32  Comm_txBufferTail;
+
+#endif /* (CY_SCB_SPI_UART_PVT_Comm_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,2 @@
+/* Host build stand-in: the firmware types come from project.h */
+#include <project.h>
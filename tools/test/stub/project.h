@@ -0,0 +1,43 @@
+/*******************************************************************************
+* File Name: project.h
+*
+* Description:
+*  Host build stand-in for the PSoC Creator project header: the basic types
+*  and status codes that the firmware modules under test use.
+*
+*******************************************************************************/
+
+#if !defined(CY_PROJECT_H)
+#define CY_PROJECT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+typedef uint8_t  uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+typedef int8_t   int8;
+typedef int16_t  int16;
+typedef int32_t  int32;
+typedef uint32   cystatus;
+
+#define CYRET_SUCCESS           (0x00u)
+#define CYRET_BAD_PARAM         (0x01u)
+#define CYRET_LOCKED            (0x04u)
+#define CYRET_EMPTY             (0x05u)
+#define CYRET_BAD_DATA          (0x06u)
+#define CYRET_STARTED           (0x07u)
+#define CYRET_FINISHED          (0x08u)
+#define CYRET_TIMEOUT           (0x10u)
+#define CYRET_INVALID_STATE     (0x20u)
+
+#define CY_FLASH_SIZEOF_ROW     (128u)
+
+#define UART_SCB_IRQ_INTERNAL   (0u)
+
+#endif /* (CY_PROJECT_H) */
+
+
+/* [] END OF FILE */
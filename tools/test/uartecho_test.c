@@ -0,0 +1,232 @@
+/*******************************************************************************
+* File Name: uartecho_test.c
+*
+* Description:
+*  Host test of the block-mode UART echo. The Comm RX and TX software
+*  buffers are driven by a model of the component's interrupt handler:
+*  received bytes go into the RX ring or are dropped when it is full, and
+*  the TX ring is drained into the line while TX NOT_FULL is enabled. Random
+*  traffic is run through rings of several sizes and the echoed stream must
+*  equal the bytes the RX ring accepted, in order. Build and run:
+*
+*    cc -I tools/test/stub -I SCB_UnconfiguredComm01.cydsn \
+*       tools/test/uartecho_test.c -o uartecho_test && ./uartecho_test
+*
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "uartecho.c"
+
+
+/***************************************
+*        Firmware Stand-ins
+****************************************/
+
+#define TEST_RING_MAX   (64u)
+#define TEST_BYTES      (20000u)
+
+volatile uint8 * Comm_rxBuffer;
+uint32  Comm_rxBufferSize;
+volatile uint8 * Comm_txBuffer;
+uint32  Comm_txBufferSize;
+
+volatile uint32 Comm_INTR_TX_MASK_REG;
+
+volatile uint32 Comm_rxBufferHead;
+volatile uint32 Comm_rxBufferTail;
+volatile uint8  Comm_rxBufferOverflow;
+volatile uint32 Comm_txBufferHead;
+volatile uint32 Comm_txBufferTail;
+
+static uint8 testRxRing[TEST_RING_MAX + 1u];
+static uint8 testTxRing[TEST_RING_MAX];
+
+void Comm_ClearTxInterruptSource(uint32 interruptSource)
+{
+    (void) interruptSource;
+}
+
+uint8 CyEnterCriticalSection(void)
+{
+    return (0u);
+}
+
+void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+    (void) savedIntrStatus;
+}
+
+
+/***************************************
+*        Test Helpers
+****************************************/
+
+static uint32 testFailures;
+
+/* Bytes accepted by the RX ring and bytes put on the TX line, in order */
+static uint8  testAccepted[TEST_BYTES];
+static uint8  testEchoed[TEST_BYTES];
+static uint32 testAcceptedCount;
+static uint32 testEchoedCount;
+static uint32 testDropped;
+
+static uint32 testSeed = 1u;
+
+static void Test_Check(int ok, const char what[])
+{
+    printf("%s: %s\n", ok ? "pass" : "FAIL", what);
+
+    if (!ok)
+    {
+        ++testFailures;
+    }
+}
+
+static uint32 Test_Random(uint32 limit)
+{
+    testSeed = (testSeed * 1103515245u) + 12345u;
+    return ((testSeed >> 16u) % limit);
+}
+
+/* RX part of the component interrupt handler: one byte from the FIFO */
+static void Test_RxIsr(uint8 data)
+{
+    uint32 locHead = Comm_rxBufferHead + 1u;
+
+    if (Comm_INTERNAL_RX_BUFFER_SIZE == locHead)
+    {
+        locHead = 0u;
+    }
+
+    if (locHead == Comm_rxBufferTail)
+    {
+        Comm_rxBufferOverflow = (uint8) Comm_INTR_RX_OVERFLOW;
+        ++testDropped;
+    }
+    else
+    {
+        Comm_rxBuffer[locHead] = data;
+        Comm_rxBufferHead = locHead;
+        testAccepted[testAcceptedCount++] = data;
+    }
+}
+
+/* TX part of the component interrupt handler: up to fifo bytes to the line */
+static void Test_TxIsr(uint32 fifo)
+{
+    uint32 locTail;
+
+    while ((0u != (Comm_INTR_TX_MASK_REG & Comm_INTR_TX_NOT_FULL)) && (0u != fifo--))
+    {
+        if (Comm_txBufferHead != Comm_txBufferTail)
+        {
+            locTail = Comm_txBufferTail + 1u;
+
+            if (Comm_TX_BUFFER_SIZE == locTail)
+            {
+                locTail = 0u;
+            }
+
+            testEchoed[testEchoedCount++] = Comm_txBuffer[locTail];
+            Comm_txBufferTail = locTail;
+        }
+        else
+        {
+            Comm_INTR_TX_MASK_REG &= ~(uint32) Comm_INTR_TX_NOT_FULL;
+        }
+    }
+}
+
+/* Runs random traffic through rings of the given sizes. Per pass up to
+* rxBurst bytes arrive and up to txBurst bytes leave; with skip not 0 the
+* main loop misses about one pass in skip.
+*/
+static void Test_Run(uint32 rxSize, uint32 txSize, uint32 rxBurst, uint32 txBurst, uint32 skip,
+                     const char what[])
+{
+    uint32 sent = 0u;
+    uint32 moved = 0u;
+    uint32 overflow = 0u;
+    uint32 i;
+
+    Comm_rxBuffer = testRxRing;
+    Comm_rxBufferSize = rxSize;
+    Comm_txBuffer = testTxRing;
+    Comm_txBufferSize = txSize;
+    Comm_rxBufferHead = 0u;
+    Comm_rxBufferTail = 0u;
+    Comm_rxBufferOverflow = 0u;
+    Comm_txBufferHead = 0u;
+    Comm_txBufferTail = 0u;
+    Comm_INTR_TX_MASK_REG = 0u;
+
+    testAcceptedCount = 0u;
+    testEchoedCount = 0u;
+    testDropped = 0u;
+
+    while (sent < TEST_BYTES)
+    {
+        for (i = Test_Random(rxBurst + 1u); (0u != i) && (sent < TEST_BYTES); --i)
+        {
+            /* All byte values, 0x00 included */
+            Test_RxIsr((uint8) Test_Random(256u));
+            ++sent;
+        }
+
+        if ((0u == skip) || (0u != Test_Random(skip)))
+        {
+            moved += UartEcho_Process();
+        }
+
+        Test_TxIsr(Test_Random(txBurst + 1u));
+        overflow |= UartEcho_TakeOverflow();
+    }
+
+    /* Let the echo catch up */
+    for (i = 0u; i < TEST_BYTES; ++i)
+    {
+        moved += UartEcho_Process();
+        Test_TxIsr(txBurst);
+    }
+
+    printf("%s: %u sent, %u dropped, %u echoed\n", what, (unsigned) sent,
+           (unsigned) testDropped, (unsigned) testEchoedCount);
+
+    Test_Check((testEchoedCount == testAcceptedCount) &&
+               (0 == memcmp(testEchoed, testAccepted, testEchoedCount)), "echo keeps the order");
+    Test_Check((testEchoedCount + testDropped) == sent, "every byte echoed or dropped");
+    Test_Check(moved == testEchoedCount, "moved count");
+    Test_Check(overflow == ((0u != testDropped) ? Comm_INTR_RX_OVERFLOW : 0u), "overflow reported");
+    Test_Check(0u == UartEcho_TakeOverflow(), "overflow cleared");
+    Test_Check(Comm_txBufferHead == Comm_txBufferTail, "TX ring drained");
+}
+
+
+/***************************************
+*        Tests
+****************************************/
+
+int main(void)
+{
+    /* Main loop and line keep up: nothing may be dropped */
+    Test_Run(16u, 8u, 4u, 16u, 0u, "rx 16, tx 8, fast line");
+    Test_Check(0u == testDropped, "no drops while the line keeps up");
+
+    /* Slow line: the RX ring overflows */
+    Test_Run(16u, 8u, 12u, 4u, 3u, "rx 16, tx 8, slow line");
+    Test_Check(0u != testDropped, "drops on a slow line");
+
+    /* Ring sizes that wrap at different points */
+    Test_Run(7u, 13u, 8u, 8u, 3u, "rx 7, tx 13");
+    Test_Run(64u, 64u, 40u, 40u, 3u, "rx 64, tx 64");
+    Test_Run(1u, 2u, 3u, 2u, 3u, "rx 1, tx 2");
+
+    printf("%s\n", (0u == testFailures) ? "all passed" : "FAILED");
+
+    return ((0u == testFailures) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+
+/* [] END OF FILE */
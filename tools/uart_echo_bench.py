@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Measure the UART echo throughput of SCB_UnconfiguredComm01 at every baud rate.
+
+The firmware echoes everything it receives in UART mode (UartEcho_Process()
+in uartecho.c with UART_BLOCK_ECHO, byte by byte otherwise). A break from
+the host makes it step to the next baud rate of uartBaudDivider[] in main.c.
+For each rate this script streams random data for a fixed time while reading
+the echo back, then reports:
+
+    sustained   echoed bytes per second, first byte sent to last byte echoed
+    line        bytes per second the line can carry (8N1, 10 bits per byte)
+    dropped     bytes sent but never echoed
+    order       whether the echo is the sent data minus the dropped bytes
+
+A rate at which the device falls behind shows up as dropped bytes: its RX
+software buffer overflows while the TX side is busy. Build once with
+UART_BLOCK_ECHO 0 and once with 1 to compare the two echo paths.
+
+    pip install pyserial
+    python3 uart_echo_bench.py --port /dev/ttyACM0 --seconds 5
+
+Start with the firmware freshly switched to UART mode, so that it runs at
+the first rate. The script steps through all rates and ends with one more
+break, which brings the firmware back to the first rate.
+"""
+
+import argparse
+import os
+import sys
+import threading
+import time
+
+try:
+    import serial
+except ImportError:
+    sys.exit("pyserial is required: pip install pyserial")
+
+# Keep in sync with uartBaudDivider[] in main.c
+BAUD_RATES = [115200, 230400, 460800, 921600, 57600]
+
+BREAK_S = 0.05
+SETTLE_S = 0.1
+IDLE_S = 0.5
+CHUNK = 256
+
+
+def step_rate(ser, baud):
+    """Send a break at the current rate and follow the firmware to baud."""
+    ser.send_break(BREAK_S)
+    time.sleep(SETTLE_S)
+    ser.baudrate = baud
+    time.sleep(SETTLE_S)
+    ser.reset_input_buffer()
+
+
+def sync(ser, tries=3):
+    """Check that the echo works at the current rate."""
+    for _ in range(tries):
+        token = os.urandom(16)
+        ser.reset_input_buffer()
+        ser.write(token)
+        got = b""
+        deadline = time.monotonic() + 1.0
+        while time.monotonic() < deadline and token not in got:
+            got += ser.read(64)
+        if token in got:
+            time.sleep(IDLE_S)
+            ser.reset_input_buffer()
+            return True
+    return False
+
+
+def is_subsequence(echo, sent):
+    """True if echo is sent with some bytes left out, order kept."""
+    pos = 0
+    for byte in echo:
+        pos = sent.find(bytes([byte]), pos)
+        if pos < 0:
+            return False
+        pos += 1
+    return True
+
+
+def measure(ser, seconds):
+    sent = bytearray()
+    echo = bytearray()
+    stamps = {}
+    done = threading.Event()
+
+    def reader():
+        while True:
+            data = ser.read(4096)
+            if data:
+                echo.extend(data)
+                stamps["last"] = time.monotonic()
+            elif done.is_set() and time.monotonic() - stamps.get("last", 0) > IDLE_S:
+                return
+
+    thread = threading.Thread(target=reader)
+    thread.start()
+
+    stamps["first"] = time.monotonic()
+    end = stamps["first"] + seconds
+    while time.monotonic() < end:
+        chunk = os.urandom(CHUNK)
+        ser.write(chunk)
+        sent.extend(chunk)
+    ser.flush()
+    done.set()
+    thread.join()
+
+    elapsed = stamps.get("last", stamps["first"]) - stamps["first"]
+    rate = len(echo) / elapsed if elapsed > 0 else 0.0
+    return len(sent), len(echo), rate, is_subsequence(bytes(echo), bytes(sent))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", required=True, help="serial port of the kit")
+    parser.add_argument("--seconds", type=float, default=5.0,
+                        help="streaming time per baud rate")
+    args = parser.parse_args()
+
+    ser = serial.Serial(args.port, BAUD_RATES[0], timeout=0.05)
+    print("   baud   line B/s  sustained B/s    %      sent   dropped  order")
+
+    for index, baud in enumerate(BAUD_RATES):
+        if index:
+            step_rate(ser, baud)
+        if not sync(ser):
+            print("%7d  no echo at this rate" % baud)
+            continue
+
+        count, echoed, rate, order = measure(ser, args.seconds)
+        line = baud / 10.0
+        print("%7d  %9.0f  %13.0f  %5.1f  %8d  %8d  %s" % (
+            baud, line, rate, 100.0 * rate / line, count, count - echoed,
+            "ok" if order else "BAD"))
+
+    # Back to the first rate
+    step_rate(ser, BAUD_RATES[0])
+    ser.close()
+
+
+if __name__ == "__main__":
+    main()